@@ -15,17 +15,38 @@
 
 #pragma once
 
+#include <complex>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <Eigen/Core>
 
 #include "FFT.hpp"
+#include "FrameRegistry.hpp"
 
 namespace jsa::cicuetea {
 
+class ThreadPool;
+
+/**
+ * @brief How NsgfCqtSparse rounds each band's support up to its FFT length.
+ */
+enum class SpanPolicy {
+    PowerOfTwo, ///< Next power of two (the default).
+    MixedRadix  ///< Smallest even 2^a·3^b·5^c length (nextSmooth()), the same in every build.
+};
+
 /**
- * @class NsgfCqtCommon
+ * @brief Units of BasicNsgfCqtSparse::forwardMagnitude().
+ */
+enum class MagnitudeScale {
+    Linear,  ///< |Xcq|.
+    Decibels ///< 20·log10(|Xcq|), floored at -200 dB.
+};
+
+/**
+ * @class BasicNsgfCqtCommon
  * @brief Base class for Non-Stationary Gabor Filterbank Constant-Q Transform (NSGF-CQT) operations.
  * 
  * This class provides common functionality and data members for NSGF-CQT operations, 
@@ -38,10 +59,23 @@ namespace jsa::cicuetea {
  * sample rate before the real one is known; since the whole design depends
  * on the sample rate, the correct response to a new rate is constructing a
  * new object.
+ *
+ * The scalar type T (float or double) sets the precision of the processing
+ * path: signals, coefficients, atoms and FFT plans. The frame itself is
+ * designed in double and rounded to T once, so the design parameters, the
+ * axes and the diagonalization d stay double for either instantiation.
  */
-class NsgfCqtCommon
+template <typename T>
+class BasicNsgfCqtCommon
 {
   public:
+    using Scalar        = T;                                                     ///< Real sample type.
+    using Complex       = std::complex<T>;                                       ///< Complex sample type.
+    using RealArray     = Eigen::Array<T, Eigen::Dynamic, 1>;                    ///< Real signal.
+    using ComplexArray  = Eigen::Array<Complex, Eigen::Dynamic, 1>;              ///< Complex spectrum or band.
+    using RealMatrix    = Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>;       ///< Real frame matrix.
+    using ComplexMatrix = Eigen::Array<Complex, Eigen::Dynamic, Eigen::Dynamic>; ///< Dense coefficients.
+
     /**
      * @struct BandInfo
      * @brief Holds information about the number of bands in the filterbank.
@@ -53,7 +87,7 @@ class NsgfCqtCommon
     };
 
     /**
-     * @brief Constructor for NsgfCqtCommon.
+     * @brief Constructor for BasicNsgfCqtCommon.
      *
      * @param sampleRate Sampling rate of the signal (Hz).
      * @param numSamples Number of samples in a block.
@@ -62,8 +96,8 @@ class NsgfCqtCommon
      * @param maxFrequency Maximum frequency of the filterbank (Hz).
      * @param refFrequency Reference frequency for the filterbank (Hz).
      */
-    NsgfCqtCommon(double sampleRate, Eigen::Index numSamples, double fraction,
-                  double minFrequency, double maxFrequency, double refFrequency);
+    BasicNsgfCqtCommon(double sampleRate, Eigen::Index numSamples, double fraction,
+                       double minFrequency, double maxFrequency, double refFrequency);
 
     /**
      * @brief True when the object is usable: the configuration passed
@@ -87,7 +121,8 @@ class NsgfCqtCommon
     /**
      * @brief Condition number of the painless frame operator, max(d)/min(d)
      * up to Nyquist. Advisory: reconstruction error amplifies by roughly
-     * cond·ε, so values ≲ 1e6 keep double-precision round trips near 1e-10.
+     * cond·ε, so values ≲ 1e6 keep double-precision round trips near 1e-10
+     * (and float round trips near 1e-7 at the conditions the tests use).
      * Returns +inf when the object is invalid.
      */
     double getFrameConditionNumber() const;
@@ -105,7 +140,10 @@ class NsgfCqtCommon
     Eigen::Index          getNumBands() const { return nBands; }
     const Eigen::ArrayXd& getFrequencyAxis() const { return fax; }
     const Eigen::ArrayXd& getBandAxis() const { return bax; }
-    const Eigen::ArrayXd& getDiagonalization() const { return d; }
+    const Eigen::ArrayXd& getDiagonalization() const; ///< Empty when invalid.
+
+    /// The parameters this object was constructed with, as a frame-cache key.
+    FrameKey getFrameKey() const { return {fs, nSamps, frac, fMin, fMax, fRef}; }
 
   protected:
     /**
@@ -145,8 +183,10 @@ class NsgfCqtCommon
      * number by 1/dHealthTol. Called by the derived constructors once d is
      * available; every "Q too high for this block" failure mode lands here,
      * whatever combination of parameters caused it.
+     *
+     * @param dd Frame-operator diagonal to check (nFreqs entries).
      */
-    bool checkFrameHealth() const;
+    bool checkFrameHealth(const Eigen::ArrayXd& dd) const;
 
     /// Relative floor for the frame-operator diagonal: bounds the frame
     /// condition number by 1e6, keeping double-precision round trips ~1e-10.
@@ -181,23 +221,61 @@ class NsgfCqtCommon
     const Eigen::Index nFreqs;   ///< Number of frequencies.
     Eigen::ArrayXd     bax;      ///< Band axis.
     Eigen::ArrayXd     fax;      ///< Frequency axis.
-    Eigen::ArrayXd     d;        ///< Diagonalization array.
-    Eigen::ArrayXcd    Xdft;     ///< DFT of the signal.
-    DFT                dft;      ///< Discrete Fourier Transform object.
+    std::shared_ptr<const Eigen::ArrayXd> d; ///< Diagonalization array; points into the shared frame.
+    ComplexMatrix      XdftMulti; ///< DFTs of all channels (multi-channel overloads).
 };
 
 /**
- * @class NsgfCqtDense
+ * @class BasicNsgfCqtDense
  * @brief Dense implementation of the NSGF-CQT.
  * 
  * This class provides methods for forward and inverse NSGF-CQT transformations
  * using a dense representation of the filterbank.
  */
-class NsgfCqtDense : public NsgfCqtCommon
+template <typename T>
+class BasicNsgfCqtDense : public BasicNsgfCqtCommon<T>
 {
+    using Base = BasicNsgfCqtCommon<T>;
+
   public:
+    using typename Base::ComplexArray;
+    using typename Base::ComplexMatrix;
+    using typename Base::RealArray;
+    using typename Base::RealMatrix;
+
+    using MultiCoefs = std::vector<ComplexMatrix>; ///< One coefficient matrix per channel.
+
+    /**
+     * @struct SharedFrame
+     * @brief Immutable design data of a configuration, shared by every
+     * instance constructed with the same FrameKey (see Registry).
+     */
+    struct SharedFrame {
+        Eigen::ArrayXd d;          ///< Frame-operator diagonal.
+        bool           ok = false; ///< Passed the measured health checks.
+        RealMatrix     g;          ///< Frame matrix.
+        RealMatrix     gDual;      ///< Dual frame matrix.
+    };
+
+    using Registry = FrameRegistry<SharedFrame>; ///< Process-wide cache of dense frames.
+
     /**
-     * @brief Constructor for NsgfCqtDense.
+     * @struct Workspace
+     * @brief The mutable scratch of one transform call: everything forward()
+     * and inverse() write besides their outputs.
+     *
+     * An object owns one for its non-const overloads; makeWorkspace() hands
+     * out more for the const overloads, so several threads can run one
+     * object (one frame) concurrently, each on its own Workspace.
+     */
+    struct Workspace {
+        ComplexArray  Xdft; ///< DFT of the signal.
+        ComplexMatrix Xmat; ///< Per-band spectra.
+        BasicDFT<T>   dft;  ///< Full-length DFT (its plan carries backend scratch too).
+    };
+
+    /**
+     * @brief Constructor for BasicNsgfCqtDense.
      * 
      * @param sampleRate Sampling rate of the signal (Hz).
      * @param numSamples Number of samples in the signal.
@@ -206,8 +284,8 @@ class NsgfCqtDense : public NsgfCqtCommon
      * @param maxFrequency Maximum frequency of the filterbank (Hz).
      * @param refFrequency Reference frequency for the filterbank (Hz).
      */
-    NsgfCqtDense(double sampleRate, Eigen::Index numSamples, double fraction,
-                 double minFrequency, double maxFrequency, double refFrequency);
+    BasicNsgfCqtDense(double sampleRate, Eigen::Index numSamples, double fraction,
+                      double minFrequency, double maxFrequency, double refFrequency);
 
     /**
      * @brief Performs the forward NSGF-CQT transformation.
@@ -215,7 +293,7 @@ class NsgfCqtDense : public NsgfCqtCommon
      * @param x Input signal.
      * @param Xcq Output constant-Q transform coefficients.
      */
-    void forward(const Eigen::ArrayXd& x, Eigen::ArrayXXcd& Xcq);
+    void forward(const RealArray& x, ComplexMatrix& Xcq);
 
     /**
      * @brief Performs the inverse NSGF-CQT transformation.
@@ -223,28 +301,162 @@ class NsgfCqtDense : public NsgfCqtCommon
      * @param Xcq Input constant-Q transform coefficients.
      * @param x Output reconstructed signal.
      */
-    void inverse(const Eigen::ArrayXXcd& Xcq, Eigen::ArrayXd& x);
+    void inverse(const ComplexMatrix& Xcq, RealArray& x);
+
+    /**
+     * @brief Scratch for the const forward()/inverse() overloads.
+     *
+     * Allocates and plans a full-length DFT: not real-time safe. Safe to
+     * call from any thread.
+     */
+    Workspace makeWorkspace() const;
+
+    /**
+     * @brief forward() on caller-owned scratch; touches nothing in this
+     * object, so concurrent calls with distinct workspaces are safe.
+     *
+     * @param x Input signal.
+     * @param Xcq Output constant-Q transform coefficients.
+     * @param ws Scratch from makeWorkspace() of an object with this configuration.
+     */
+    void forward(const RealArray& x, ComplexMatrix& Xcq, Workspace& ws) const;
+
+    /**
+     * @brief inverse() on caller-owned scratch (see the const forward()).
+     *
+     * @param Xcq Input constant-Q transform coefficients.
+     * @param x Output reconstructed signal.
+     * @param ws Scratch from makeWorkspace() of an object with this configuration.
+     */
+    void inverse(const ComplexMatrix& Xcq, RealArray& x, Workspace& ws) const;
+
+    /**
+     * @brief Energy of each band's coefficients, without computing them.
+     *
+     * By Parseval, the energy of band k's coefficients is the energy of its
+     * atom times the signal spectrum, so one real DFT and a weighted sum
+     * per band give what summing |Xcq[k]|² after forward() would, up to
+     * rounding, with no per-band inverse DFT. Runs on the object's own
+     * scratch (see forwardStart()).
+     *
+     * @param x Input signal.
+     * @param e Output energies, one per band.
+     */
+    void bandEnergies(const RealArray& x, RealArray& e);
+
+    /// bandEnergies() on caller-owned scratch (see the const forward()).
+    void bandEnergies(const RealArray& x, RealArray& e, Workspace& ws) const;
+
+    /**
+     * @brief forward() in stages, so that one transform can be spread over
+     * several calls: forwardStart() then forwardBand() for every band (in
+     * any order) writes what forward() does. Runs on the object's own
+     * scratch, which the stages hand to each other, so no other transform
+     * of this object may run in between.
+     *
+     * @param x Input signal.
+     */
+    void forwardStart(const RealArray& x);
+
+    /**
+     * @brief One band of a staged forward (see forwardStart()): column k of Xcq.
+     */
+    void forwardBand(Eigen::Index k, ComplexMatrix& Xcq);
+
+    /**
+     * @brief inverse() in stages: inverseBand() for every band, then
+     * inverseFinish(). Same scratch rules as forwardStart().
+     */
+    void inverseBand(Eigen::Index k, const ComplexMatrix& Xcq);
+
+    /**
+     * @brief Staged inverse stage of a band whose coefficients are all zero:
+     * takes its place in the sum without its FFT.
+     */
+    void inverseSkipBand(Eigen::Index k);
+
+    /**
+     * @brief Last stage of a staged inverse: sums the bands and writes x.
+     */
+    void inverseFinish(RealArray& x);
+
+    /**
+     * @brief Sizes the multi-channel scratch and plans the batched FFTs for
+     * nChannels (allocates on change only), so that the first multi-channel
+     * call is real-time safe too. Does nothing on an invalid transform.
+     */
+    void reserveChannels(Eigen::Index nChannels);
+
+    /**
+     * @brief Forward transform of several channels sharing this frame.
+     *
+     * Bands are the outer loop: each atom is read once and applied to every
+     * channel, and the band's IDFTs for all channels go to the backend as
+     * one matrix call. Scratch is sized by the first call with a new channel
+     * count (unless reserveChannels() did it), so that call is not
+     * real-time safe; later calls are.
+     *
+     * @param x Input signals, samples × channels.
+     * @param Xcq Output coefficients, one nSamps × nBands matrix per channel.
+     */
+    void forward(const RealMatrix& x, MultiCoefs& Xcq);
+
+    /**
+     * @brief Inverse transform of several channels sharing this frame.
+     *
+     * @param Xcq Input coefficients, one nSamps × nBands matrix per channel.
+     * @param x Output signals, samples × channels.
+     */
+    void inverse(const MultiCoefs& Xcq, RealMatrix& x);
 
     // Accessor methods for frame and dual frame.
-    const Eigen::ArrayXXd& getFrame() const { return g; }
-    const Eigen::ArrayXXd& getDualFrame() const { return gDual; }
+    const RealMatrix& getFrame() const { return frame->g; }
+    const RealMatrix& getDualFrame() const { return frame->gDual; }
+
+    /// The shared frame (an empty one when the configuration is invalid).
+    const std::shared_ptr<const SharedFrame>& getSharedFrame() const { return frame; }
 
   private:
-    Eigen::ArrayXXd  g;     ///< Frame matrix.
-    Eigen::ArrayXXd  gDual; ///< Dual frame matrix.
-    Eigen::ArrayXXcd Xmat;  ///< Matrix of transform coefficients.
+    using Base::bax;
+    using Base::d;
+    using Base::fax;
+    using Base::frac;
+    using Base::frameOk;
+    using Base::minAtomSupport;
+    using Base::nBands;
+    using Base::nFreqs;
+    using Base::nSamps;
+    using Base::th;
+    using Base::valid;
+    using Base::XdftMulti;
+
+    /// Designs the frame for this configuration (called on a registry miss).
+    std::shared_ptr<SharedFrame> buildFrame() const;
+
+    std::shared_ptr<const SharedFrame> frame;      ///< Shared immutable frame.
+    Workspace                          work;       ///< Scratch of the non-const overloads.
+    ComplexMatrix                      XbandMulti; ///< One band of every channel (multi-channel overloads).
+    ComplexArray                       Xstage;     ///< One band's spectrum (staged overloads).
 };
 
 /**
- * @class NsgfCqtSparse
+ * @class BasicNsgfCqtSparse
  * @brief Sparse implementation of the NSGF-CQT.
  * 
  * This class provides methods for forward and inverse NSGF-CQT transformations
  * using a sparse representation of the filterbank.
  */
-class NsgfCqtSparse : public NsgfCqtCommon
+template <typename T>
+class BasicNsgfCqtSparse : public BasicNsgfCqtCommon<T>
 {
+    using Base = BasicNsgfCqtCommon<T>;
+
   public:
+    using typename Base::ComplexArray;
+    using typename Base::ComplexMatrix;
+    using typename Base::RealArray;
+    using typename Base::RealMatrix;
+
     /**
      * @struct Span
      * @brief Represents a span of indices for a band.
@@ -254,12 +466,46 @@ class NsgfCqtSparse : public NsgfCqtCommon
         Eigen::Index len = 0; ///< Length of the span.
     };
 
-    using Coefs    = std::vector<Eigen::ArrayXcd>; ///< Type alias for coefficients.
-    using Frame    = std::vector<Eigen::ArrayXd>;  ///< Type alias for frame.
-    using SpanList = std::vector<Span>;            ///< Type alias for span list.
+    using Coefs      = std::vector<ComplexArray>; ///< Type alias for coefficients.
+    using Frame      = std::vector<RealArray>;    ///< Type alias for frame.
+    using SpanList   = std::vector<Span>;         ///< Type alias for span list.
+    using MultiCoefs = std::vector<Coefs>;        ///< One set of coefficients per channel.
+
+    /**
+     * @struct SharedFrame
+     * @brief Immutable design data of a configuration, shared by every
+     * instance constructed with the same FrameKey (see Registry).
+     */
+    struct SharedFrame {
+        Eigen::ArrayXd d;          ///< Frame-operator diagonal.
+        bool           ok = false; ///< Passed the measured health checks.
+        SpanList       idx;        ///< Span of each band.
+        Frame          g;          ///< Atoms on their spans.
+        Frame          gDual;      ///< Dual atoms on their spans.
+        Coefs          phase;      ///< Per-band phase correction.
+        RealArray      scale;      ///< Per-band scale (= span length), stored as T.
+    };
+
+    using Registry = FrameRegistry<SharedFrame>; ///< Process-wide cache of sparse frames.
 
     /**
-     * @brief Constructor for NsgfCqtSparse.
+     * @struct Workspace
+     * @brief The mutable scratch of one transform call: everything forward()
+     * and inverse() write besides their outputs.
+     *
+     * An object owns one for its non-const overloads; makeWorkspace() hands
+     * out more for the const overloads, so several threads can run one
+     * object (one frame) concurrently, each on its own Workspace.
+     */
+    struct Workspace {
+        ComplexArray                              Xdft;   ///< DFT of the signal.
+        Coefs                                     Xcoefs; ///< Per-band spectra, one per span.
+        BasicDFT<T>                               dft;    ///< Full-length DFT.
+        std::vector<std::unique_ptr<BasicDFT<T>>> dfts;   ///< Per-band DFTs (plans carry backend scratch too).
+    };
+
+    /**
+     * @brief Constructor for BasicNsgfCqtSparse.
      * 
      * @param sampleRate Sampling rate of the signal (Hz).
      * @param nSamps Number of samples in the signal.
@@ -267,9 +513,38 @@ class NsgfCqtSparse : public NsgfCqtCommon
      * @param minFrequency Minimum frequency of the filterbank (Hz).
      * @param maxFrequency Maximum frequency of the filterbank (Hz).
      * @param refFrequency Reference frequency for the filterbank (Hz).
+     * @param spanPolicy How band spans are rounded up to FFT lengths.
+     * MixedRadix keeps spans (coefficient counts and band FFTs) close to
+     * the atoms' support instead of up to twice as long. Its lengths do not
+     * depend on the backends, so frames stay shareable and cacheable; when
+     * no compiled-in backend plans one of them (a build with only
+     * power-of-two backends) the transform is inert.
      */
-    NsgfCqtSparse(double sampleRate, Eigen::Index nSamps, double fraction,
-                  double minFrequency, double maxFrequency, double refFrequency);
+    BasicNsgfCqtSparse(double sampleRate, Eigen::Index nSamps, double fraction,
+                       double minFrequency, double maxFrequency, double refFrequency,
+                       SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo);
+
+    ~BasicNsgfCqtSparse();
+
+    /**
+     * @brief Opt-in parallel band loops for offline analysis.
+     *
+     * With numThreads > 1, forward() and inverse() spread the per-band work
+     * (atom multiply, band FFT, phase) over a pool of numThreads threads, the
+     * caller included; 1 (the default) keeps the serial loop and no threads
+     * exist. Each band writes only its own scratch, and the overlapping
+     * accumulation into the full-length spectrum is split by frequency
+     * tiles, each summing bands in ascending order — so results are
+     * bit-identical to the serial path for any thread count.
+     *
+     * Starts or stops threads: not real-time safe, call outside processing.
+     *
+     * @param numThreads Threads to use; 0 picks std::thread::hardware_concurrency().
+     */
+    void setNumThreads(unsigned numThreads);
+
+    /// Threads used by forward()/inverse() (1 = serial).
+    unsigned getNumThreads() const;
 
     /**
      * @brief Performs the forward NSGF-CQT transformation.
@@ -277,7 +552,7 @@ class NsgfCqtSparse : public NsgfCqtCommon
      * @param x Input signal.
      * @param Xcq Output constant-Q transform coefficients.
      */
-    void forward(const Eigen::ArrayXd& x, Coefs& Xcq);
+    void forward(const RealArray& x, Coefs& Xcq);
 
     /**
      * @brief Performs the inverse NSGF-CQT transformation.
@@ -285,22 +560,181 @@ class NsgfCqtSparse : public NsgfCqtCommon
      * @param Xcq Input constant-Q transform coefficients.
      * @param x Output reconstructed signal.
      */
-    void inverse(const Coefs& Xcq, Eigen::ArrayXd& x);
+    void inverse(const Coefs& Xcq, RealArray& x);
+
+    /**
+     * @brief Scratch for the const forward()/inverse() overloads.
+     *
+     * Allocates and plans the full-length and per-band DFTs: not real-time
+     * safe. Safe to call from any thread.
+     */
+    Workspace makeWorkspace() const;
+
+    /**
+     * @brief forward() on caller-owned scratch; touches nothing in this
+     * object, so concurrent calls with distinct workspaces are safe. Always
+     * serial (setNumThreads() applies to the non-const overloads only).
+     *
+     * @param x Input signal.
+     * @param Xcq Output constant-Q transform coefficients.
+     * @param ws Scratch from makeWorkspace() of an object with this configuration.
+     */
+    void forward(const RealArray& x, Coefs& Xcq, Workspace& ws) const;
+
+    /**
+     * @brief inverse() on caller-owned scratch (see the const forward()).
+     *
+     * @param Xcq Input constant-Q transform coefficients.
+     * @param x Output reconstructed signal.
+     * @param ws Scratch from makeWorkspace() of an object with this configuration.
+     */
+    void inverse(const Coefs& Xcq, RealArray& x, Workspace& ws) const;
+
+    /**
+     * @brief Energy of each band's coefficients, without computing them.
+     *
+     * By Parseval, the energy of band k's coefficients is the energy of its
+     * atom times the signal spectrum, so one real DFT and a weighted sum
+     * per band give what summing |Xcq[k]|² after forward() would, up to
+     * rounding, with no per-band inverse DFT. Runs on the object's own
+     * scratch (see forwardStart()).
+     *
+     * @param x Input signal.
+     * @param e Output energies, one per band.
+     */
+    void bandEnergies(const RealArray& x, RealArray& e);
+
+    /// bandEnergies() on caller-owned scratch (see the const forward()).
+    void bandEnergies(const RealArray& x, RealArray& e, Workspace& ws) const;
+
+    /**
+     * @brief forward() reduced to the magnitudes, for spectrograms.
+     *
+     * |Xcq[k]| does not depend on the phase correction, and the scales and
+     * the 1/N of the signal's DFT fold into one real factor per band, so
+     * each band costs its atom multiply, its IDFT and one pass that takes
+     * the magnitude (plus one for the logarithm, at the output precision,
+     * in decibels). Every band goes into
+     * one contiguous array: band k at getCoefOffset(k), getLength(k) values.
+     * Honors setNumThreads() like forward().
+     *
+     * @param x Input signal.
+     * @param mag Output magnitudes, getNumCoefs() values.
+     * @param scale Linear magnitudes or decibels.
+     */
+    void forwardMagnitude(const RealArray& x, Eigen::ArrayXf& mag, MagnitudeScale scale = MagnitudeScale::Linear);
+
+    /// forwardMagnitude() into double-precision magnitudes.
+    void forwardMagnitude(const RealArray& x, Eigen::ArrayXd& mag, MagnitudeScale scale = MagnitudeScale::Linear);
+
+    /// forwardMagnitude() on caller-owned scratch (see the const forward()).
+    void forwardMagnitude(const RealArray& x, Eigen::ArrayXf& mag, MagnitudeScale scale, Workspace& ws) const;
+
+    /// forwardMagnitude() on caller-owned scratch, into double precision.
+    void forwardMagnitude(const RealArray& x, Eigen::ArrayXd& mag, MagnitudeScale scale, Workspace& ws) const;
+
+    /// Offset of band k in forwardMagnitude()'s output.
+    Eigen::Index getCoefOffset(Eigen::Index k) const { return offsets[size_t(k)]; }
+
+    /// Total number of coefficients of all bands.
+    Eigen::Index getNumCoefs() const { return offsets.empty() ? 0 : offsets.back(); }
+
+    /**
+     * @brief forward() in stages, so that one transform can be spread over
+     * several calls: forwardStart() (the full-length FFT) then forwardBand()
+     * for every band (in any order) writes what forward() does. Runs
+     * serially on the object's own scratch, which the stages hand to each
+     * other, so no other transform of this object may run in between.
+     *
+     * @param x Input signal.
+     */
+    void forwardStart(const RealArray& x);
+
+    /**
+     * @brief One band of a staged forward (see forwardStart()): Xcq[k].
+     */
+    void forwardBand(Eigen::Index k, Coefs& Xcq);
+
+    /**
+     * @brief inverse() in stages: inverseBand() for every band, then
+     * inverseFinish(). Same scratch rules as forwardStart().
+     */
+    void inverseBand(Eigen::Index k, const Coefs& Xcq);
+
+    /**
+     * @brief Staged inverse stage of a band whose coefficients are all zero:
+     * takes its place in the sum without its FFT.
+     */
+    void inverseSkipBand(Eigen::Index k);
+
+    /**
+     * @brief Last stage of a staged inverse: sums the bands and runs the
+     * full-length FFT into x.
+     */
+    void inverseFinish(RealArray& x);
+
+    /**
+     * @brief Sizes the multi-channel scratch and plans the batched FFTs for
+     * nChannels (allocates on change only), so that the first multi-channel
+     * call is real-time safe too. Does nothing on an invalid transform.
+     */
+    void reserveChannels(Eigen::Index nChannels);
+
+    /**
+     * @brief Forward transform of several channels sharing this frame.
+     *
+     * Bands are the outer loop: each atom, phase and span is read once and
+     * applied to every channel, and the band's IDFTs for all channels go to
+     * the backend as one matrix call. Scratch is sized by the first call
+     * with a new channel count (unless reserveChannels() did it), so that
+     * call is not real-time safe; later calls are. Honors setNumThreads()
+     * like the single-channel overload.
+     *
+     * @param x Input signals, samples × channels.
+     * @param Xcq Output coefficients, one Coefs per channel (see getCoefs(Eigen::Index)).
+     */
+    void forward(const RealMatrix& x, MultiCoefs& Xcq);
+
+    /**
+     * @brief Inverse transform of several channels sharing this frame.
+     *
+     * @param Xcq Input coefficients, one Coefs per channel.
+     * @param x Output signals, samples × channels.
+     */
+    void inverse(const MultiCoefs& Xcq, RealMatrix& x);
 
     // Accessor methods for frame, dual frame, and band spans.
-    const Frame&          getFrame() const { return g; }
-    const Eigen::ArrayXd& getAtom(Eigen::Index k) const { return g[k]; }
-    const Frame&          getDualFrame() const { return gDual; }
-    const Eigen::ArrayXd& getDualAtom(Eigen::Index k) const { return gDual[k]; }
-    const Coefs&          getPhaseCoefs() const { return phase; }
-    Span                  getBandSpan(Eigen::Index k) const { return idx[k]; }
-    Eigen::ArrayXd        getFrequencyAxis(Eigen::Index k) const { return fax.segment(idx[k].i0, idx[k].len); }
-    Eigen::Index          getLength(Eigen::Index k) const { return idx[k].len; };
-    double                getCoeffRate(Eigen::Index k) const { return getSampleRate() * double(getLength(k)) / double(getBlockSize()); }
+    const Frame&     getFrame() const { return frame->g; }
+    const RealArray& getAtom(Eigen::Index k) const { return frame->g[k]; }
+    const Frame&     getDualFrame() const { return frame->gDual; }
+    const RealArray& getDualAtom(Eigen::Index k) const { return frame->gDual[k]; }
+    const Coefs&     getPhaseCoefs() const { return frame->phase; }
+    Span             getBandSpan(Eigen::Index k) const { return frame->idx[k]; }
+    Eigen::ArrayXd   getFrequencyAxis(Eigen::Index k) const { return fax.segment(getBandSpan(k).i0, getLength(k)); }
+    Eigen::Index     getLength(Eigen::Index k) const { return frame->idx[k].len; };
+    double           getCoeffRate(Eigen::Index k) const { return this->getSampleRate() * double(getLength(k)) / double(this->getBlockSize()); }
+    SpanPolicy       getSpanPolicy() const { return spans; }
+
+    /// The frame's key: the common parameters plus the span policy.
+    FrameKey getFrameKey() const;
+
+    /// The shared frame (an empty one when the configuration is invalid).
+    const std::shared_ptr<const SharedFrame>& getSharedFrame() const { return frame; }
+
+    /**
+     * @brief Writes this frame to path in the FrameCache file format, e.g.
+     * to ship precomputed frames with an application.
+     * @return False when the object is not valid or the write failed.
+     */
+    bool saveFrame(const std::string& path) const;
 
     // Methods for retrieving coefficients.
     Frame getRealCoefs() const;
-    Coefs getCoefs() const;
+    Coefs      getCoefs() const;
+    MultiCoefs getCoefs(Eigen::Index nChannels) const; ///< getCoefs() for each of nChannels.
+
+    /// Half of each band's coefficients (the sliding processors' overlap);
+    /// spans are even under either SpanPolicy.
     Coefs getValidCoefs() const;
 
   private:
@@ -309,20 +743,96 @@ class NsgfCqtSparse : public NsgfCqtCommon
      *
      * Scans for the first and last indices whose value exceeds the sparsity
      * threshold, then enforces a "correct" span: at least 4 bins long and
-     * rounded up to a power of two, so each band gets an efficient FFT size.
+     * rounded up per the SpanPolicy (see roundSpan()), so each band gets an
+     * efficient FFT size.
      *
-     * @param ii The band's profile over frequency-grid indices.
-     * @return Span Power-of-two-length index span covering the band's support.
+     * @param ii The band's profile over a range of frequency-grid indices.
+     * @param offset Grid index of ii(0).
+     * @return Span Even, FFT-friendly index span covering the band's support.
      */
-    Span getIdx(const Eigen::ArrayXd& ii);
-
-    SpanList                          idx;       ///< List of spans for each band.
-    Frame                             g;         ///< Frame representation.
-    Frame                             gDual;     ///< Dual frame representation.
-    Coefs                             phase;     ///< Phase coefficients.
-    Eigen::ArrayXd                    scale;     ///< Per-band scale (= span length). Stored as double
-    Coefs                             Xcoefs;    ///< Sparse coefficients.
-    std::vector<std::unique_ptr<DFT>> dfts;      ///< DFT objects for each band.
+    Span getIdx(const Eigen::ArrayXd& ii, Eigen::Index offset) const;
+
+    /// Rounds a span length up per the SpanPolicy: the next power of two,
+    /// or the next even 5-smooth length. Backend-independent, since the
+    /// result is part of the shared (and cached) frame.
+    Eigen::Index roundSpan(Eigen::Index len) const;
+
+    /// Designs the frame for this configuration.
+    std::shared_ptr<SharedFrame> buildFrame() const;
+
+    /// Registry builder: loads the FrameCache file when one matches, else
+    /// designs the frame and writes the file (when the cache is enabled).
+    std::shared_ptr<const SharedFrame> loadOrBuildFrame() const;
+
+    /// Parses a frame file; null unless it matches this configuration exactly.
+    std::shared_ptr<SharedFrame> loadFrame(const std::string& path) const;
+
+    /// Serializes a frame in the FrameCache file format.
+    std::vector<unsigned char> serializeFrame(const SharedFrame& f) const;
+
+    /// FrameCache kind tag: frame type and precision.
+    static std::string cacheKind() { return "sparse" + std::to_string(8 * sizeof(T)); }
+
+    /// Shared body of the forward() overloads; workers is null for serial.
+    void forwardWith(const RealArray& x, Coefs& Xcq, Workspace& ws, ThreadPool* workers) const;
+
+    /// Shared body of the inverse() overloads; workers is null for serial.
+    void inverseWith(const Coefs& Xcq, RealArray& x, Workspace& ws, ThreadPool* workers) const;
+
+    /// Forward work of band k: atom, band IDFT, phase/scale into Xcq[k].
+    void forwardBand(Eigen::Index k, Coefs& Xcq, Workspace& ws) const;
+
+    /// Shared body of the forwardMagnitude() overloads; workers is null for serial.
+    template <typename S>
+    void forwardMagnitudeWith(const RealArray& x, Eigen::Array<S, Eigen::Dynamic, 1>& mag, MagnitudeScale scale,
+                              Workspace& ws, ThreadPool* workers) const;
+
+    /// Inverse work of band k: leaves gDual[k]·DFT(band) in ws.Xcoefs[k],
+    /// ready for accumulate().
+    void inverseBand(Eigen::Index k, const Coefs& Xcq, Workspace& ws) const;
+
+    /// Adds every band's ws.Xcoefs into the bins [b0, b1) of ws.Xdft, in band order.
+    void accumulate(Eigen::Index b0, Eigen::Index b1, Workspace& ws) const;
+
+    /// Multi-channel counterparts of the three above, on XcoefsMulti/XdftMulti.
+    void forwardBandMulti(Eigen::Index k, MultiCoefs& Xcq);
+    void inverseBandMulti(Eigen::Index k, const MultiCoefs& Xcq);
+    void accumulateMulti(Eigen::Index b0, Eigen::Index b1);
+
+    using Base::bax;
+    using Base::d;
+    using Base::fax;
+    using Base::fs;
+    using Base::frac;
+    using Base::frameOk;
+    using Base::minAtomSupport;
+    using Base::nBands;
+    using Base::nFreqs;
+    using Base::nSamps;
+    using Base::th;
+    using Base::valid;
+    using Base::XdftMulti;
+
+    const SpanPolicy                   spans;       ///< Span rounding; part of the FrameKey.
+    std::shared_ptr<const SharedFrame> frame;       ///< Shared immutable frame.
+    Workspace                          work;        ///< Scratch of the non-const overloads.
+    std::vector<ComplexMatrix>         XcoefsMulti; ///< Per-band scratch, span × channels.
+    std::unique_ptr<ThreadPool>        pool;        ///< Band-loop workers; null when serial.
+    std::vector<Eigen::Index>          offsets;     ///< Start of each band in forwardMagnitude()'s output, then the total.
 };
 
+extern template class BasicNsgfCqtCommon<float>;
+extern template class BasicNsgfCqtCommon<double>;
+extern template class BasicNsgfCqtDense<float>;
+extern template class BasicNsgfCqtDense<double>;
+extern template class BasicNsgfCqtSparse<float>;
+extern template class BasicNsgfCqtSparse<double>;
+
+using NsgfCqtCommon  = BasicNsgfCqtCommon<double>; ///< Double-precision common base.
+using NsgfCqtDense   = BasicNsgfCqtDense<double>;  ///< Double-precision dense NSGF-CQT.
+using NsgfCqtSparse  = BasicNsgfCqtSparse<double>; ///< Double-precision sparse NSGF-CQT.
+using NsgfCqtCommonF = BasicNsgfCqtCommon<float>;  ///< Single-precision common base.
+using NsgfCqtDenseF  = BasicNsgfCqtDense<float>;   ///< Single-precision dense NSGF-CQT.
+using NsgfCqtSparseF = BasicNsgfCqtSparse<float>;  ///< Single-precision sparse NSGF-CQT.
+
 } // namespace jsa::cicuetea
@@ -11,120 +11,375 @@
  * @author Juan Sierra
  * @date 3/17/25
  * @copyright MIT License
+ *
+ * Every processor is templated on the sample type T (float or double). The
+ * double instantiations keep the historical names (CqtDenseProcessor, ...);
+ * the float ones carry an F suffix (CqtDenseProcessorF, ...).
  */
 
 #pragma once
 
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <Eigen/Core>
 
 #include "CQT.hpp"
-#include "DoubleBuffer.h"
+#include "HistoryBuffer.h"
 #include "Slicer.hpp"
+#include "SnapshotTap.h"
 #include "Splicer.hpp"
+#include "StageScheduler.h"
 
 namespace jsa::cicuetea {
 
+template <typename T>
+class AsyncWorker;
+
+template <typename P>
+class Async;
+
 /**
- * @class CqtDenseProcessor
- * @brief Processes audio samples using a dense non-stationary Gabor transform-based CQT.
- * 
- * This class provides methods to process individual samples and blocks of data
- * using a dense CQT (Constant-Q Transform) implementation.
+ * @brief Options of a processor's worker-thread mode (see Async::setAsync()).
+ */
+struct AsyncOptions {
+    Eigen::Index extraLatency = 0;     ///< Time the worker has per hop, in samples; 0 = one hop.
+    int          cpu          = -1;    ///< CPU to pin the worker to, or -1 for any (Linux only).
+    bool         realtime     = false; ///< Request SCHED_FIFO for the worker (POSIX only).
+};
+
+/**
+ * @class BasicHopDriver
+ * @brief The hop loop shared by the single-channel processors.
+ *
+ * Slices the input into overlapping blocks, runs each one through the
+ * processor's transform stages and processBlock(), and splices the results
+ * back at a fixed latency. The processor supplies the stages (the forward
+ * transform of the windowed block into the hop's coefficients and the
+ * inverse back, each whole or one band at a time); the driver owns what
+ * surrounds them: the slicer and splicer, the amortized job, the worker
+ * thread (started through Async) and the snapshot tap.
+ *
+ * @tparam T Sample type.
+ * @tparam Cqt Transform type.
+ * @tparam Block Coefficients processBlock() receives.
  */
-class CqtDenseProcessor
+template <typename T, typename Cqt, typename Block>
+class BasicHopDriver
 {
   public:
-    /**
-     * @brief Constructs a CqtDenseProcessor object.
-     * 
-     * @param sampleRate The sampling rate of the audio signal.
-     * @param numSamples The number of samples to process.
-     * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
-     * @param minFrequency The minimum frequency of the CQT.
-     * @param maxFrequency The maximum frequency of the CQT.
-     * @param refFrequency The reference frequency for the CQT.
-     */
-    CqtDenseProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
-                      double minFrequency, double maxFrequency, double refFrequency);
+    using RealArray = typename Cqt::RealArray; ///< Sample block type.
 
     /**
      * @brief Virtual destructor for safe polymorphic use.
      *
      * Declared virtual to ensure that derived classes can be safely deleted
-     * through a base class pointer. This destructor is defaulted as the base class
-     * does not require custom cleanup.
+     * through a base class pointer.
      */
-    virtual ~CqtDenseProcessor() = default;
+    virtual ~BasicHopDriver();
+
+    BasicHopDriver(const BasicHopDriver&)            = delete;
+    BasicHopDriver& operator=(const BasicHopDriver&) = delete;
 
     /**
      * @brief Processes a single audio sample.
-     * 
+     *
      * @param sample The audio sample to process.
      * @return The processed sample.
      */
-    double processSample(double sample);
+    T processSample(T sample);
+
+    /**
+     * @brief Processes a buffer of samples; equivalent to calling
+     * processSample() on each of them.
+     *
+     * Samples move between the buffers and the slicer/splicer as block
+     * copies, in runs that end at hop boundaries, so per-sample overhead is
+     * gone whatever the host buffer size.
+     *
+     * @param input The n input samples.
+     * @param output Receives the n processed samples (may alias input).
+     * @param n Number of samples.
+     */
+    void process(const T* input, T* output, Eigen::Index n);
 
     /**
      * @brief Processes a block of data.
-     * 
-     * @param block The block of data to process.
+     *
+     * @param block The coefficients of one hop (for the sliding processors,
+     * the hop's overlap-added coefficients).
      */
-    virtual void processBlock(Eigen::ArrayXXcd& block) = 0;
+    virtual void processBlock(Block& block) = 0;
 
     /**
      * @brief Gets the windowing function.
      *
      * @return A constant reference to the windowing function.
      */
-    const Eigen::ArrayXd& getWindow() const { return win; }
+    const RealArray& getWindow() const { return win; }
 
     /**
      * @brief Gets the CQT object.
-     * 
+     *
      * @return A constant reference to the CQT object.
      */
-    const NsgfCqtDense& getCqt() const { return cqt; }
+    const Cqt& getCqt() const { return cqt; }
 
     /**
      * @brief Gets the latency produced by the processor.
      *
      * @return Integer number of samples of delay between input and output.
      */
-    Eigen::Index getLatency() const { return slicer.getBlockSize(); }
+    Eigen::Index getLatency() const
+    {
+        Eigen::Index block = slicer.getBlockSize(), hop = slicer.getHopSize();
+        return (sliding ? 2 * block - hop : block) + (amortized ? hop : 0) + asyncLatency();
+    }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicer.getHopSize(); }
 
     /**
-     * @brief True when the underlying CQT configuration is valid.
+     * @brief Spreads each hop's transform over the following hop.
+     *
+     * Off by default: the forward transform, processBlock() and the inverse
+     * all run in the call that completes a hop, so that call carries a
+     * whole hop's work while the others only copy samples. When on, the
+     * work is split into stages (the full-length FFTs, each band's FFT,
+     * processBlock()) that run in proportion to the samples of the next
+     * hop, for one more hop of latency (see getLatency()). The load only
+     * flattens when host buffers are shorter than the hop. The latency
+     * change makes this a setup call: switching mid-stream drops a block.
+     */
+    void setAmortized(bool on);
+
+    /// True when each hop's work is spread over the next (see setAmortized()).
+    bool isAmortized() const { return amortized; }
+
+    /**
+     * @brief Publishes every hop's coefficients, as processBlock() receives
+     * them, to tap for a reader thread such as a spectrogram; nullptr
+     * detaches.
+     *
+     * Configures the tap with options (magnitude or complex, frames per
+     * band), which allocates: a setup call, and the tap must outlive the
+     * attachment. Publishing only resamples into the tap's preallocated
+     * frames and never blocks. When async it runs on the worker.
+     */
+    void setSnapshotTap(SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True while a worker thread runs the hop work (see Async::setAsync()).
+    bool isAsync() const { return worker != nullptr; }
+
+    /// Number of callbacks (process() chunks) that played silence because
+    /// the worker was late; 0 when not async.
+    Eigen::Index getDeadlineMisses() const;
+
+    /**
+     * @brief True when the underlying CQT configuration and the overlap
+     * factor are valid.
      *
      * An invalid processor is inert: processSample() returns 0 (silence)
      * and never touches its internals. See NsgfCqtCommon::isValid().
      */
-    bool isValid() const { return cqt.isValid(); }
+    bool isValid() const { return valid; }
+
+  protected:
+    /**
+     * @brief Builds the transform from cqtArgs and the hop loop around it.
+     *
+     * @param sliding True for the sliding processors, which overlap-add in
+     * the coefficient domain: R must then also divide every band's
+     * coefficient count, and the latency grows by a block minus a hop.
+     * @param overlap Overlap factor R: blocks advance by numSamples/R
+     * samples. R must be a whole divisor ≥ 2 of the block size; otherwise
+     * the processor is inert.
+     * @param cqtArgs Arguments of the Cqt constructor.
+     */
+    template <typename... Args>
+    BasicHopDriver(bool sliding, Eigen::Index overlap, Args&&... cqtArgs);
+
+    /**
+     * @brief Resynthesizes only the bands processBlock() changed.
+     *
+     * The transform is linear and reconstructs exactly, so the output is
+     * the windowed block itself (the dry signal, overlap-added into place at
+     * the processor's latency) plus the inverse of the coefficient changes.
+     * When on, each hop keeps a copy of the coefficients, compares it with
+     * them after processBlock(), and runs the inverse FFTs of the changed
+     * bands only; a hop that changes nothing runs no inverse at all. The
+     * output matches full resynthesis up to rounding. Allocates the copy:
+     * a setup call. Public on the block processors only: the sliding ones
+     * do not invert the coefficients processBlock() sees, and ignore it.
+     */
+    void setDeltaInverse(bool on);
+
+    /// True when only changed bands are resynthesized (see setDeltaInverse()).
+    bool isDeltaInverse() const { return delta; }
+
+    /// Bands the last hop resynthesized (every band unless setDeltaInverse()).
+    Eigen::Index getNumDirtyBands() const { return delta ? nDirty : cqt.getNumBands(); }
+
+    Cqt cqt; ///< The CQT object used for processing.
+
+  private:
+    template <typename P>
+    friend class Async;
+
+    /// Starts or stops the worker thread (see Async::setAsync()).
+    void setAsync(bool on, const AsyncOptions& options);
+
+    /// Stage hook: forward transform of the windowed block x into the hop's
+    /// coefficients.
+    virtual void analyze(const RealArray& x) = 0;
+
+    /// Stage hook: band k of a staged forward (cqt.forwardStart() has run).
+    virtual void analyzeBand(Eigen::Index k) = 0;
+
+    /// Stage hook: the coefficients processBlock() receives this hop.
+    virtual Block& hopCoefs() = 0;
+
+    /// Stage hook: inverse transform of the processed hop into x.
+    virtual void synthesize(RealArray& x) = 0;
+
+    /// Stage hook: band k of a staged inverse (cqt.inverseFinish() follows).
+    virtual void synthesizeBand(Eigen::Index k) = 0;
+
+    /// Stage hook: runs once the hop's transforms are done.
+    virtual void finishHop() {}
+
+    /// Transforms the block the slicer just completed and splices the result
+    /// (amortized: finishes and splices the previous block, starts this one).
+    void processHop();
+
+    /// Publishes the hop's coefficients to the tap and runs processBlock()
+    /// (delta inverse: between taking the reference and findChanges()).
+    void runBlock();
+
+    /// Delta inverse, after processBlock(): flags the changed bands and
+    /// turns their entries of Xref into the change.
+    void findChanges();
+
+    /// Delta inverse: band k's stage of the staged inverse of the change.
+    void inverseChange(Eigen::Index k);
+
+    /// Delta inverse: finishes the inverse of the change and adds it to the
+    /// dry block in xi (nothing to do when no band changed).
+    void addChanges();
+
+    /// Runs what is left of a pending amortized job, so that a setting
+    /// changed next applies from a hop boundary.
+    void settle();
+
+    /// Runs stage i of the amortized job (see StageScheduler).
+    void runStage(size_t i);
+
+    /// Accounts n samples of the current hop, running the stages now due.
+    void step(Eigen::Index n);
+
+    /// The synchronous path of process() (the worker's, when async).
+    void processDirect(const T* input, T* output, Eigen::Index n);
+
+    /// Extra latency of the worker thread (0 when not async).
+    Eigen::Index asyncLatency() const;
+
+    RealArray                       xi;      ///< Internal processing variable.
+    RealArray                       win;     ///< Windowing function.
+    BasicSlicer<T>                  slicer;  ///< Slicer for data segmentation.
+    BasicSplicer<T>                 splicer; ///< Splicer for data reconstruction.
+    StageScheduler                  stages;  ///< Amortized job over the next hop.
+    Block                           Xref;    ///< Coefficients before processBlock(), then their change (delta inverse).
+    RealArray                       xd;      ///< Inverse of the change (delta inverse).
+    std::vector<bool>               dirty;   ///< Bands processBlock() changed (delta inverse).
+    Eigen::Index                    nDirty    = 0;
+    SnapshotTap*                    tap       = nullptr;
+    bool                            valid     = false;
+    bool                            sliding   = false;
+    bool                            amortized = false;
+    bool                            delta     = false;
+    std::unique_ptr<AsyncWorker<T>> worker;  ///< Worker thread of setAsync(); null when synchronous.
+};
+
+//==========================================================================
+
+/**
+ * @class BasicCqtDenseProcessor
+ * @brief Processes audio samples using a dense non-stationary Gabor transform-based CQT.
+ *
+ * This class provides methods to process individual samples and blocks of data
+ * using a dense CQT (Constant-Q Transform) implementation. The hop loop and
+ * its modes are BasicHopDriver's.
+ */
+template <typename T>
+class BasicCqtDenseProcessor
+    : public BasicHopDriver<T, BasicNsgfCqtDense<T>, typename BasicNsgfCqtDense<T>::ComplexMatrix>
+{
+    using Base = BasicHopDriver<T, BasicNsgfCqtDense<T>, typename BasicNsgfCqtDense<T>::ComplexMatrix>;
+
+  public:
+    using Cqt           = BasicNsgfCqtDense<T>;        ///< Transform type.
+    using RealArray     = typename Cqt::RealArray;     ///< Sample block type.
+    using ComplexMatrix = typename Cqt::ComplexMatrix; ///< Coefficient type.
+
+    /**
+     * @brief Constructs a BasicCqtDenseProcessor object.
+     *
+     * @param sampleRate The sampling rate of the audio signal.
+     * @param numSamples The number of samples to process.
+     * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
+     * @param minFrequency The minimum frequency of the CQT.
+     * @param maxFrequency The maximum frequency of the CQT.
+     * @param refFrequency The reference frequency for the CQT.
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size; otherwise the
+     * processor is inert.
+     */
+    BasicCqtDenseProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
+                           double minFrequency, double maxFrequency, double refFrequency,
+                           Eigen::Index overlap = 2);
+
+    using Base::getNumDirtyBands;
+    using Base::isDeltaInverse;
+    using Base::setDeltaInverse;
 
   protected:
-    NsgfCqtDense cqt; ///< The CQT object used for processing.
+    using Base::cqt;
 
   private:
-    Eigen::ArrayXd   xi;      ///< Internal processing variable.
-    Eigen::ArrayXd   win;     ///< Windowing function.
-    Eigen::ArrayXXcd Xcq;     ///< CQT coefficients.
-    Slicer           slicer;  ///< Slicer for data segmentation.
-    Splicer          splicer; ///< Splicer for data reconstruction.
+    void           analyze(const RealArray& x) override;
+    void           analyzeBand(Eigen::Index k) override;
+    ComplexMatrix& hopCoefs() override { return Xcq; }
+    void           synthesize(RealArray& x) override;
+    void           synthesizeBand(Eigen::Index k) override;
+
+    ComplexMatrix Xcq; ///< CQT coefficients.
 };
 
 //==========================================================================
 
 /**
- * @class CqtSparseProcessor
+ * @class BasicCqtSparseProcessor
  * @brief Processes audio samples using a sparse non-stationary Gabor transform-based CQT.
  *
  * This class provides methods to process individual samples and blocks of data
- * using a sparse CQT implementation.
+ * using a sparse CQT implementation. The hop loop and its modes are
+ * BasicHopDriver's.
  */
-class CqtSparseProcessor
+template <typename T>
+class BasicCqtSparseProcessor
+    : public BasicHopDriver<T, BasicNsgfCqtSparse<T>, typename BasicNsgfCqtSparse<T>::Coefs>
 {
+    using Base = BasicHopDriver<T, BasicNsgfCqtSparse<T>, typename BasicNsgfCqtSparse<T>::Coefs>;
+
   public:
+    using Cqt       = BasicNsgfCqtSparse<T>;   ///< Transform type.
+    using RealArray = typename Cqt::RealArray; ///< Sample block type.
+    using Coefs     = typename Cqt::Coefs;     ///< Coefficient type.
+
     /**
-     * @brief Constructs a CqtSparseProcessor object.
+     * @brief Constructs a BasicCqtSparseProcessor object.
      *
      * @param sampleRate The sampling rate of the audio signal.
      * @param numSamples The number of samples to process.
@@ -132,9 +387,269 @@ class CqtSparseProcessor
      * @param minFrequency The minimum frequency of the CQT.
      * @param maxFrequency The maximum frequency of the CQT.
      * @param refFrequency The reference frequency for the CQT.
+     * @param spanPolicy How the CQT rounds band spans (see NsgfCqtSparse).
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size; otherwise the
+     * processor is inert.
      */
-    CqtSparseProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
-                       double minFrequency, double maxFrequency, double refFrequency);
+    BasicCqtSparseProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
+                            double minFrequency, double maxFrequency, double refFrequency,
+                            SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo, Eigen::Index overlap = 2);
+
+    using Base::getNumDirtyBands;
+    using Base::isDeltaInverse;
+    using Base::setDeltaInverse;
+
+  protected:
+    using Base::cqt;
+
+  private:
+    void   analyze(const RealArray& x) override;
+    void   analyzeBand(Eigen::Index k) override;
+    Coefs& hopCoefs() override { return Xcq; }
+    void   synthesize(RealArray& x) override;
+    void   synthesizeBand(Eigen::Index k) override;
+
+    Coefs Xcq; ///< Sparse CQT coefficients.
+};
+
+//==========================================================================
+
+/**
+ * @class BasicSlidingCqtDenseProcessor
+ * @brief Processes audio samples using a sliding window dense CQT.
+ *
+ * This class provides methods to process individual samples and blocks of data
+ * using a sliding window implementation of the dense CQT. The hop loop and
+ * its modes are BasicHopDriver's.
+ */
+template <typename T>
+class BasicSlidingCqtDenseProcessor
+    : public BasicHopDriver<T, BasicNsgfCqtDense<T>, typename BasicNsgfCqtDense<T>::ComplexMatrix>
+{
+    using Base = BasicHopDriver<T, BasicNsgfCqtDense<T>, typename BasicNsgfCqtDense<T>::ComplexMatrix>;
+
+  public:
+    using Cqt           = BasicNsgfCqtDense<T>;        ///< Transform type.
+    using RealArray     = typename Cqt::RealArray;     ///< Sample block type.
+    using ComplexMatrix = typename Cqt::ComplexMatrix; ///< Coefficient type.
+
+    /**
+     * @brief Constructs a BasicSlidingCqtDenseProcessor object.
+     *
+     * @param sampleRate The sampling rate of the audio signal.
+     * @param numSamples The number of samples to process.
+     * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
+     * @param minFrequency The minimum frequency of the CQT.
+     * @param maxFrequency The maximum frequency of the CQT.
+     * @param refFrequency The reference frequency for the CQT.
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size; otherwise the
+     * processor is inert.
+     */
+    BasicSlidingCqtDenseProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
+                                  double minFrequency, double maxFrequency, double refFrequency,
+                                  Eigen::Index overlap = 2);
+
+  protected:
+    using Base::cqt;
+
+  private:
+    void           analyze(const RealArray& x) override;
+    void           analyzeBand(Eigen::Index k) override;
+    ComplexMatrix& hopCoefs() override { return Zcq[0]; }
+    void           synthesize(RealArray& x) override;
+    void           synthesizeBand(Eigen::Index k) override;
+    void           finishHop() override;
+
+    /// Windows band k of the current slice and overlap-adds the hop it
+    /// completes.
+    void addSlice(Eigen::Index k);
+
+    /// Gathers band k of the last R finished hops, oldest first, into the
+    /// windowed slice to resynthesize.
+    void gatherHops(Eigen::Index k);
+
+    HistoryBuffer<ComplexMatrix> Xcq; ///< CQT coefficients of the last overlap slices.
+    HistoryBuffer<ComplexMatrix> Zcq; ///< Overlap-added coefficients of the last overlap hops.
+    ComplexMatrix                Ycq; ///< Intermediate CQT coefficients.
+};
+
+//==========================================================================
+
+/**
+ * @class BasicSlidingCqtSparseProcessor
+ * @brief Processes audio samples using a sliding window sparse CQT.
+ *
+ * This class provides methods to process individual samples and blocks of data
+ * using a sliding window implementation of the sparse CQT. The hop loop and
+ * its modes are BasicHopDriver's.
+ */
+template <typename T>
+class BasicSlidingCqtSparseProcessor
+    : public BasicHopDriver<T, BasicNsgfCqtSparse<T>, typename BasicNsgfCqtSparse<T>::Coefs>
+{
+    using Base = BasicHopDriver<T, BasicNsgfCqtSparse<T>, typename BasicNsgfCqtSparse<T>::Coefs>;
+
+  public:
+    using Cqt       = BasicNsgfCqtSparse<T>;   ///< Transform type.
+    using RealArray = typename Cqt::RealArray; ///< Sample block type.
+    using Coefs     = typename Cqt::Coefs;     ///< Coefficient type.
+    using Frame     = typename Cqt::Frame;     ///< Per-band window type.
+
+    /**
+     * @brief Constructs a BasicSlidingCqtSparseProcessor object.
+     *
+     * @param sampleRate The sampling rate of the audio signal.
+     * @param numSamples The number of samples to process.
+     * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
+     * @param minFrequency The minimum frequency of the CQT.
+     * @param maxFrequency The maximum frequency of the CQT.
+     * @param refFrequency The reference frequency for the CQT.
+     * @param spanPolicy How the CQT rounds band spans (see NsgfCqtSparse).
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size and of every band
+     * span; otherwise the processor is inert.
+     */
+    BasicSlidingCqtSparseProcessor(double sampleRate, Eigen::Index numSamples,
+                                   double fraction, double minFrequency,
+                                   double maxFrequency, double refFrequency,
+                                   SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo, Eigen::Index overlap = 2);
+
+    /**
+     * @brief Gets the CQT window for a specific index.
+     *
+     * @param k The index of the CQT window.
+     * @return A constant reference to the CQT window.
+     */
+    const RealArray& getCqtWindow(Eigen::Index k) const { return Win[k]; }
+
+  protected:
+    using Base::cqt;
+
+  private:
+    void   analyze(const RealArray& x) override;
+    void   analyzeBand(Eigen::Index k) override;
+    Coefs& hopCoefs() override { return Zcq[0]; }
+    void   synthesize(RealArray& x) override;
+    void   synthesizeBand(Eigen::Index k) override;
+    void   finishHop() override;
+
+    /// Windows band k of the current slice and overlap-adds the hop it
+    /// completes (band k's hop is getLength(k)/R coefficients long).
+    void addSlice(Eigen::Index k);
+
+    /// Gathers band k of the last R finished hops, oldest first, into the
+    /// windowed slice to resynthesize.
+    void gatherHops(Eigen::Index k);
+
+    HistoryBuffer<Coefs> Xcq; ///< Sparse CQT coefficients of the last overlap slices.
+    HistoryBuffer<Coefs> Zcq; ///< Overlap-added coefficients of the last overlap hops.
+    Coefs                Ycq; ///< Intermediate sparse CQT coefficients.
+    Frame                Win; ///< Frame of CQT windows.
+};
+
+//==========================================================================
+
+/**
+ * @class Async
+ * @brief A single-channel processor whose hop work can run on a worker thread.
+ *
+ * The worker calls processBlock(), so it must stop before any part of the
+ * processor is destroyed. Only this wrapper can start it, and being final
+ * it is the most derived class: its destructor runs first and stops the
+ * worker while P is still whole. Declare the processor as Async<P>, where P
+ * is the subclass implementing processBlock().
+ *
+ * @tparam P A processor derived from BasicHopDriver.
+ */
+template <typename P>
+class Async final : public P
+{
+  public:
+    /// Constructs P from args, with the worker off.
+    template <typename... Args>
+    explicit Async(Args&&... args) : P(std::forward<Args>(args)...)
+    {
+    }
+
+    /// Stops the worker, if any, before P is destroyed.
+    ~Async() override { setAsync(false); }
+
+    /**
+     * @brief Moves the hop work off the calling thread.
+     *
+     * When on, processSample() and process() only copy samples into a
+     * lock-free ring and out of another; a dedicated worker thread runs the
+     * forward transform, processBlock() and the inverse. The worker has
+     * options.extraLatency samples (one hop by default) to finish each hop,
+     * and getLatency() grows by that much. Output that is still missing
+     * when it is due plays as silence, is counted in getDeadlineMisses(),
+     * and is dropped when it arrives, so the latency never drifts. Host
+     * buffers must be shorter than the extra latency.
+     *
+     * Starts or stops a thread: not real-time safe, and samples in flight
+     * are lost. processBlock() runs on the worker while this is on.
+     */
+    void setAsync(bool on, const AsyncOptions& options = {}) { P::setAsync(on, options); }
+};
+
+//==========================================================================
+
+/**
+ * @class BasicMultirateCqtProcessor
+ * @brief Processes audio samples with an octave-wise, decimated sparse CQT.
+ *
+ * The single-rate processors analyse every band from one block at the input
+ * rate, so the block has to resolve the lowest band: a low minFrequency
+ * forces blocks of 2^17–2^18 samples. This processor instead splits the
+ * input into octaves (Gaborator-style): the top octave is analysed at the
+ * input rate, then a half-band filter halves the sample rate and the same
+ * one-octave CQT — the same atoms, shared through the FrameRegistry — is
+ * applied to the next octave down, and so on. Each stage does half the work
+ * of the one above it, so cost and memory are dominated by the top octave
+ * and numSamples only has to resolve one octave (a few hundred samples at
+ * 12 bands per octave), whatever minFrequency is.
+ *
+ * Stage o runs at fs/2^o. It removes the half-band lowpass of its input
+ * (decimate, interpolate, subtract), sends the high residual through the
+ * octave CQT (an inner BasicCqtSparseProcessor) and passes the decimated
+ * lowpass to stage o + 1; the last stage takes everything left. The output
+ * adds the interpolated result of the stage below to the delayed residual,
+ * so reconstruction is exact whatever the filter's quality: the filter only
+ * decides how cleanly each octave's content lands in its own stage.
+ *
+ * Bands sit on the grid refFrequency·2^(n·fraction), with 1/fraction a
+ * whole number ≥ 2 (so that halving the rate maps the grid onto itself);
+ * otherwise the processor is inert. Octave 0 holds the 1/fraction grid
+ * bands just below Nyquist; stages whose bands all lie above maxFrequency
+ * skip their CQT (the residual is only delayed) and never reach
+ * processBlock(). The latency is that of the lowest stage scaled back to
+ * the input rate, about numSamples·2^(getNumOctaves() - 1): decimation
+ * shrinks the block, not the time span the lowest band needs.
+ */
+template <typename T>
+class BasicMultirateCqtProcessor
+{
+  public:
+    using Cqt       = BasicNsgfCqtSparse<T>;   ///< Per-octave transform type.
+    using RealArray = typename Cqt::RealArray; ///< Sample block type.
+    using Coefs     = typename Cqt::Coefs;     ///< Coefficient type.
+
+    /**
+     * @brief Constructs a BasicMultirateCqtProcessor object.
+     *
+     * @param sampleRate The sampling rate of the audio signal.
+     * @param numSamples The block size of every octave's CQT (at that octave's rate).
+     * @param fraction Reciprocal of bands per octave; 1/fraction must be a whole number ≥ 2.
+     * @param minFrequency The minimum frequency of the CQT.
+     * @param maxFrequency The maximum frequency of the CQT.
+     * @param refFrequency The reference frequency for the CQT.
+     * @param spanPolicy How the per-octave CQT rounds band spans (see NsgfCqtSparse).
+     */
+    BasicMultirateCqtProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
+                               double minFrequency, double maxFrequency, double refFrequency,
+                               SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo);
 
     /**
      * @brief Virtual destructor for safe polymorphic use.
@@ -143,7 +658,10 @@ class CqtSparseProcessor
      * through a base class pointer. This destructor is defaulted as the base class
      * does not require custom cleanup.
      */
-    virtual ~CqtSparseProcessor() = default;
+    virtual ~BasicMultirateCqtProcessor() = default;
+
+    BasicMultirateCqtProcessor(const BasicMultirateCqtProcessor&)            = delete;
+    BasicMultirateCqtProcessor& operator=(const BasicMultirateCqtProcessor&) = delete;
 
     /**
      * @brief Processes a single audio sample.
@@ -151,245 +669,965 @@ class CqtSparseProcessor
      * @param sample The audio sample to process.
      * @return The processed sample.
      */
-    double processSample(double sample);
+    T processSample(T sample);
 
     /**
-     * @brief Processes a block of data.
+     * @brief Processes a buffer of samples; equivalent to calling
+     * processSample() on each of them (the octave filters run per sample).
      *
-     * @param block The block of data to process.
+     * @param input The n input samples.
+     * @param output Receives the n processed samples (may alias input).
+     * @param n Number of samples.
      */
-    virtual void processBlock(NsgfCqtSparse::Coefs& block) = 0;
+    void process(const T* input, T* output, Eigen::Index n);
 
     /**
-     * @brief Gets the windowing function.
+     * @brief Processes a block of one octave's coefficients.
      *
-     * @return A constant reference to the windowing function.
+     * Called whenever the CQT of an octave completes a block, i.e. every
+     * numSamples/2 samples *at that octave's rate*: octave o is called
+     * 2^o times less often than octave 0. Band k of octave o is centred
+     * at getBandFrequency(o, k).
+     *
+     * @param octave Octave index, 0 being the highest.
+     * @param block The octave's coefficients (getCqt().getNumBands() bands).
      */
-    const Eigen::ArrayXd& getWindow() const { return win; }
+    virtual void processBlock(Eigen::Index octave, Coefs& block) = 0;
 
     /**
-     * @brief Gets the CQT object.
+     * @brief Gets the number of octave stages (0 when invalid).
+     */
+    Eigen::Index getNumOctaves() const { return valid ? Eigen::Index(stages.size()) : 0; }
+
+    /**
+     * @brief Gets the per-octave CQT, shared by every stage.
+     *
+     * Its band axis is octave 0's; octave o's bands are one octave lower per
+     * step (see getBandFrequency()).
      *
      * @return A constant reference to the CQT object.
      */
-    const NsgfCqtSparse& getCqt() const { return cqt; }
+    const Cqt& getCqt() const { return stages.back().octave->getCqt(); }
+
+    /**
+     * @brief Centre frequency (Hz) of band k of an octave.
+     *
+     * @param octave Octave index, 0 being the highest.
+     * @param k Band index within the octave.
+     */
+    double getBandFrequency(Eigen::Index octave, Eigen::Index k) const
+    {
+        return getCqt().getBandAxis()(k) * std::exp2(-double(octave));
+    }
 
     /**
      * @brief Gets the latency produced by the processor.
      *
      * @return Integer number of samples of delay between input and output.
      */
-    Eigen::Index getLatency() const { return slicer.getBlockSize(); }
+    Eigen::Index getLatency() const { return latency; }
 
     /**
-     * @brief True when the underlying CQT configuration is valid.
+     * @brief Publishes one octave's coefficients, as processBlock() receives
+     * them, to tap; nullptr detaches (see
+     * BasicHopDriver::setSnapshotTap()). A setup call.
      *
-     * An invalid processor is inert: processSample() returns 0 (silence)
-     * and never touches its internals. See NsgfCqtCommon::isValid().
+     * Each octave takes its own tap, since octaves differ in rate: octave o
+     * publishes 2^o times less often than octave 0. An octave that skips
+     * its CQT never publishes.
      */
-    bool isValid() const { return cqt.isValid(); }
+    void setSnapshotTap(Eigen::Index octave, SnapshotTap* tap, const SnapshotOptions& options = {});
 
-  protected:
-    NsgfCqtSparse cqt; ///< The CQT object used for processing.
+    /**
+     * @brief True when the configuration is valid.
+     *
+     * Requires a whole number of bands per octave and a valid per-octave
+     * CQT. An invalid processor is inert: processSample() returns 0
+     * (silence) and never touches its internals.
+     */
+    bool isValid() const { return valid; }
 
   private:
-    Eigen::ArrayXd       xi;      ///< Internal processing variable.
-    Eigen::ArrayXd       win;     ///< Windowing function.
-    NsgfCqtSparse::Coefs Xcq;     ///< Sparse CQT coefficients.
-    Slicer               slicer;  ///< Slicer for data segmentation.
-    Splicer              splicer; ///< Splicer for data reconstruction.
+    /// Inner block processor of one octave; forwards its blocks to the owner.
+    class Octave : public BasicCqtSparseProcessor<T>
+    {
+      public:
+        template <typename... Args>
+        Octave(BasicMultirateCqtProcessor& owner, Eigen::Index index, Args&&... args) :
+            BasicCqtSparseProcessor<T>(std::forward<Args>(args)...), owner(owner), index(index)
+        {
+        }
+
+        void processBlock(Coefs& block) override { owner.processBlock(index, block); }
+
+      private:
+        BasicMultirateCqtProcessor& owner; ///< Processor receiving the blocks.
+        Eigen::Index                index; ///< This octave's index.
+    };
+
+    /// Circular history with power-of-two capacity; (*this)(0) is the newest sample.
+    struct History {
+        RealArray    buffer;   ///< Samples, newest at pos.
+        Eigen::Index mask = 0; ///< Capacity - 1.
+        Eigen::Index pos  = 0; ///< Index of the newest sample.
+
+        void resize(Eigen::Index minSize);
+        void push(T sample) { pos = (pos + 1) & mask, buffer(pos) = sample; }
+        T    operator()(Eigen::Index lag) const { return buffer((pos - lag) & mask); }
+    };
+
+    /// One octave stage, running at fs/2^index.
+    struct Stage {
+        std::unique_ptr<Octave> octave;       ///< The octave's CQT; null when it holds no requested band.
+        History                 x;            ///< Stage input.
+        History                 low;          ///< Decimated lowpass (input of the next stage).
+        History                 lowOut;       ///< Output of the next stage.
+        History                 residual;     ///< Processed (or bare) high residual.
+        Eigen::Index            delay = 0;    ///< Lag of the residual that aligns it with lowOut.
+        bool                    even  = true; ///< Phase of the factor-2 decimation.
+    };
+
+    /// Runs one sample through stage o and everything below it.
+    T processStage(Eigen::Index o, T sample);
+
+    /// Half-band group delay (odd): 2·filterDelay + 1 taps.
+    static constexpr Eigen::Index filterDelay = 31;
+
+    /// Kaiser shape of the half-band filter (about -70 dB stopband).
+    static constexpr double filterBeta = 7;
+
+    std::vector<Stage> stages;      ///< Octave stages, highest first.
+    RealArray          taps;        ///< Even-offset half-band taps h[0], h[2], ..., h[2D].
+    Eigen::Index       latency = 0; ///< Total delay in input samples.
+    bool               valid   = false;
 };
 
 //==========================================================================
 
 /**
- * @class SlidingCqtDenseProcessor
- * @brief Processes audio samples using a sliding window dense CQT.
- * 
- * This class provides methods to process individual samples and blocks of data
- * using a sliding window implementation of the dense CQT.
+ * @class BasicMultiChannelCqtDenseProcessor
+ * @brief BasicCqtDenseProcessor over several channels sharing one transform.
+ *
+ * One CQT, one frame and one set of FFT plans serve every channel: each hop
+ * runs the multi-channel forward and inverse (the channels of a band go to
+ * the backend as one batched call) and hands processBlock() the
+ * coefficients of all channels at once, so cross-channel processing costs
+ * no extra analysis. The output of each channel is what a single-channel
+ * BasicCqtDenseProcessor would produce.
  */
-class SlidingCqtDenseProcessor
+template <typename T>
+class BasicMultiChannelCqtDenseProcessor
 {
   public:
+    using Cqt           = BasicNsgfCqtDense<T>;        ///< Transform type.
+    using RealArray     = typename Cqt::RealArray;     ///< Sample block type.
+    using RealMatrix    = typename Cqt::RealMatrix;    ///< Samples × channels.
+    using ComplexMatrix = typename Cqt::ComplexMatrix; ///< Coefficients of one channel.
+    using MultiCoefs    = typename Cqt::MultiCoefs;    ///< Coefficients, one matrix per channel.
+
     /**
-     * @brief Constructs a SlidingCqtDenseProcessor object.
-     * 
+     * @brief Constructs a BasicMultiChannelCqtDenseProcessor object.
+     *
+     * @param numChannels The number of channels (at least 1).
      * @param sampleRate The sampling rate of the audio signal.
      * @param numSamples The number of samples to process.
      * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
      * @param minFrequency The minimum frequency of the CQT.
      * @param maxFrequency The maximum frequency of the CQT.
      * @param refFrequency The reference frequency for the CQT.
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size (the sliding sparse
+     * processors also need it to divide every band span); otherwise the
+     * processor is inert.
      */
-    SlidingCqtDenseProcessor(double sampleRate, Eigen::Index numSamples, double fraction,
-                             double minFrequency, double maxFrequency, double refFrequency);
+    BasicMultiChannelCqtDenseProcessor(Eigen::Index numChannels, double sampleRate, Eigen::Index numSamples,
+                                       double fraction, double minFrequency, double maxFrequency,
+                                       double refFrequency, Eigen::Index overlap = 2);
 
     /**
      * @brief Virtual destructor for safe polymorphic use.
-     *
-     * Declared virtual to ensure that derived classes can be safely deleted
-     * through a base class pointer. This destructor is defaulted as the base class
-     * does not require custom cleanup.
      */
-    virtual ~SlidingCqtDenseProcessor() = default;
+    virtual ~BasicMultiChannelCqtDenseProcessor() = default;
 
     /**
-     * @brief Processes a single audio sample.
-     * 
-     * @param sample The audio sample to process.
-     * @return The processed sample.
+     * @brief Processes n samples of every channel.
+     *
+     * @param inputs getNumChannels() pointers to n input samples each.
+     * @param outputs getNumChannels() pointers receiving n processed samples
+     * each (a channel's output may alias its input).
+     * @param n Number of samples per channel.
      */
-    double processSample(double sample);
+    void process(const T* const* inputs, T* const* outputs, Eigen::Index n);
 
     /**
      * @brief Processes a block of data.
-     * 
-     * @param block The block of data to process.
+     *
+     * @param block The coefficients of every channel (block[c] is channel c).
      */
-    virtual void processBlock(Eigen::ArrayXXcd& block) = 0;
+    virtual void processBlock(MultiCoefs& block) = 0;
+
+    /// Gets the number of channels.
+    Eigen::Index getNumChannels() const { return Eigen::Index(slicers.size()); }
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the latency produced by the processor, in samples.
+    Eigen::Index getLatency() const { return slicers.front().getBlockSize(); }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicers.front().getHopSize(); }
+
+    /// Publishes channel's coefficients, as processBlock() receives them,
+    /// to tap every hop; nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(Eigen::Index channel, SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise the processor outputs silence).
+    bool isValid() const { return valid; }
+
+  protected:
+    Cqt cqt; ///< The CQT object used for processing.
+
+  private:
+    /// Transforms the blocks the slicers just completed and splices the results.
+    void processHop();
+
+    RealMatrix                   xi;       ///< Internal processing variable (samples × channels).
+    RealArray                    win;      ///< Windowing function.
+    MultiCoefs                   Xcq;      ///< CQT coefficients of every channel.
+    std::vector<BasicSlicer<T>>  slicers;  ///< One slicer per channel.
+    std::vector<BasicSplicer<T>> splicers; ///< One splicer per channel.
+    SnapshotTaps                 taps;     ///< Snapshot taps of the channels.
+    bool                         valid = false;
+};
+
+//==========================================================================
+
+/**
+ * @class BasicMultiChannelCqtSparseProcessor
+ * @brief BasicCqtSparseProcessor over several channels sharing one transform.
+ *
+ * See BasicMultiChannelCqtDenseProcessor; the per-band IDFTs of all channels
+ * run as one batched call per band.
+ */
+template <typename T>
+class BasicMultiChannelCqtSparseProcessor
+{
+  public:
+    using Cqt        = BasicNsgfCqtSparse<T>;    ///< Transform type.
+    using RealArray  = typename Cqt::RealArray;  ///< Sample block type.
+    using RealMatrix = typename Cqt::RealMatrix; ///< Samples × channels.
+    using MultiCoefs = typename Cqt::MultiCoefs; ///< Coefficients, one Coefs per channel.
 
     /**
-     * @brief Gets the windowing function.
+     * @brief Constructs a BasicMultiChannelCqtSparseProcessor object.
      *
-     * @return A constant reference to the windowing function.
+     * @param numChannels The number of channels (at least 1).
+     * @param sampleRate The sampling rate of the audio signal.
+     * @param numSamples The number of samples to process.
+     * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
+     * @param minFrequency The minimum frequency of the CQT.
+     * @param maxFrequency The maximum frequency of the CQT.
+     * @param refFrequency The reference frequency for the CQT.
+     * @param spanPolicy How the CQT rounds band spans (see NsgfCqtSparse).
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size (the sliding sparse
+     * processors also need it to divide every band span); otherwise the
+     * processor is inert.
      */
-    const Eigen::ArrayXd& getWindow() const { return win; }
+    BasicMultiChannelCqtSparseProcessor(Eigen::Index numChannels, double sampleRate, Eigen::Index numSamples,
+                                        double fraction, double minFrequency, double maxFrequency,
+                                        double refFrequency, SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo,
+                                        Eigen::Index overlap = 2);
 
     /**
-     * @brief Gets the CQT object.
-     * 
-     * @return A constant reference to the CQT object.
+     * @brief Virtual destructor for safe polymorphic use.
      */
-    const NsgfCqtDense& getCqt() const { return cqt; }
+    virtual ~BasicMultiChannelCqtSparseProcessor() = default;
 
     /**
-     * @brief Gets the latency produced by the processor.
+     * @brief Processes n samples of every channel.
      *
-     * @return Integer number of samples of delay between input and output.
+     * @param inputs getNumChannels() pointers to n input samples each.
+     * @param outputs getNumChannels() pointers receiving n processed samples
+     * each (a channel's output may alias its input).
+     * @param n Number of samples per channel.
      */
-    Eigen::Index getLatency() const { return slicer.getBlockSize() + slicer.getHopSize(); }
+    void process(const T* const* inputs, T* const* outputs, Eigen::Index n);
 
     /**
-     * @brief True when the underlying CQT configuration is valid.
+     * @brief Processes a block of data.
      *
-     * An invalid processor is inert: processSample() returns 0 (silence)
-     * and never touches its internals. See NsgfCqtCommon::isValid().
+     * @param block The coefficients of every channel (block[c] is channel c).
      */
-    bool isValid() const { return cqt.isValid(); }
+    virtual void processBlock(MultiCoefs& block) = 0;
+
+    /// Gets the number of channels.
+    Eigen::Index getNumChannels() const { return Eigen::Index(slicers.size()); }
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the latency produced by the processor, in samples.
+    Eigen::Index getLatency() const { return slicers.front().getBlockSize(); }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicers.front().getHopSize(); }
+
+    /// Publishes channel's coefficients, as processBlock() receives them,
+    /// to tap every hop; nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(Eigen::Index channel, SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise the processor outputs silence).
+    bool isValid() const { return valid; }
 
   protected:
-    NsgfCqtDense cqt; ///< The CQT object used for processing.
+    Cqt cqt; ///< The CQT object used for processing.
 
   private:
-    Eigen::ArrayXd                 xi;      ///< Internal processing variable.
-    DoubleBuffer<Eigen::ArrayXXcd> Xcq;     ///< Double buffer for CQT coefficients.
-    DoubleBuffer<Eigen::ArrayXXcd> Zcq;     ///< Double buffer for intermediate coefficients.
-    Eigen::ArrayXXcd               Ycq;     ///< Intermediate CQT coefficients.
-    Eigen::ArrayXd                 win;     ///< Windowing function.
-    Slicer                         slicer;  ///< Slicer for data segmentation.
-    Splicer                        splicer; ///< Splicer for data reconstruction.
+    /// Transforms the blocks the slicers just completed and splices the results.
+    void processHop();
+
+    RealMatrix                   xi;       ///< Internal processing variable (samples × channels).
+    RealArray                    win;      ///< Windowing function.
+    MultiCoefs                   Xcq;      ///< Sparse CQT coefficients of every channel.
+    std::vector<BasicSlicer<T>>  slicers;  ///< One slicer per channel.
+    std::vector<BasicSplicer<T>> splicers; ///< One splicer per channel.
+    SnapshotTaps                 taps;     ///< Snapshot taps of the channels.
+    bool                         valid = false;
 };
 
 //==========================================================================
 
 /**
- * @class SlidingCqtSparseProcessor
- * @brief Processes audio samples using a sliding window sparse CQT.
- * 
- * This class provides methods to process individual samples and blocks of data
- * using a sliding window implementation of the sparse CQT.
+ * @class BasicMultiChannelSlidingCqtDenseProcessor
+ * @brief BasicSlidingCqtDenseProcessor over several channels sharing one
+ * transform (see BasicMultiChannelCqtDenseProcessor).
  */
-class SlidingCqtSparseProcessor
+template <typename T>
+class BasicMultiChannelSlidingCqtDenseProcessor
 {
   public:
+    using Cqt           = BasicNsgfCqtDense<T>;        ///< Transform type.
+    using RealArray     = typename Cqt::RealArray;     ///< Sample block type.
+    using RealMatrix    = typename Cqt::RealMatrix;    ///< Samples × channels.
+    using ComplexMatrix = typename Cqt::ComplexMatrix; ///< Coefficients of one channel.
+    using MultiCoefs    = typename Cqt::MultiCoefs;    ///< Coefficients, one matrix per channel.
+
     /**
-     * @brief Constructs a SlidingCqtSparseProcessor object.
-     * 
+     * @brief Constructs a BasicMultiChannelSlidingCqtDenseProcessor object.
+     *
+     * @param numChannels The number of channels (at least 1).
      * @param sampleRate The sampling rate of the audio signal.
      * @param numSamples The number of samples to process.
      * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
      * @param minFrequency The minimum frequency of the CQT.
      * @param maxFrequency The maximum frequency of the CQT.
      * @param refFrequency The reference frequency for the CQT.
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size (the sliding sparse
+     * processors also need it to divide every band span); otherwise the
+     * processor is inert.
      */
-    SlidingCqtSparseProcessor(double sampleRate, Eigen::Index numSamples,
-                              double fraction, double minFrequency,
-                              double maxFrequency, double refFrequency);
+    BasicMultiChannelSlidingCqtDenseProcessor(Eigen::Index numChannels, double sampleRate, Eigen::Index numSamples,
+                                              double fraction, double minFrequency, double maxFrequency,
+                                              double refFrequency, Eigen::Index overlap = 2);
 
     /**
      * @brief Virtual destructor for safe polymorphic use.
+     */
+    virtual ~BasicMultiChannelSlidingCqtDenseProcessor() = default;
+
+    /**
+     * @brief Processes n samples of every channel.
      *
-     * Declared virtual to ensure that derived classes can be safely deleted
-     * through a base class pointer. This destructor is defaulted as the base class
-     * does not require custom cleanup.
+     * @param inputs getNumChannels() pointers to n input samples each.
+     * @param outputs getNumChannels() pointers receiving n processed samples
+     * each (a channel's output may alias its input).
+     * @param n Number of samples per channel.
      */
-    virtual ~SlidingCqtSparseProcessor() = default;
+    void process(const T* const* inputs, T* const* outputs, Eigen::Index n);
 
     /**
-     * @brief Processes a single audio sample.
-     * 
-     * @param sample The audio sample to process.
-     * @return The processed sample.
+     * @brief Processes a block of data.
+     *
+     * @param block The coefficients of every channel (block[c] is channel c).
+     */
+    virtual void processBlock(MultiCoefs& block) = 0;
+
+    /// Gets the number of channels.
+    Eigen::Index getNumChannels() const { return Eigen::Index(slicers.size()); }
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the latency produced by the processor, in samples.
+    Eigen::Index getLatency() const { return 2 * slicers.front().getBlockSize() - slicers.front().getHopSize(); }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicers.front().getHopSize(); }
+
+    /// Publishes channel's coefficients, as processBlock() receives them,
+    /// to tap every hop; nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(Eigen::Index channel, SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise the processor outputs silence).
+    bool isValid() const { return valid; }
+
+  protected:
+    Cqt cqt; ///< The CQT object used for processing.
+
+  private:
+    /// Transforms the blocks the slicers just completed and splices the results.
+    void processHop();
+
+    RealMatrix                   xi;       ///< Internal processing variable (samples × channels).
+    HistoryBuffer<MultiCoefs>    Xcq;      ///< CQT coefficients of the last overlap slices.
+    HistoryBuffer<MultiCoefs>    Zcq;      ///< Overlap-added coefficients of the last overlap hops.
+    MultiCoefs                   Ycq;      ///< Intermediate CQT coefficients.
+    RealArray                    win;      ///< Windowing function.
+    std::vector<BasicSlicer<T>>  slicers;  ///< One slicer per channel.
+    std::vector<BasicSplicer<T>> splicers; ///< One splicer per channel.
+    SnapshotTaps                 taps;     ///< Snapshot taps of the channels.
+    bool                         valid = false;
+};
+
+//==========================================================================
+
+/**
+ * @class BasicMultiChannelSlidingCqtSparseProcessor
+ * @brief BasicSlidingCqtSparseProcessor over several channels sharing one
+ * transform (see BasicMultiChannelCqtDenseProcessor).
+ */
+template <typename T>
+class BasicMultiChannelSlidingCqtSparseProcessor
+{
+  public:
+    using Cqt        = BasicNsgfCqtSparse<T>;    ///< Transform type.
+    using RealArray  = typename Cqt::RealArray;  ///< Sample block type.
+    using RealMatrix = typename Cqt::RealMatrix; ///< Samples × channels.
+    using MultiCoefs = typename Cqt::MultiCoefs; ///< Coefficients, one Coefs per channel.
+    using Frame      = typename Cqt::Frame;      ///< Per-band window type.
+
+    /**
+     * @brief Constructs a BasicMultiChannelSlidingCqtSparseProcessor object.
+     *
+     * @param numChannels The number of channels (at least 1).
+     * @param sampleRate The sampling rate of the audio signal.
+     * @param numSamples The number of samples to process.
+     * @param fraction Reciprocal of bands per octave (e.g. 1.0/12 for 12 bands/octave); fractional values allowed.
+     * @param minFrequency The minimum frequency of the CQT.
+     * @param maxFrequency The maximum frequency of the CQT.
+     * @param refFrequency The reference frequency for the CQT.
+     * @param spanPolicy How the CQT rounds band spans (see NsgfCqtSparse).
+     * @param overlap Overlap factor R: blocks advance by numSamples/R samples.
+     * R must be a whole divisor ≥ 2 of the block size (the sliding sparse
+     * processors also need it to divide every band span); otherwise the
+     * processor is inert.
+     */
+    BasicMultiChannelSlidingCqtSparseProcessor(Eigen::Index numChannels, double sampleRate, Eigen::Index numSamples,
+                                               double fraction, double minFrequency, double maxFrequency,
+                                               double refFrequency, SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo,
+                                               Eigen::Index overlap = 2);
+
+    /**
+     * @brief Virtual destructor for safe polymorphic use.
      */
-    double processSample(double sample);
+    virtual ~BasicMultiChannelSlidingCqtSparseProcessor() = default;
+
+    /**
+     * @brief Processes n samples of every channel.
+     *
+     * @param inputs getNumChannels() pointers to n input samples each.
+     * @param outputs getNumChannels() pointers receiving n processed samples
+     * each (a channel's output may alias its input).
+     * @param n Number of samples per channel.
+     */
+    void process(const T* const* inputs, T* const* outputs, Eigen::Index n);
 
     /**
      * @brief Processes a block of data.
-     * 
-     * @param block The block of data to process.
+     *
+     * @param block The coefficients of every channel (block[c] is channel c).
      */
-    virtual void processBlock(NsgfCqtSparse::Coefs& block) = 0;
+    virtual void processBlock(MultiCoefs& block) = 0;
+
+    /// Gets the number of channels.
+    Eigen::Index getNumChannels() const { return Eigen::Index(slicers.size()); }
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT window of band k.
+    const RealArray& getCqtWindow(Eigen::Index k) const { return Win[k]; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the latency produced by the processor, in samples.
+    Eigen::Index getLatency() const { return 2 * slicers.front().getBlockSize() - slicers.front().getHopSize(); }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicers.front().getHopSize(); }
+
+    /// Publishes channel's coefficients, as processBlock() receives them,
+    /// to tap every hop; nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(Eigen::Index channel, SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise the processor outputs silence).
+    bool isValid() const { return valid; }
+
+  protected:
+    Cqt cqt; ///< The CQT object used for processing.
+
+  private:
+    /// Transforms the blocks the slicers just completed and splices the results.
+    void processHop();
+
+    RealMatrix                   xi;       ///< Internal processing variable (samples × channels).
+    HistoryBuffer<MultiCoefs>    Xcq;      ///< Sparse CQT coefficients of the last overlap slices.
+    HistoryBuffer<MultiCoefs>    Zcq;      ///< Overlap-added coefficients of the last overlap hops.
+    MultiCoefs                   Ycq;      ///< Intermediate sparse CQT coefficients.
+    RealArray                    win;      ///< Windowing function.
+    Frame                        Win;      ///< Frame of CQT windows.
+    std::vector<BasicSlicer<T>>  slicers;  ///< One slicer per channel.
+    std::vector<BasicSplicer<T>> splicers; ///< One splicer per channel.
+    SnapshotTaps                 taps;     ///< Snapshot taps of the channels.
+    bool                         valid = false;
+};
+
+//==========================================================================
+
+/**
+ * @class BasicCqtDenseAnalyzer
+ * @brief Analysis-only counterpart of BasicCqtDenseProcessor: slices,
+ * windows and transforms every hop, and hands the coefficients to
+ * processBlock(), with no synthesis.
+ *
+ * For metering and visualization: there is no inverse transform, no
+ * synthesis window, no splicer and no output buffer, so a hop costs the
+ * forward transform only. processBlock() sees exactly the coefficients the
+ * processor's processBlock() would see for the same input.
+ */
+template <typename T>
+class BasicCqtDenseAnalyzer
+{
+  public:
+    using Cqt           = BasicNsgfCqtDense<T>;        ///< Transform type.
+    using RealArray     = typename Cqt::RealArray;     ///< Sample block type.
+    using ComplexMatrix = typename Cqt::ComplexMatrix; ///< Coefficient type.
 
     /**
-     * @brief Gets the windowing function.
-     * 
-     * @return A constant reference to the windowing function.
+     * @brief Constructs a BasicCqtDenseAnalyzer object (parameters as in
+     * BasicCqtDenseProcessor).
      */
-    const Eigen::ArrayXd& getWindow() const { return win; }
+    BasicCqtDenseAnalyzer(double sampleRate, Eigen::Index numSamples, double fraction,
+                          double minFrequency, double maxFrequency, double refFrequency,
+                          Eigen::Index overlap = 2);
 
     /**
-     * @brief Gets the CQT window for a specific index.
-     * 
-     * @param k The index of the CQT window.
-     * @return A constant reference to the CQT window.
+     * @brief Virtual destructor for safe polymorphic use.
      */
-    const Eigen::ArrayXd& getCqtWindow(Eigen::Index k) const { return Win[k]; }
+    virtual ~BasicCqtDenseAnalyzer() = default;
+
+    /// Analyses a single sample.
+    void processSample(T sample);
+
+    /// Analyses n samples; equivalent to processSample() on each of them.
+    void process(const T* input, Eigen::Index n);
 
     /**
-     * @brief Gets the CQT object.
-     * 
-     * @return A constant reference to the CQT object.
+     * @brief Receives the coefficients of each hop's block.
+     *
+     * @param block The block's coefficients (samples × bands).
      */
-    const NsgfCqtSparse& getCqt() const { return cqt; }
+    virtual void processBlock(const ComplexMatrix& block) = 0;
 
     /**
-     * @brief Gets the latency produced by the processor.
+     * @brief Receives the energy of each band of each hop's block, in
+     * energy-only mode (see setEnergyOnly()). Does nothing by default.
      *
-     * @return Integer number of samples of delay between input and output.
+     * @param energies Sum of |Xcq|² over each band's coefficients.
      */
-    Eigen::Index getLatency() const { return slicer.getBlockSize() + slicer.getHopSize(); }
+    virtual void processEnergies(const RealArray& energies) { (void)energies; }
 
     /**
-     * @brief True when the underlying CQT configuration is valid.
+     * @brief Computes only each band's energy instead of its coefficients.
      *
-     * An invalid processor is inert: processSample() returns 0 (silence)
-     * and never touches its internals. See NsgfCqtCommon::isValid().
+     * When on, each hop calls processEnergies() instead of processBlock()
+     * (and publishes nothing to a snapshot tap). The energies come from the
+     * block's spectrum by Parseval (see NsgfCqtSparse::bandEnergies()): one
+     * real DFT and a weighted sum per band, with no per-band inverse DFT.
      */
-    bool isValid() const { return cqt.isValid(); }
+    void setEnergyOnly(bool on) { energyOnly = on; }
+
+    /// True when hops compute band energies only (see setEnergyOnly()).
+    bool isEnergyOnly() const { return energyOnly; }
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicer.getHopSize(); }
+
+    /// Publishes every hop's coefficients to tap, nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise processBlock() is never called).
+    bool isValid() const { return valid; }
 
   protected:
-    NsgfCqtSparse cqt; ///< The CQT object used for processing.
+    Cqt cqt; ///< The CQT object used for analysis.
 
   private:
-    Eigen::ArrayXd                     xi;      ///< Internal processing variable.
-    DoubleBuffer<NsgfCqtSparse::Coefs> Xcq;     ///< Double buffer for sparse CQT coefficients.
-    DoubleBuffer<NsgfCqtSparse::Coefs> Zcq;     ///< Double buffer for intermediate coefficients.
-    NsgfCqtSparse::Coefs               Ycq;     ///< Intermediate sparse CQT coefficients.
-    Eigen::ArrayXd                     win;     ///< Windowing function.
-    NsgfCqtSparse::Frame               Win;     ///< Frame of CQT windows.
-    Slicer                             slicer;  ///< Slicer for data segmentation.
-    Splicer                            splicer; ///< Splicer for data reconstruction.
+    /// Transforms the block the slicer just completed.
+    void processHop();
+
+    RealArray      xi;       ///< Internal processing variable.
+    RealArray      win;      ///< Windowing function.
+    ComplexMatrix  Xcq;      ///< CQT coefficients.
+    RealArray      energies; ///< Band energies (energy-only mode).
+    BasicSlicer<T> slicer;   ///< Slicer for data segmentation.
+    SnapshotTap*   tap        = nullptr;
+    bool           valid      = false;
+    bool           energyOnly = false;
 };
 
+//==========================================================================
+
+/**
+ * @class BasicCqtSparseAnalyzer
+ * @brief Analysis-only counterpart of BasicCqtSparseProcessor (see
+ * BasicCqtDenseAnalyzer).
+ */
+template <typename T>
+class BasicCqtSparseAnalyzer
+{
+  public:
+    using Cqt       = BasicNsgfCqtSparse<T>;   ///< Transform type.
+    using RealArray = typename Cqt::RealArray; ///< Sample block type.
+    using Coefs     = typename Cqt::Coefs;     ///< Coefficient type.
+
+    /**
+     * @brief Constructs a BasicCqtSparseAnalyzer object (parameters as in
+     * BasicCqtSparseProcessor).
+     */
+    BasicCqtSparseAnalyzer(double sampleRate, Eigen::Index numSamples,
+                           double fraction, double minFrequency,
+                           double maxFrequency, double refFrequency,
+                           SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo, Eigen::Index overlap = 2);
+
+    /**
+     * @brief Virtual destructor for safe polymorphic use.
+     */
+    virtual ~BasicCqtSparseAnalyzer() = default;
+
+    /// Analyses a single sample.
+    void processSample(T sample);
+
+    /// Analyses n samples; equivalent to processSample() on each of them.
+    void process(const T* input, Eigen::Index n);
+
+    /**
+     * @brief Receives the coefficients of each hop's block.
+     *
+     * @param block The block's coefficients, one array per band.
+     */
+    virtual void processBlock(const Coefs& block) = 0;
+
+    /**
+     * @brief Receives the energy of each band of each hop's block, in
+     * energy-only mode (see setEnergyOnly()). Does nothing by default.
+     *
+     * @param energies Sum of |Xcq|² over each band's coefficients.
+     */
+    virtual void processEnergies(const RealArray& energies) { (void)energies; }
+
+    /**
+     * @brief Computes only each band's energy instead of its coefficients.
+     *
+     * When on, each hop calls processEnergies() instead of processBlock()
+     * (and publishes nothing to a snapshot tap). The energies come from the
+     * block's spectrum by Parseval (see NsgfCqtSparse::bandEnergies()): one
+     * real DFT and a weighted sum per band, with no per-band inverse DFT.
+     */
+    void setEnergyOnly(bool on) { energyOnly = on; }
+
+    /// True when hops compute band energies only (see setEnergyOnly()).
+    bool isEnergyOnly() const { return energyOnly; }
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicer.getHopSize(); }
+
+    /// Publishes every hop's coefficients to tap, nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise processBlock() is never called).
+    bool isValid() const { return valid; }
+
+  protected:
+    Cqt cqt; ///< The CQT object used for analysis.
+
+  private:
+    /// Transforms the block the slicer just completed.
+    void processHop();
+
+    RealArray      xi;       ///< Internal processing variable.
+    RealArray      win;      ///< Windowing function.
+    Coefs          Xcq;      ///< Sparse CQT coefficients.
+    RealArray      energies; ///< Band energies (energy-only mode).
+    BasicSlicer<T> slicer;   ///< Slicer for data segmentation.
+    SnapshotTap*   tap        = nullptr;
+    bool           valid      = false;
+    bool           energyOnly = false;
+};
+
+//==========================================================================
+
+/**
+ * @class BasicSlidingCqtDenseAnalyzer
+ * @brief Analysis-only counterpart of BasicSlidingCqtDenseProcessor:
+ * processBlock() receives each hop's overlap-added coefficients, and
+ * nothing is resynthesized (see BasicCqtDenseAnalyzer).
+ */
+template <typename T>
+class BasicSlidingCqtDenseAnalyzer
+{
+  public:
+    using Cqt           = BasicNsgfCqtDense<T>;        ///< Transform type.
+    using RealArray     = typename Cqt::RealArray;     ///< Sample block type.
+    using ComplexMatrix = typename Cqt::ComplexMatrix; ///< Coefficient type.
+
+    /**
+     * @brief Constructs a BasicSlidingCqtDenseAnalyzer object (parameters
+     * as in BasicSlidingCqtDenseProcessor).
+     */
+    BasicSlidingCqtDenseAnalyzer(double sampleRate, Eigen::Index numSamples, double fraction,
+                                 double minFrequency, double maxFrequency, double refFrequency,
+                                 Eigen::Index overlap = 2);
+
+    /**
+     * @brief Virtual destructor for safe polymorphic use.
+     */
+    virtual ~BasicSlidingCqtDenseAnalyzer() = default;
+
+    /// Analyses a single sample.
+    void processSample(T sample);
+
+    /// Analyses n samples; equivalent to processSample() on each of them.
+    void process(const T* input, Eigen::Index n);
+
+    /**
+     * @brief Receives the coefficients of each hop.
+     *
+     * @param block The hop's overlap-added coefficients (hop × bands).
+     */
+    virtual void processBlock(const ComplexMatrix& block) = 0;
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicer.getHopSize(); }
+
+    /// Publishes every hop's coefficients to tap, nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise processBlock() is never called).
+    bool isValid() const { return valid; }
+
+  protected:
+    Cqt cqt; ///< The CQT object used for analysis.
+
+  private:
+    /// Transforms the block the slicer just completed.
+    void processHop();
+
+    RealArray                    xi;     ///< Internal processing variable.
+    HistoryBuffer<ComplexMatrix> Xcq;    ///< CQT coefficients of the last overlap slices.
+    ComplexMatrix                Zcq;    ///< Overlap-added coefficients of the current hop.
+    RealArray                    win;    ///< Windowing function.
+    BasicSlicer<T>               slicer; ///< Slicer for data segmentation.
+    SnapshotTap*                 tap   = nullptr;
+    bool                         valid = false;
+};
+
+//==========================================================================
+
+/**
+ * @class BasicSlidingCqtSparseAnalyzer
+ * @brief Analysis-only counterpart of BasicSlidingCqtSparseProcessor (see
+ * BasicSlidingCqtDenseAnalyzer).
+ */
+template <typename T>
+class BasicSlidingCqtSparseAnalyzer
+{
+  public:
+    using Cqt       = BasicNsgfCqtSparse<T>;   ///< Transform type.
+    using RealArray = typename Cqt::RealArray; ///< Sample block type.
+    using Coefs     = typename Cqt::Coefs;     ///< Coefficient type.
+    using Frame     = typename Cqt::Frame;     ///< Per-band window type.
+
+    /**
+     * @brief Constructs a BasicSlidingCqtSparseAnalyzer object (parameters
+     * as in BasicSlidingCqtSparseProcessor).
+     */
+    BasicSlidingCqtSparseAnalyzer(double sampleRate, Eigen::Index numSamples,
+                                  double fraction, double minFrequency,
+                                  double maxFrequency, double refFrequency,
+                                  SpanPolicy spanPolicy = SpanPolicy::PowerOfTwo, Eigen::Index overlap = 2);
+
+    /**
+     * @brief Virtual destructor for safe polymorphic use.
+     */
+    virtual ~BasicSlidingCqtSparseAnalyzer() = default;
+
+    /// Analyses a single sample.
+    void processSample(T sample);
+
+    /// Analyses n samples; equivalent to processSample() on each of them.
+    void process(const T* input, Eigen::Index n);
+
+    /**
+     * @brief Receives the coefficients of each hop.
+     *
+     * @param block The hop's overlap-added coefficients, one array per band
+     * (band k holds getCqt().getLength(k) / overlap of them).
+     */
+    virtual void processBlock(const Coefs& block) = 0;
+
+    /// Gets the windowing function.
+    const RealArray& getWindow() const { return win; }
+
+    /// Gets the CQT window of band k.
+    const RealArray& getCqtWindow(Eigen::Index k) const { return Win[k]; }
+
+    /// Gets the CQT object.
+    const Cqt& getCqt() const { return cqt; }
+
+    /// Gets the hop size: block size / overlap factor.
+    Eigen::Index getHopSize() const { return slicer.getHopSize(); }
+
+    /// Publishes every hop's coefficients to tap, nullptr detaches (see
+    /// BasicHopDriver::setSnapshotTap()). A setup call.
+    void setSnapshotTap(SnapshotTap* tap, const SnapshotOptions& options = {});
+
+    /// True when the underlying CQT configuration and the overlap factor
+    /// are valid (otherwise processBlock() is never called).
+    bool isValid() const { return valid; }
+
+  protected:
+    Cqt cqt; ///< The CQT object used for analysis.
+
+  private:
+    /// Transforms the block the slicer just completed.
+    void processHop();
+
+    RealArray            xi;     ///< Internal processing variable.
+    HistoryBuffer<Coefs> Xcq;    ///< Sparse CQT coefficients of the last overlap slices.
+    Coefs                Zcq;    ///< Overlap-added coefficients of the current hop.
+    RealArray            win;    ///< Windowing function.
+    Frame                Win;    ///< Frame of CQT windows.
+    BasicSlicer<T>       slicer; ///< Slicer for data segmentation.
+    SnapshotTap*         tap   = nullptr;
+    bool                 valid = false;
+};
+
+//==========================================================================
+
+extern template class BasicHopDriver<float, BasicNsgfCqtDense<float>, BasicNsgfCqtDense<float>::ComplexMatrix>;
+extern template class BasicHopDriver<double, BasicNsgfCqtDense<double>, BasicNsgfCqtDense<double>::ComplexMatrix>;
+extern template class BasicHopDriver<float, BasicNsgfCqtSparse<float>, BasicNsgfCqtSparse<float>::Coefs>;
+extern template class BasicHopDriver<double, BasicNsgfCqtSparse<double>, BasicNsgfCqtSparse<double>::Coefs>;
+extern template class BasicCqtDenseProcessor<float>;
+extern template class BasicCqtDenseProcessor<double>;
+extern template class BasicCqtSparseProcessor<float>;
+extern template class BasicCqtSparseProcessor<double>;
+extern template class BasicSlidingCqtDenseProcessor<float>;
+extern template class BasicSlidingCqtDenseProcessor<double>;
+extern template class BasicSlidingCqtSparseProcessor<float>;
+extern template class BasicSlidingCqtSparseProcessor<double>;
+extern template class BasicMultirateCqtProcessor<float>;
+extern template class BasicMultirateCqtProcessor<double>;
+extern template class BasicMultiChannelCqtDenseProcessor<float>;
+extern template class BasicMultiChannelCqtDenseProcessor<double>;
+extern template class BasicMultiChannelCqtSparseProcessor<float>;
+extern template class BasicMultiChannelCqtSparseProcessor<double>;
+extern template class BasicMultiChannelSlidingCqtDenseProcessor<float>;
+extern template class BasicMultiChannelSlidingCqtDenseProcessor<double>;
+extern template class BasicMultiChannelSlidingCqtSparseProcessor<float>;
+extern template class BasicMultiChannelSlidingCqtSparseProcessor<double>;
+extern template class BasicCqtDenseAnalyzer<float>;
+extern template class BasicCqtDenseAnalyzer<double>;
+extern template class BasicCqtSparseAnalyzer<float>;
+extern template class BasicCqtSparseAnalyzer<double>;
+extern template class BasicSlidingCqtDenseAnalyzer<float>;
+extern template class BasicSlidingCqtDenseAnalyzer<double>;
+extern template class BasicSlidingCqtSparseAnalyzer<float>;
+extern template class BasicSlidingCqtSparseAnalyzer<double>;
+
+using CqtDenseProcessor          = BasicCqtDenseProcessor<double>;
+using CqtSparseProcessor         = BasicCqtSparseProcessor<double>;
+using SlidingCqtDenseProcessor   = BasicSlidingCqtDenseProcessor<double>;
+using SlidingCqtSparseProcessor  = BasicSlidingCqtSparseProcessor<double>;
+using CqtDenseProcessorF         = BasicCqtDenseProcessor<float>;
+using CqtSparseProcessorF        = BasicCqtSparseProcessor<float>;
+using SlidingCqtDenseProcessorF  = BasicSlidingCqtDenseProcessor<float>;
+using SlidingCqtSparseProcessorF = BasicSlidingCqtSparseProcessor<float>;
+using MultirateCqtProcessor      = BasicMultirateCqtProcessor<double>;
+using MultirateCqtProcessorF     = BasicMultirateCqtProcessor<float>;
+
+using MultiChannelCqtDenseProcessor          = BasicMultiChannelCqtDenseProcessor<double>;
+using MultiChannelCqtSparseProcessor         = BasicMultiChannelCqtSparseProcessor<double>;
+using MultiChannelSlidingCqtDenseProcessor   = BasicMultiChannelSlidingCqtDenseProcessor<double>;
+using MultiChannelSlidingCqtSparseProcessor  = BasicMultiChannelSlidingCqtSparseProcessor<double>;
+using MultiChannelCqtDenseProcessorF         = BasicMultiChannelCqtDenseProcessor<float>;
+using MultiChannelCqtSparseProcessorF        = BasicMultiChannelCqtSparseProcessor<float>;
+using MultiChannelSlidingCqtDenseProcessorF  = BasicMultiChannelSlidingCqtDenseProcessor<float>;
+using MultiChannelSlidingCqtSparseProcessorF = BasicMultiChannelSlidingCqtSparseProcessor<float>;
+
+using CqtDenseAnalyzer          = BasicCqtDenseAnalyzer<double>;
+using CqtSparseAnalyzer         = BasicCqtSparseAnalyzer<double>;
+using SlidingCqtDenseAnalyzer   = BasicSlidingCqtDenseAnalyzer<double>;
+using SlidingCqtSparseAnalyzer  = BasicSlidingCqtSparseAnalyzer<double>;
+using CqtDenseAnalyzerF         = BasicCqtDenseAnalyzer<float>;
+using CqtSparseAnalyzerF        = BasicCqtSparseAnalyzer<float>;
+using SlidingCqtDenseAnalyzerF  = BasicSlidingCqtDenseAnalyzer<float>;
+using SlidingCqtSparseAnalyzerF = BasicSlidingCqtSparseAnalyzer<float>;
+
 } // namespace jsa::cicuetea
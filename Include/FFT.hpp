@@ -7,7 +7,7 @@
 
 /**
  * @file FFT.hpp
- * @brief FFT wrapper (the DFT class) over the vDSP / MKL / FFTW / PFFFT backends.
+ * @brief FFT wrapper (the DFT class) over the vDSP / MKL / FFTW / PFFFT / native backends.
  * @author Juan Sierra
  * @date 3/9/25
  * @copyright MIT License
@@ -15,17 +15,43 @@
 
 #pragma once
 
+#include <complex>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <Eigen/Core>
 
 namespace jsa::cicuetea {
 
+template <typename T>
 class DFTImpl;
 
 /**
- * @class DFT
+ * @brief How much time the backend may spend choosing an algorithm when a
+ * DFT is planned (FFTW's planner flags; other backends ignore it).
+ */
+enum class PlanRigor {
+    Estimate, ///< Heuristic choice, no measurement (FFTW_ESTIMATE); the default.
+    Measure,  ///< Times a few candidate algorithms (FFTW_MEASURE).
+    Patient   ///< Times many more candidates (FFTW_PATIENT); slow to plan.
+};
+
+/**
+ * @brief The FFT libraries a DFT can run on, in default-priority order.
+ * Which of them a build contains is chosen in FFTSelection.cmake (see
+ * BasicDFT::getBackends()).
+ */
+enum class DFTBackend {
+    Native, ///< Built-in header-only SIMD FFT (powers of two).
+    MKL,    ///< Intel MKL.
+    PFFFT,  ///< PFFFT.
+    VDSP,   ///< Apple Accelerate (vDSP, powers of two).
+    FFTW    ///< FFTW (GPL).
+};
+
+/**
+ * @class BasicDFT
  * @ingroup SignalProcessing
  * 
  * This is a pImpl based wrapper to other commonly known FFTs like 
@@ -33,23 +59,80 @@ class DFTImpl;
  * - Accelerate
  * - MKL
  * - PFFFT
+ * - the built-in native backend (FFT_Native.h, no external library)
  * 
+ * Several backends can be compiled in at once. Each DFT picks one when it
+ * is constructed: the one the autotuner measured fastest for its size when
+ * there is one (see tune()), otherwise the default backend
+ * (setDefaultBackend()), or the first backend that plans the size when the
+ * default cannot (vDSP and the native backend only do powers of two).
+ *
  * It also provides interfaces for different "versions" of Fourier Transforms
  * like dft and idft (a complex to complex transform), and rdft and irdft (a 
  * real to complex transform). Moreover, it also provides interfaces to process
- * many DFTs when the data is based on a matrix; however it is simply calling
- * the single DFTs repeatedly
+ * many DFTs when the data is based on a matrix: every column is transformed,
+ * as one batched call where the backend has a batched interface (FFTW, MKL)
+ * and as a column loop otherwise (PFFFT, vDSP, native).
+ *
+ * The scalar type T is float or double (the two explicit instantiations,
+ * aliased as DFTF and DFT); every backend plans natively in that precision.
+ *
+ * DFTs of equal size share their backend plans through a process-wide
+ * registry, so constructing one for an already-planned size only allocates
+ * the per-object scratch. Construction and destruction are serialized
+ * internally, so DFTs may be created on any thread; one DFT object must not run transforms on two
+ * threads at once (backends keep scratch in the plan).
+ *
+ * Power-of-two sizes up to getMaxCodeletSize() run the 1-D complex
+ * transforms (and the column loops of the complex matrix overloads) through
+ * fully unrolled codelets instead of the backend, which at those sizes
+ * costs more in call overhead than in arithmetic. A DFT pinned to a backend
+ * never does.
+ *
+ * All planning happens in the constructor and prepareBatch(), never inside
+ * a transform on a prepared shape. With setPlanRigor() above Estimate that
+ * planning measures (milliseconds to seconds per size with FFTW), so build
+ * DFTs, and the transforms and processors that own them, off the audio
+ * thread; loadWisdom() makes repeated measured planning near-instant.
  * 
  * @brief The Wrapper class for other FFTs provided by different libraries
  */
-class DFT
+template <typename T>
+class BasicDFT
 {
   public:
+    using Scalar        = T;                                                     ///< Real sample type.
+    using Complex       = std::complex<T>;                                       ///< Complex sample type.
+    using RealArray     = Eigen::Array<T, Eigen::Dynamic, 1>;                    ///< Real 1D data.
+    using ComplexArray  = Eigen::Array<Complex, Eigen::Dynamic, 1>;              ///< Complex 1D data.
+    using RealMatrix    = Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>;       ///< Real 2D data.
+    using ComplexMatrix = Eigen::Array<Complex, Eigen::Dynamic, Eigen::Dynamic>; ///< Complex 2D data.
+
     /**
      * @brief Constructor.
-     * @param fftSize FFT size (power of two).
+     *
+     * Routes the size to a backend that plans it. When none does (see
+     * isSupported()) it asserts, and in release builds leaves the DFT
+     * unplanned, like the default constructor.
+     *
+     * @param fftSize FFT size: a power of two, or any size nextFastSize()
+     * returns for the complex transforms.
+     */
+    BasicDFT(size_t fftSize);
+
+    /**
+     * @brief Constructs a DFT on a given backend, bypassing the routing.
+     *
+     * The codelets are bypassed too: every transform runs on the backend,
+     * so per-backend comparisons hold at small sizes as well.
+     *
+     * @param fftSize FFT size, as above.
+     * @param backend One of getBackends(). A backend that is not compiled
+     * in, or that cannot plan fftSize (e.g. a power-of-two-only backend and
+     * 80 points), falls back to the routing (and the codelets) of the
+     * size-only constructor; getBackend() tells which one runs.
      */
-    DFT(size_t fftSize);
+    BasicDFT(size_t fftSize, DFTBackend backend);
 
     /**
      * @brief Constructs an unplanned DFT: no backend state is created.
@@ -58,99 +141,236 @@ class DFT
      * NsgfCqtCommon::isValid()) can hold a DFT member without planning one.
      * Calling any transform on an unplanned DFT is undefined.
      */
-    DFT();
+    BasicDFT();
 
     /**
      * @brief Destructor
      */
-    ~DFT();
+    ~BasicDFT();
 
     /**
      * @brief Move constructor
      */
-    DFT(DFT&&) noexcept;
+    BasicDFT(BasicDFT&&) noexcept;
 
     /**
      * @brief Move assignment
      */
-    DFT& operator=(DFT&&) noexcept;
+    BasicDFT& operator=(BasicDFT&&) noexcept;
 
     /**
      * @brief Copy constructor (deleted: a DFT owns backend-specific state)
      */
-    DFT(const DFT&) = delete;
+    BasicDFT(const BasicDFT&) = delete;
 
     /**
      * @brief Copy assignment (deleted: a DFT owns backend-specific state)
      */
-    DFT& operator=(const DFT&) = delete;
+    BasicDFT& operator=(const BasicDFT&) = delete;
 
     /**
      * @brief Computes the Discrete Fourier Transform (DFT) on 1D data.
      * @param X Input array of complex values.
      * @param Y Output array of transformed complex values.
      */
-    void dft(const Eigen::ArrayXcd& X, Eigen::ArrayXcd& Y);
+    void dft(const ComplexArray& X, ComplexArray& Y);
 
     /**
      * @brief Computes the inverse Discrete Fourier Transform (IDFT) on 1D data.
      * @param X Input array of complex values.
      * @param Y Output array of transformed complex values.
      */
-    void idft(const Eigen::ArrayXcd& X, Eigen::ArrayXcd& Y);
+    void idft(const ComplexArray& X, ComplexArray& Y);
 
     /**
      * @brief Computes the forward Real Discrete Fourier Transform (RDFT) on 1D data.
      * @param x Input array of real values.
      * @param X Output array of transformed complex values.
      */
-    void rdft(const Eigen::ArrayXd& x, Eigen::ArrayXcd& X);
+    void rdft(const RealArray& x, ComplexArray& X);
 
     /**
      * @brief Computes the inverse Real Discrete Fourier Transform (IRDFT) on 1D data.
      * @param X Input array of complex values.
      * @param x Output array of transformed real values.
      */
-    void irdft(const Eigen::ArrayXcd& X, Eigen::ArrayXd& x);
+    void irdft(const ComplexArray& X, RealArray& x);
+
+    /**
+     * @brief Plans the batched transforms the matrix overloads run on
+     * matrices of count columns and rows rows (in and out of place).
+     *
+     * The matrix overloads plan each new shape on first use, which
+     * allocates; preparing the shapes ahead keeps those calls real-time safe.
+     * Plans are cached per (kind, count, rows, placement) for the lifetime
+     * of the DFT.
+     */
+    void prepareBatch(Eigen::Index count, Eigen::Index rows);
 
     /**
      * @brief Computes the forward Discrete Fourier Transform (DFT) on 2D data.
      * @param X Input matrix of complex values.
      * @param Y Output matrix of transformed complex values.
      */
-    void dft(const Eigen::ArrayXXcd& X, Eigen::ArrayXXcd& Y);
+    void dft(const ComplexMatrix& X, ComplexMatrix& Y);
 
     /**
      * @brief Computes the inverse Discrete Fourier Transform (IDFT) on 2D data.
      * @param X Input matrix of complex values.
      * @param Y Output matrix of transformed complex values.
      */
-    void idft(const Eigen::ArrayXXcd& X, Eigen::ArrayXXcd& Y);
+    void idft(const ComplexMatrix& X, ComplexMatrix& Y);
 
     /**
      * @brief Computes the forward Real Discrete Fourier Transform (RDFT) on 2D data.
      * @param x Input matrix of real values.
      * @param X Output matrix of transformed complex values.
      */
-    void rdft(const Eigen::ArrayXXd& x, Eigen::ArrayXXcd& X);
+    void rdft(const RealMatrix& x, ComplexMatrix& X);
 
     /**
      * @brief Computes the inverse Real Discrete Fourier Transform (IRDFT) on 2D data.
      * @param X Input matrix of complex values.
      * @param x Output matrix of transformed real values.
      */
-    void irdft(const Eigen::ArrayXXcd& X, Eigen::ArrayXXd& x);
+    void irdft(const ComplexMatrix& X, RealMatrix& x);
 
     /**
-     * @brief gets the name of the currently used backend.
+     * @brief The backend this DFT runs on.
+     */
+    DFTBackend getBackend() const;
+
+    /**
+     * @brief gets the name of the default backend.
      */
     static std::string getName();
 
+    /**
+     * @brief gets the name of a backend ("" when it is not compiled in).
+     */
+    static std::string getName(DFTBackend backend);
+
+    /**
+     * @brief The backends compiled in, in default-priority order.
+     */
+    static std::vector<DFTBackend> getBackends();
+
+    /**
+     * @brief Sets the backend of every DFT of this precision constructed
+     * from now on whose size is not tuned. Process-wide.
+     * @return False (and no change) when the backend is not compiled in.
+     */
+    static bool setDefaultBackend(DFTBackend backend);
+
+    /**
+     * @brief The default backend: initially the first of getBackends().
+     */
+    static DFTBackend getDefaultBackend();
+
+    /**
+     * @brief Smallest size >= n the default backend plans for the complex
+     * transforms with a fast (mixed-radix) algorithm.
+     *
+     * 2^a·3^b·5^c for FFTW and MKL, additionally a multiple of 16 for PFFFT
+     * (its SIMD layout), and a power of two for vDSP (radix-2 setups only) and the native backend.
+     */
+    static size_t nextFastSize(size_t n);
+
+    /**
+     * @brief True when some compiled-in backend plans n, i.e. a DFT of
+     * size n can be constructed whatever the default backend.
+     */
+    static bool isSupported(size_t n);
+
+    /**
+     * @brief Number of distinct plan sets (one per size and rigor) that live
+     * DFTs of this precision currently share.
+     */
+    static size_t getNumSharedPlans();
+
+    /**
+     * @brief Sets the planning rigor of every DFT of this precision
+     * constructed from now on (including the ones the transforms own).
+     * Process-wide; existing DFTs keep their plans.
+     */
+    static void setPlanRigor(PlanRigor rigor);
+
+    static PlanRigor getPlanRigor();
+
+    /**
+     * @brief Merges a wisdom file (plans measured earlier, on this machine)
+     * into the backend's planner, so measured planning of those sizes is
+     * instant. FFTW keeps separate wisdom per precision.
+     * @return True on success; always false for backends without wisdom.
+     */
+    static bool loadWisdom(const std::string& path);
+
+    /**
+     * @brief Writes everything the planner has learned (loaded or measured)
+     * to a wisdom file.
+     * @return True on success; always false for backends without wisdom.
+     */
+    static bool saveWisdom(const std::string& path);
+
+    /**
+     * @brief Times every compiled-in backend that plans each size (all four
+     * transforms, best of three runs) and routes DFTs of that size
+     * constructed from now on to the fastest. Slow: milliseconds per size
+     * and backend, so run it at startup, off the audio thread, or load an
+     * earlier result with loadTuning().
+     */
+    static void tune(const std::vector<size_t>& sizes);
+
+    /**
+     * @brief When enabled, a DFT of a size without a tuned route tunes that
+     * size in its constructor (see tune()). Off by default.
+     */
+    static void setAutoTune(bool enabled);
+
+    static bool getAutoTune();
+
+    /// Forgets every tuned route.
+    static void clearTuning();
+
+    /**
+     * @brief Merges routes written by saveTuning(); routes to backends this
+     * build lacks are skipped.
+     * @return False when the file is missing or is not a tuning file of
+     * this precision.
+     */
+    static bool loadTuning(const std::string& path);
+
+    /**
+     * @brief Writes the tuned routes (one size and backend per line).
+     * @return True on success.
+     */
+    static bool saveTuning(const std::string& path);
+
+    /**
+     * @brief Sets the largest size (at most 64) whose complex transforms
+     * run through the built-in codelets in every DFT of this precision
+     * constructed from now on; 0 sends every size to the backend.
+     */
+    static void setMaxCodeletSize(size_t n);
+
+    static size_t getMaxCodeletSize();
+
   private:
+    using Codelet = void (*)(const Complex*, Complex*); ///< Unrolled transform of one size.
+
     /**
      * @brief Pointer to the implementation of the DFT operations.
      */
-    std::unique_ptr<DFTImpl> pImpl;
+    std::unique_ptr<DFTImpl<T>> pImpl;
+
+    Codelet forwardCodelet = nullptr; ///< Replaces the backend's dft, when set.
+    Codelet inverseCodelet = nullptr; ///< Replaces the backend's idft, when set.
 };
 
+extern template class BasicDFT<float>;
+extern template class BasicDFT<double>;
+
+using DFT  = BasicDFT<double>; ///< Double-precision DFT.
+using DFTF = BasicDFT<float>;  ///< Single-precision DFT.
+
 } // namespace jsa::cicuetea
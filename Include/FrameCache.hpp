@@ -0,0 +1,94 @@
+//
+//  FrameCache.hpp
+//  CQTDSP
+//
+//  Created by Juan Sierra on 6/26/25.
+//
+
+/**
+ * @file FrameCache.hpp
+ * @brief On-disk cache of designed frames, for fast startup
+ * @author Juan Sierra
+ * @date 6/26/25
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameRegistry.hpp"
+
+namespace jsa::cicuetea {
+
+/**
+ * @class FrameCache
+ * @brief Where frame files live, and the file I/O they need.
+ *
+ * Disabled by default. Once setDirectory() names a directory, an
+ * NsgfCqtSparse whose frame is not already in the FrameRegistry looks for
+ * its file there (named by pathFor()) and loads it instead of designing the
+ * frame; on a miss it designs the frame and writes the file for next time.
+ * A file that does not match the configuration exactly (wrong version,
+ * precision, key or size) is ignored and rewritten, never trusted.
+ *
+ * The file format is versioned (see version) and native-endian; it stores
+ * what the design produces (d, spans, atoms, duals, phases, scales), so a
+ * load is a validation plus one copy per array out of a read-only mapping.
+ */
+class FrameCache
+{
+  public:
+    /// Format version; bumped whenever the layout or the design changes.
+    static constexpr std::uint32_t version = 2;
+
+    /// Sets the cache directory ("" disables the cache, the default).
+    static void setDirectory(const std::string& directory);
+
+    static std::string getDirectory();
+
+    /**
+     * @brief File path for a configuration inside the cache directory.
+     * @param key Configuration.
+     * @param kind Frame type tag, e.g. "sparse64" (distinguishes precisions).
+     * @return The path, or "" when the cache is disabled.
+     */
+    static std::string pathFor(const FrameKey& key, const std::string& kind);
+
+    /**
+     * @brief Writes bytes to path atomically (temporary file, then rename),
+     * so a concurrent reader never sees a partial file.
+     * @return True on success.
+     */
+    static bool writeFile(const std::string& path, const std::vector<unsigned char>& bytes);
+
+    /**
+     * @class MappedFile
+     * @brief Read-only view of a whole file: mmap where available, a plain
+     * read into memory otherwise. Empty (data() == nullptr) when the file
+     * cannot be opened.
+     */
+    class MappedFile
+    {
+      public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* data() const { return ptr; }
+        std::size_t          size() const { return len; }
+
+      private:
+        const unsigned char*       ptr    = nullptr; ///< Start of the file contents.
+        std::size_t                len    = 0;       ///< File size in bytes.
+        bool                       mapped = false;   ///< True when ptr is an mmap.
+        std::vector<unsigned char> buffer;           ///< Fallback storage when not mapped.
+    };
+};
+
+} // namespace jsa::cicuetea
@@ -0,0 +1,161 @@
+//
+//  FrameRegistry.hpp
+//  CQTDSP
+//
+//  Created by Juan Sierra on 6/24/25.
+//
+
+/**
+ * @file FrameRegistry.hpp
+ * @brief Process-wide cache of immutable CQT frames, keyed by configuration
+ * @author Juan Sierra
+ * @date 6/24/25
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <Eigen/Core>
+
+namespace jsa::cicuetea {
+
+/**
+ * @struct FrameKey
+ * @brief The constructor parameters that fully determine a frame.
+ *
+ * Compared exactly: two instances share a frame only when they were built
+ * from bit-identical parameters.
+ */
+struct FrameKey {
+    double       fs     = 0; ///< Sampling rate (Hz).
+    Eigen::Index nSamps = 0; ///< Block size.
+    double       frac   = 0; ///< Reciprocal of bands per octave.
+    double       fMin   = 0; ///< Minimum frequency (Hz).
+    double       fMax   = 0; ///< Maximum frequency (Hz).
+    double       fRef   = 0; ///< Reference frequency (Hz).
+    int          spans  = 0; ///< Sparse span policy (SpanPolicy); 0 for dense frames.
+
+    bool operator==(const FrameKey&) const = default;
+};
+
+/**
+ * @class FrameRegistry
+ * @brief Hands out one shared, immutable frame per configuration.
+ *
+ * One registry exists per frame type (dense/sparse × float/double), reached
+ * through instance(). get() returns the frame for a key if any instance
+ * still holds it or the registry retains it, and otherwise builds it with
+ * the supplied callable. Live frames are always shared (they are tracked
+ * weakly); on top of that the registry *retains* the getCapacity() most
+ * recently used frames, so closing and reopening an instance does not
+ * rebuild. Eviction only drops that retaining reference. Capacity 0 keeps
+ * sharing between live instances but retains nothing.
+ *
+ * Thread-safe. Builds run under the registry lock, so concurrent requests
+ * for the same key build it once.
+ *
+ * @tparam Frame The immutable frame type (e.g. NsgfCqtSparse::SharedFrame).
+ */
+template <typename Frame>
+class FrameRegistry
+{
+  public:
+    using FramePtr = std::shared_ptr<const Frame>; ///< Shared, immutable frame.
+
+    /// The process-wide registry for this frame type.
+    static FrameRegistry& instance()
+    {
+        static FrameRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Returns the frame for key, building it with build() on a miss.
+     * @param key Configuration of the frame.
+     * @param build Callable returning a FramePtr (or a convertible pointer).
+     */
+    template <typename Builder>
+    FramePtr get(const FrameKey& key, Builder&& build)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (!(it->key == key)) continue;
+            if (FramePtr frame = it->live.lock()) {
+                entries.splice(entries.begin(), entries, it); // most recent first
+                entries.front().retained = frame;
+                trim();
+                return frame;
+            }
+            entries.erase(it);
+            break;
+        }
+
+        FramePtr frame = build();
+        entries.push_front({key, frame, frame});
+        trim();
+        return frame;
+    }
+
+    /// Sets the maximum number of retained frames, evicting as needed.
+    void setCapacity(std::size_t numFrames)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity = numFrames;
+        trim();
+    }
+
+    std::size_t getCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return capacity;
+    }
+
+    /// Number of frames the registry currently retains (at most getCapacity()).
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t n = 0;
+        for (const auto& e : entries) n += e.retained != nullptr;
+        return n;
+    }
+
+    /// Drops every retained frame and forgets the live ones (instances keep theirs).
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+  private:
+    struct Entry {
+        FrameKey                   key;      ///< Configuration.
+        std::weak_ptr<const Frame> live;     ///< Tracks the frame while anyone holds it.
+        FramePtr                   retained; ///< Registry's own reference (LRU, may be null).
+    };
+
+    FrameRegistry() = default;
+
+    /// Releases retained frames beyond capacity and forgets dead entries.
+    void trim()
+    {
+        std::size_t n = 0;
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (n++ >= capacity) it->retained.reset();
+            if (it->live.expired()) it = entries.erase(it);
+            else ++it;
+        }
+    }
+
+    mutable std::mutex mutex;        ///< Guards entries and capacity.
+    std::list<Entry>   entries;      ///< Most recently used first.
+    std::size_t        capacity = 4; ///< Maximum retained frames.
+};
+
+} // namespace jsa::cicuetea
@@ -0,0 +1,75 @@
+//
+//  HistoryBuffer.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/8/25.
+//
+
+/**
+ * @file HistoryBuffer.h
+ * @brief The last n values of a sequence, newest first; DoubleBuffer for
+ * any depth
+ * @author Juan Sierra
+ * @date 7/8/25
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+namespace jsa::cicuetea {
+
+/**
+ * @class HistoryBuffer
+ * @brief A fixed-depth history of preallocated values.
+ *
+ * (*this)[0] is the current value and (*this)[age] the one age steps back.
+ * advance() recycles the oldest slot as the new current one without moving
+ * or reallocating anything, so values can be large Eigen objects.
+ *
+ * @tparam T The type of the values stored in the buffer.
+ */
+template <typename T>
+class HistoryBuffer
+{
+  public:
+    /**
+     * @brief Sets the depth to n and every slot to value.
+     */
+    void fill(const T& value, size_t n)
+    {
+        assert(n > 0);
+        buffer.assign(n, value);
+        head = 0;
+    }
+
+    /**
+     * @brief Makes the oldest slot the current one (its content is stale
+     * until overwritten).
+     */
+    void advance() { head = head == 0 ? buffer.size() - 1 : head - 1; }
+
+    /// The value age steps back (0 = current), age < size().
+    T& operator[](size_t age) { return buffer[slot(age)]; }
+
+    /// The value age steps back (0 = current), age < size().
+    const T& operator[](size_t age) const { return buffer[slot(age)]; }
+
+    /// The depth.
+    size_t size() const { return buffer.size(); }
+
+  private:
+    size_t slot(size_t age) const
+    {
+        assert(age < buffer.size());
+        size_t i = head + age;
+        return i < buffer.size() ? i : i - buffer.size();
+    }
+
+    std::vector<T> buffer;   ///< The slots.
+    size_t         head = 0; ///< Slot of the current value.
+};
+
+} // namespace jsa::cicuetea
@@ -50,6 +50,30 @@ inline constexpr size_t nextPow2(size_t x)
     return x + 1;
 }
 
+/**
+ * @brief Computes the smallest 5-smooth number (2^a·3^b·5^c) greater than or
+ * equal to the given number that is also a multiple of m.
+ *
+ * These are the sizes mixed-radix FFTs handle at close to power-of-two
+ * speed; the gaps between them are much smaller than between powers of two
+ * (e.g. 65 rounds up to 72 rather than 128).
+ *
+ * @param x The input value.
+ * @param m Required factor, itself 5-smooth (e.g. 2 for even sizes).
+ * @return The next multiple of m at or above `x` (at least m) that is 5-smooth.
+ */
+inline constexpr size_t nextSmooth(size_t x, size_t m = 1)
+{
+    size_t n = x <= m ? m : (x + m - 1) / m * m;
+    for (;; n += m) {
+        size_t r = n;
+        while (r % 2 == 0) r /= 2;
+        while (r % 3 == 0) r /= 3;
+        while (r % 5 == 0) r /= 5;
+        if (r == 1) return n;
+    }
+}
+
 /**
  * @brief Constrains an index to fit within the bounds of a given size by
  * wrapping it around.
@@ -126,4 +150,25 @@ inline Eigen::ArrayXd logspace(double start, double end, Eigen::Index num)
     return Eigen::ArrayXd::LinSpaced(num, std::log(start), std::log(end)).exp();
 }
 
+/**
+ * @brief Modified Bessel function of the first kind, order zero.
+ *
+ * Evaluated from its power series Σ ((x/2)^k / k!)², which converges for
+ * every x and is accurate to double precision for the arguments window
+ * design needs (|x| ≲ 20).
+ *
+ * @param x The argument.
+ * @return I0(x).
+ */
+inline double besselI0(double x)
+{
+    double sum  = 1;
+    double term = 1;
+    for (int k = 1; k < 64 && term > 1e-17 * sum; k++) {
+        term *= square(x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
 } // namespace jsa::cicuetea
@@ -7,7 +7,7 @@
 
 /**
  * @file SignalUtils.h
- * @brief Signal utilities: window functions.
+ * @brief Signal utilities: window functions and filter design.
  * @author Juan Sierra
  * @date 3/23/25
  * @copyright MIT License
@@ -38,4 +38,48 @@ inline Eigen::ArrayXd hann(Eigen::Index N)
     return win;
 }
 
+/**
+ * @brief sqrt-Hann window of length N normalized for weighted overlap-add
+ * at hop N/overlap: used as both analysis and synthesis window, the squares
+ * of its shifts by the hop sum to exactly one.
+ *
+ * Shifts of the periodic Hann window by N/R sum to R/2 for any whole R ≥ 2,
+ * so the window is sqrt(hann(N)·2/R); at R = 2 it is the plain sqrt-Hann.
+ *
+ * @param N Window length (a multiple of overlap).
+ * @param overlap Overlap factor R = N / hop (≥ 2).
+ */
+inline Eigen::ArrayXd wolaWindow(Eigen::Index N, Eigen::Index overlap)
+{
+    assert(overlap >= 2 && N % overlap == 0);
+    return (hann(N) * (2.0 / double(overlap))).sqrt();
+}
+
+/**
+ * @brief Kaiser-windowed half-band lowpass FIR of 2D + 1 taps (cutoff fs/4).
+ *
+ * h[D] = 1/2 and every other odd-offset tap is exactly zero, so filtering
+ * around a factor-2 decimation or interpolation only needs the D + 1 taps
+ * h[0], h[2], ..., h[2D]. D must be odd for that layout (the centre tap then
+ * sits on an odd index, between the even ones).
+ *
+ * @param D Group delay in samples (odd).
+ * @param beta Kaiser shape: larger trades a wider transition for a deeper stopband.
+ * @return The 2D + 1 taps, linear phase (symmetric about D).
+ */
+inline Eigen::ArrayXd halfBand(Eigen::Index D, double beta)
+{
+    assert(D > 0 && D % 2 == 1);
+    Eigen::ArrayXd h(2 * D + 1);
+    for (Eigen::Index j = 0; j <= 2 * D; j++) {
+        double t = double(j - D);
+        double r = t / double(D);
+        double w = besselI0(beta * std::sqrt(1 - r * r)) / besselI0(beta);
+        h(j)     = j == D ? 0.5 : std::sin(std::numbers::pi * t / 2) / (std::numbers::pi * t) * w;
+    }
+    for (Eigen::Index j = 1; j <= 2 * D; j += 2)
+        if (j != D) h(j) = 0; // exact zeros, not sin(kπ) rounding
+    return h;
+}
+
 } // namespace jsa::cicuetea
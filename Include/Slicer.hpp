@@ -27,10 +27,16 @@ namespace jsa::cicuetea {
  * samples and divide it into fixed-size blocks with a specified overlap. 
  * This is useful for applications such as audio processing, feature extraction, 
  * and time-domain analysis.
+ *
+ * Templated on the sample type T (float or double; aliased as SlicerF and
+ * Slicer).
  */
-class Slicer
+template <typename T>
+class BasicSlicer
 {
   public:
+    using RealArray = Eigen::Array<T, Eigen::Dynamic, 1>; ///< Sample block type.
+
     /**
      * @brief Slicer constructor that sets the block size and hop size for slicing.
      *
@@ -42,14 +48,33 @@ class Slicer
      * @param newBlockSize The size of each block in samples.
      * @param newHopSize The hop size (step size) between consecutive blocks in samples.
      */
-    Slicer(Eigen::Index newBlockSize, Eigen::Index newHopSize);
+    BasicSlicer(Eigen::Index newBlockSize, Eigen::Index newHopSize);
 
     /**
      * @brief Pushes a single sample into the internal buffer.
      * 
      * @param sample The sample value to be added to the buffer.
      */
-    void pushSample(double sample);
+    void pushSample(T sample);
+
+    /**
+     * @brief Pushes n consecutive samples with block copies.
+     *
+     * Equivalent to n pushSample() calls, as long as no block becomes
+     * available before the last sample: n must not exceed
+     * getSamplesToBlock().
+     *
+     * @param samples The samples to be added to the buffer.
+     * @param n Number of samples.
+     */
+    void pushSamples(const T* samples, Eigen::Index n);
+
+    /**
+     * @brief Number of samples to push until the next block is available.
+     *
+     * @return A count in [1, hopSize].
+     */
+    Eigen::Index getSamplesToBlock() const { return hopSize - Eigen::Index(wp % size_t(hopSize)); }
 
     /**
      * @brief Checks if a complete block is available for retrieval.
@@ -59,13 +84,13 @@ class Slicer
     bool hasBlock();
 
     /**
-     * @brief Retrieves the next available block as a read-only Eigen::ArrayXd.
+     * @brief Retrieves the next available block as a read-only array.
      * 
-     * @return An Eigen::Map<const Eigen::ArrayXd> representing the block.
+     * @return An Eigen::Map<const RealArray> representing the block.
      * @note This function assumes that a block is available. Ensure `hasBlock()` 
      *       returns true before calling this function.
      */
-    Eigen::Map<const Eigen::ArrayXd> getBlock();
+    Eigen::Map<const RealArray> getBlock();
 
     /**
      * @brief Gets the current block size.
@@ -96,7 +121,7 @@ class Slicer
     Eigen::Index getBufferSize() const { return bufferSize; }
 
   private:
-    Eigen::ArrayXd buffer;      ///< Internal buffer for storing samples.
+    RealArray      buffer;      ///< Internal buffer for storing samples.
     Eigen::Index   bufferSize;  ///< Size of the internal buffer in samples.
     Eigen::Index   blockSize;   ///< Size of each block in samples.
     Eigen::Index   overlapSize; ///< Overlap size between consecutive blocks in samples.
@@ -105,4 +130,10 @@ class Slicer
     size_t         rp = 0;      ///< Read pointer for the buffer.
 };
 
+extern template class BasicSlicer<float>;
+extern template class BasicSlicer<double>;
+
+using Slicer  = BasicSlicer<double>; ///< Double-precision slicer.
+using SlicerF = BasicSlicer<float>;  ///< Single-precision slicer.
+
 } // namespace jsa::cicuetea
@@ -0,0 +1,220 @@
+//
+//  SnapshotTap.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/12/25.
+//
+
+/**
+ * @file SnapshotTap.h
+ * @brief Hands the latest coefficient frame from the audio thread to a
+ * reader thread (a spectrogram, a meter) without locks
+ * @author Juan Sierra
+ * @date 7/12/25
+ * @copyright MIT License
+ *
+ * A triple buffer: the writer fills its own slot and swaps it with the
+ * shared middle one, and the reader swaps the middle slot with its own when
+ * the middle holds a newer frame. Both swaps are a single atomic exchange,
+ * so neither side waits, the writer never allocates, and a slow reader only
+ * skips frames.
+ *
+ * Frames are always single precision and, by default, magnitudes: the
+ * reader rarely wants the phase, and a float magnitude is a quarter of a
+ * double complex. Each band can also be resampled to a fixed number of
+ * frames, so a display gets the same grid from dense and sparse transforms.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace jsa::cicuetea {
+
+/**
+ * @brief What a SnapshotTap publishes (see BasicHopDriver::setSnapshotTap()).
+ */
+struct SnapshotOptions {
+    bool         magnitude = true; ///< Publish |X| (the peak of each group of samples) instead of X.
+    Eigen::Index frames    = 0;    ///< Frames per band; 0 = the longest band's length.
+};
+
+/**
+ * @class SnapshotTap
+ * @brief Latest-frame mailbox between one writer thread (the processor's
+ * hop work) and one reader thread; every call is wait-free.
+ */
+class SnapshotTap
+{
+  public:
+    /**
+     * @struct Snapshot
+     * @brief One published frame: frames × bands, like the coefficients.
+     */
+    struct Snapshot {
+        Eigen::ArrayXXf  magnitude; ///< |X| per frame and band (magnitude taps; empty otherwise).
+        Eigen::ArrayXXcf coefs;     ///< X per frame and band (complex taps; empty otherwise).
+        uint64_t         index = 0; ///< Number of frames published up to this one (0: none yet).
+    };
+
+    /**
+     * @brief Sizes the tap for coefficients shaped like like (a dense
+     * matrix or sparse per-band coefficients). Allocates and resets: call
+     * while neither thread uses the tap.
+     */
+    template <typename Block>
+    void configure(const Block& like, const SnapshotOptions& options)
+    {
+        opts    = options;
+        nBands  = numBands(like);
+        nFrames = options.frames;
+        if (nFrames <= 0) {
+            nFrames = 0;
+            for (Eigen::Index k = 0; k < nBands; k++) nFrames = std::max(nFrames, Eigen::Index(band(like, k).size()));
+        }
+        for (auto& s : slots) {
+            s.magnitude = opts.magnitude ? Eigen::ArrayXXf::Zero(nFrames, nBands) : Eigen::ArrayXXf();
+            s.coefs     = opts.magnitude ? Eigen::ArrayXXcf() : Eigen::ArrayXXcf::Zero(nFrames, nBands);
+            s.index     = 0;
+        }
+        back      = 0;
+        front     = 1;
+        published = 0;
+        middle.store(2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Writer: publishes X as the latest frame. Real-time safe.
+     *
+     * @param X Coefficients shaped as at configure().
+     */
+    template <typename Block>
+    void publish(const Block& X)
+    {
+        assert(numBands(X) == nBands);
+        Snapshot& s = slots[back];
+        for (Eigen::Index k = 0; k < nBands; k++) resample(band(X, k), s, k);
+        s.index = ++published;
+        back    = middle.exchange(uint8_t(back | fresh), std::memory_order_acq_rel) & slotMask;
+    }
+
+    /// Reader: makes the newest published frame latest(); false when
+    /// nothing was published since the last pull().
+    bool pull()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & fresh)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & slotMask;
+        return true;
+    }
+
+    /// Reader: the frame of the last successful pull() (zeros before any).
+    const Snapshot& latest() const { return slots[front]; }
+
+    /// Number of bands per frame.
+    Eigen::Index getNumBands() const { return nBands; }
+
+    /// Number of frames per band.
+    Eigen::Index getNumFrames() const { return nFrames; }
+
+    /// The options of the last configure().
+    const SnapshotOptions& getOptions() const { return opts; }
+
+  private:
+    static constexpr uint8_t fresh    = 4; ///< Middle slot holds a frame the reader has not taken.
+    static constexpr uint8_t slotMask = 3;
+
+    template <typename Derived>
+    static Eigen::Index numBands(const Eigen::ArrayBase<Derived>& X) { return X.cols(); }
+
+    template <typename Band>
+    static Eigen::Index numBands(const std::vector<Band>& X) { return Eigen::Index(X.size()); }
+
+    template <typename Derived>
+    static auto band(const Eigen::ArrayBase<Derived>& X, Eigen::Index k) { return X.col(k); }
+
+    template <typename Band>
+    static const Band& band(const std::vector<Band>& X, Eigen::Index k) { return X[size_t(k)]; }
+
+    /// Resamples one band of L samples onto column k of s: frame r covers
+    /// samples [rL/F, (r+1)L/F), at least one.
+    template <typename Band>
+    void resample(const Band& x, Snapshot& s, Eigen::Index k) const
+    {
+        Eigen::Index L = x.size();
+        for (Eigen::Index r = 0; r < nFrames; r++) {
+            if (L == 0) {
+                if (opts.magnitude) s.magnitude(r, k) = 0;
+                else s.coefs(r, k) = 0;
+                continue;
+            }
+            Eigen::Index b = r * L / nFrames;
+            Eigen::Index e = std::max(b + 1, (r + 1) * L / nFrames);
+            if (opts.magnitude) {
+                float m = 0;
+                for (Eigen::Index i = b; i < e; i++) m = std::max(m, float(std::abs(x(i))));
+                s.magnitude(r, k) = m;
+            } else {
+                s.coefs(r, k) = std::complex<float>(x(b));
+            }
+        }
+    }
+
+    std::array<Snapshot, 3>          slots;
+    SnapshotOptions                  opts;
+    Eigen::Index                     nBands    = 0;
+    Eigen::Index                     nFrames   = 0;
+    uint8_t                          back      = 0; ///< Writer's slot.
+    uint8_t                          front     = 1; ///< Reader's slot.
+    uint64_t                         published = 0; ///< Writer: frames published.
+    alignas(64) std::atomic<uint8_t> middle{2};     ///< Shared slot, | fresh when unread.
+};
+
+/**
+ * @class SnapshotTaps
+ * @brief One optional SnapshotTap per channel, for the multi-channel
+ * processors (see BasicHopDriver::setSnapshotTap()).
+ */
+class SnapshotTaps
+{
+  public:
+    /// No tap on any of numChannels channels.
+    explicit SnapshotTaps(size_t numChannels) : taps(numChannels, nullptr) {}
+
+    /**
+     * @brief Attaches tap to channel (nullptr detaches) and configures it
+     * for that channel's entry of like. Allocates: a setup call.
+     *
+     * @param channel Channel index.
+     * @param tap The tap, or nullptr.
+     * @param like Coefficients of every channel, shaped as published.
+     * @param options What the tap publishes.
+     */
+    template <typename MultiBlock>
+    void attach(Eigen::Index channel, SnapshotTap* tap, const MultiBlock& like, const SnapshotOptions& options)
+    {
+        assert(channel >= 0 && size_t(channel) < taps.size());
+        taps[size_t(channel)] = tap;
+        if (tap) tap->configure(like[size_t(channel)], options);
+    }
+
+    /// Writer: publishes X[c] to channel c's tap, for every attached tap.
+    template <typename MultiBlock>
+    void publish(const MultiBlock& X)
+    {
+        for (size_t c = 0; c < taps.size(); c++)
+            if (taps[c]) taps[c]->publish(X[c]);
+    }
+
+  private:
+    std::vector<SnapshotTap*> taps; ///< Null where a channel has no tap.
+};
+
+} // namespace jsa::cicuetea
@@ -26,10 +26,16 @@ namespace jsa::cicuetea {
  *
  * The `Splicer` class provides functionality to set block sizes, push audio blocks into a buffer,
  * and retrieve individual samples while maintaining overlap and hop size constraints.
+ *
+ * Templated on the sample type T (float or double; aliased as SplicerF and
+ * Splicer).
  */
-class Splicer
+template <typename T>
+class BasicSplicer
 {
   public:
+    using RealArray = Eigen::Array<T, Eigen::Dynamic, 1>; ///< Sample block type.
+
     /**
      * @brief Constructor sets the block size and hop size for the splicer.
      *
@@ -41,21 +47,31 @@ class Splicer
      * @param newBlockSize The size of the audio block.
      * @param newHopSize The hop size (step size) between consecutive blocks.
      */
-    Splicer(Eigen::Index newBlockSize, Eigen::Index newHopSize);
+    BasicSplicer(Eigen::Index newBlockSize, Eigen::Index newHopSize);
 
     /**
      * @brief Pushes a new audio block into the buffer.
      *
-     * @param block An Eigen array representing the audio block to be added.
+     * @param block An Eigen array representing the audio block to be added
+     * (a RealArray, or a contiguous column of a matrix, without a copy).
      */
-    void pushBlock(const Eigen::ArrayXd& block);
+    void pushBlock(const Eigen::Ref<const RealArray>& block);
 
     /**
      * @brief Retrieves the next sample from the buffer.
      *
-     * @return A double representing the next audio sample.
+     * @return The next audio sample.
+     */
+    T getSample();
+
+    /**
+     * @brief Retrieves the next n samples with block copies; equivalent to
+     * n getSample() calls.
+     *
+     * @param samples Destination of the samples.
+     * @param n Number of samples.
      */
-    double getSample();
+    void getSamples(T* samples, Eigen::Index n);
 
     /**
      * @brief Gets the current block size.
@@ -86,7 +102,7 @@ class Splicer
     Eigen::Index getBufferSize() const { return bufferSize; }
 
   private:
-    Eigen::ArrayXd buffer;      ///< The internal buffer for storing audio data.
+    RealArray      buffer;      ///< The internal buffer for storing audio data.
     Eigen::Index   bufferSize;  ///< The size of the internal buffer.
     Eigen::Index   blockSize;   ///< The size of the audio block.
     Eigen::Index   overlapSize; ///< The size of the overlap between consecutive blocks.
@@ -95,4 +111,10 @@ class Splicer
     size_t         rp = 0;      ///< The read pointer for the buffer.
 };
 
+extern template class BasicSplicer<float>;
+extern template class BasicSplicer<double>;
+
+using Splicer  = BasicSplicer<double>; ///< Double-precision splicer.
+using SplicerF = BasicSplicer<float>;  ///< Single-precision splicer.
+
 } // namespace jsa::cicuetea
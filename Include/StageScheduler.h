@@ -0,0 +1,98 @@
+//
+//  StageScheduler.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/9/25.
+//
+
+/**
+ * @file StageScheduler.h
+ * @brief Spreads a fixed sequence of work stages over the samples of a hop
+ * @author Juan Sierra
+ * @date 7/9/25
+ * @copyright MIT License
+ *
+ * The amortized processors (see BasicHopDriver::setAmortized())
+ * split the work of one hop into stages: the full-length FFTs, each band's
+ * FFT, and processBlock(). They run those stages while the next hop's
+ * samples stream in. Each stage has an estimated cost, and after s of the
+ * hop's samples every stage whose cumulative cost is within s/hop of the
+ * total has run. The work per sample therefore tracks the average, and the
+ * worst callback carries at most one stage more than its share.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace jsa::cicuetea {
+
+/**
+ * @class StageScheduler
+ * @brief Runs stages 0, 1, ... of a job in proportion to elapsed samples.
+ */
+class StageScheduler
+{
+  public:
+    /**
+     * @brief Sets the stage costs and the number of samples a job is spread
+     * over. Allocates: call at setup. Leaves no job pending.
+     *
+     * @param costs Estimated cost of each stage (any unit, all ≥ 0).
+     * @param samples Samples over which one job is spread (the hop size).
+     */
+    void configure(const std::vector<double>& costs, Eigen::Index samples)
+    {
+        cumulative.resize(costs.size());
+        double sum = 0;
+        for (size_t i = 0; i < costs.size(); i++) cumulative[i] = sum += costs[i];
+        total   = sum;
+        span    = samples;
+        next    = cumulative.size();
+        elapsed = 0;
+    }
+
+    /// Starts a job: every stage pending, no samples elapsed.
+    void start()
+    {
+        next    = 0;
+        elapsed = 0;
+    }
+
+    /// Drops the pending job, if any.
+    void clear() { next = cumulative.size(); }
+
+    /**
+     * @brief Accounts n more samples and runs every stage now due, by
+     * calling run(i) in stage order. All stages are due once the job's
+     * samples have elapsed.
+     */
+    template <typename Run>
+    void advance(Eigen::Index n, Run&& run)
+    {
+        elapsed += n;
+        double due = elapsed >= span ? total : total * double(elapsed) / double(span);
+        while (next < cumulative.size() && cumulative[next] <= due) run(next++);
+    }
+
+    /// Runs every pending stage.
+    template <typename Run>
+    void finish(Run&& run)
+    {
+        while (next < cumulative.size()) run(next++);
+    }
+
+    /// Number of stages.
+    size_t size() const { return cumulative.size(); }
+
+  private:
+    std::vector<double> cumulative;  ///< Cost of stages 0..i.
+    double              total   = 0; ///< Cost of the whole job.
+    Eigen::Index        span    = 1; ///< Samples per job.
+    Eigen::Index        elapsed = 0; ///< Samples since start().
+    size_t              next    = 0; ///< First pending stage.
+};
+
+} // namespace jsa::cicuetea
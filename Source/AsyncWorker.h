@@ -0,0 +1,250 @@
+//
+//  AsyncWorker.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/10/25.
+//
+
+/**
+ * @file AsyncWorker.h
+ * @brief Runs a processor's hop work on a dedicated thread behind two
+ *        lock-free single-producer/single-consumer sample rings
+ * @author Juan Sierra
+ * @date 7/10/25
+ * @copyright MIT License
+ *
+ * The audio thread only copies: process() pushes the input into one ring,
+ * wakes the worker and pops the output from the other. The worker drains
+ * the input ring through the processor's synchronous path (slicer, hop
+ * work, splicer) and pushes what comes out. Output sample t of the audio
+ * thread is the worker's output sample t - latency, so the worker has the
+ * latency, minus the host buffer, to finish a hop.
+ *
+ * A deadline miss is output that has not arrived when the audio thread
+ * needs it. The audio thread plays silence in its place, counts the miss,
+ * and discards those samples when they arrive, so the alignment stays
+ * fixed. If the input ring overflows because the worker has stalled, the
+ * dropped input's output can only have been late too, so the debt shrinks
+ * by the same count.
+ *
+ * Waking the worker is an atomic increment plus notify_one() (a futex wake
+ * where the platform has one): no lock and no allocation on the audio thread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+
+#include <Eigen/Core>
+
+namespace jsa::cicuetea {
+
+/**
+ * @class SpscRing
+ * @brief Fixed-capacity sample FIFO for exactly one producer and one
+ * consumer thread; every call is wait-free.
+ */
+template <typename T>
+class SpscRing
+{
+  public:
+    /// Sizes the ring to at least capacity samples (rounded up to a power of two).
+    explicit SpscRing(size_t capacity)
+    {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        buf.assign(n, T(0));
+        mask = n - 1;
+    }
+
+    /// Producer: appends up to n samples; returns how many fit.
+    size_t push(const T* src, size_t n)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        n        = std::min(n, buf.size() - (h - t));
+        for (size_t i = 0; i < n; i++) buf[(h + i) & mask] = src[i];
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Consumer: removes up to n samples into dst (nullptr: discards them);
+    /// returns how many there were.
+    size_t pop(T* dst, size_t n)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        n        = std::min(n, h - t);
+        if (dst)
+            for (size_t i = 0; i < n; i++) dst[i] = buf[(t + i) & mask];
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Producer: free space.
+    size_t space() const { return buf.size() - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire)); }
+
+    /// Capacity in samples.
+    size_t capacity() const { return buf.size(); }
+
+  private:
+    std::vector<T>                  buf;
+    size_t                          mask = 0;
+    alignas(64) std::atomic<size_t> head{0}; ///< Written by the producer only.
+    alignas(64) std::atomic<size_t> tail{0}; ///< Written by the consumer only.
+};
+
+/**
+ * @class AsyncWorker
+ * @brief A worker thread running run(in, out, n) on the samples the audio
+ * thread hands over, at a fixed extra latency.
+ */
+template <typename T>
+class AsyncWorker
+{
+  public:
+    using Run = std::function<void(const T*, T*, Eigen::Index)>;
+
+    /**
+     * @brief Starts the worker. Allocates and spawns a thread: not real-time safe.
+     *
+     * @param run The synchronous processing path; called on the worker only.
+     * @param latency Extra latency in samples (> 0).
+     * @param blockSize The processor's block size (sizes the rings).
+     * @param cpu CPU to pin the worker to, or -1 (Linux only).
+     * @param realtime Request SCHED_FIFO for the worker (POSIX only).
+     * Pinning and scheduling are best effort: refused requests are ignored.
+     */
+    AsyncWorker(Run run, Eigen::Index latency, Eigen::Index blockSize, int cpu, bool realtime) :
+        run(std::move(run)),
+        latency(latency),
+        in(size_t(4 * (latency + blockSize))),
+        out(in.capacity()),
+        chunk(in.capacity() / 4),
+        inScratch(chunk),
+        outScratch(chunk),
+        owed(-latency)
+    {
+        thread = std::thread([this] { loop(); });
+        configure(cpu, realtime);
+    }
+
+    ~AsyncWorker()
+    {
+        quit.store(true, std::memory_order_release);
+        wake();
+        thread.join();
+    }
+
+    AsyncWorker(const AsyncWorker&)            = delete;
+    AsyncWorker& operator=(const AsyncWorker&) = delete;
+
+    /// Audio thread: hands n input samples over and fills n output samples.
+    void process(const T* input, T* output, Eigen::Index n)
+    {
+        while (n > 0) {
+            Eigen::Index len = std::min<Eigen::Index>(n, Eigen::Index(chunk));
+            exchange(input, output, len);
+            input += len;
+            output += len;
+            n -= len;
+        }
+    }
+
+    /// Extra latency in samples.
+    Eigen::Index getLatency() const { return latency; }
+
+    /// Number of process() chunks that played silence for late output.
+    Eigen::Index getDeadlineMisses() const { return misses.load(std::memory_order_relaxed); }
+
+  private:
+    /// One process() chunk: at most a quarter of the ring, so an overflow
+    /// can only happen with at least that much output already late.
+    void exchange(const T* input, T* output, Eigen::Index n)
+    {
+        owed -= n - Eigen::Index(in.push(input, size_t(n)));
+        wake();
+
+        bool         late = false;
+        Eigen::Index i    = 0;
+        if (owed < 0) {
+            Eigen::Index k = std::min(-owed, n);
+            std::fill(output, output + k, T(0));
+            owed += k;
+            i += k;
+        }
+        if (owed > 0) owed -= Eigen::Index(out.pop(nullptr, size_t(owed)));
+        if (owed == 0) i += Eigen::Index(out.pop(output + i, size_t(n - i)));
+        if (i < n) {
+            std::fill(output + i, output + n, T(0));
+            owed += n - i;
+            late = true;
+        }
+        if (late) misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void wake()
+    {
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+    }
+
+    void loop()
+    {
+        for (;;) {
+            uint32_t seen = signal.load(std::memory_order_acquire);
+            if (quit.load(std::memory_order_acquire)) return;
+            for (;;) {
+                size_t n = in.pop(inScratch.data(), std::min(chunk, out.space()));
+                if (n == 0) break;
+                run(inScratch.data(), outScratch.data(), Eigen::Index(n));
+                out.push(outScratch.data(), n);
+            }
+            signal.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    void configure([[maybe_unused]] int cpu, [[maybe_unused]] bool realtime)
+    {
+#if defined(__linux__)
+        if (cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+        }
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+        if (realtime) {
+            sched_param param{};
+            param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+            pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+        }
+#endif
+    }
+
+    Run                       run;        ///< Synchronous processing path.
+    Eigen::Index              latency;    ///< Extra latency in samples.
+    SpscRing<T>               in;         ///< Audio thread → worker.
+    SpscRing<T>               out;        ///< Worker → audio thread.
+    size_t                    chunk;      ///< Largest exchange, in samples.
+    std::vector<T>            inScratch;  ///< Worker's input chunk.
+    std::vector<T>            outScratch; ///< Worker's output chunk.
+    Eigen::Index              owed;       ///< Audio thread: late samples to discard (< 0: silence still to play).
+    std::atomic<Eigen::Index> misses{0};  ///< Chunks that played silence for late output.
+    std::atomic<uint32_t>     signal{0};  ///< Bumped to wake the worker.
+    std::atomic<bool>         quit{false};
+    std::thread               thread;
+};
+
+} // namespace jsa::cicuetea
@@ -6,20 +6,77 @@
 //
 
 #include "CQT.hpp"
+#include "FrameCache.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <numbers>
+#include <thread>
 
 #include "MathUtils.h"
 #include "RTChecker.h"
+#include "ThreadPool.h"
 
 using namespace jsa::cicuetea;
 using namespace Eigen;
 
-NsgfCqtCommon::BandInfo NsgfCqtCommon::computeBandInfo(double frac, double fMin,
-                                                        double fMax, double fRef)
+namespace {
+/// Fixed-size head of a frame file (FrameCache format); the arrays follow.
+struct FrameFileHeader {
+    char          magic[8];   ///< "CQTFRAME".
+    std::uint32_t version;    ///< FrameCache::version.
+    std::uint32_t endianTag;  ///< 0x01020304 as written by this machine.
+    std::uint32_t scalarSize; ///< sizeof(T) of atoms, phases and scales.
+    std::uint32_t ok;         ///< Frame health.
+    std::int32_t  spans;      ///< FrameKey::spans (SpanPolicy).
+    double        fs, frac, fMin, fMax, fRef;
+    std::int64_t  nSamps, nBands, nFreqs, totalLen;
+};
+
+constexpr char          frameMagic[8] = {'C', 'Q', 'T', 'F', 'R', 'A', 'M', 'E'};
+constexpr std::uint32_t endianTag     = 0x01020304;
+
+/// Appends the raw bytes of n objects to a byte buffer.
+template <typename V>
+void putBytes(std::vector<unsigned char>& out, const V* src, Index n)
+{
+    auto at = out.size();
+    out.resize(at + sizeof(V) * size_t(n));
+    if (n > 0) std::memcpy(out.data() + at, src, sizeof(V) * size_t(n));
+}
+
+/// Bounds-checked sequential reader over a mapped file.
+class ByteReader
+{
+  public:
+    ByteReader(const unsigned char* data, size_t size) : ptr(data), left(size) {}
+
+    template <typename V>
+    bool get(V* dst, Index n)
+    {
+        size_t bytes = sizeof(V) * size_t(n);
+        if (n < 0 || bytes > left) return false;
+        if (n > 0) std::memcpy(dst, ptr, bytes);
+        ptr += bytes;
+        left -= bytes;
+        return true;
+    }
+
+    bool atEnd() const { return left == 0; }
+
+  private:
+    const unsigned char* ptr;
+    size_t               left;
+};
+} // namespace
+
+template <typename T>
+typename BasicNsgfCqtCommon<T>::BandInfo BasicNsgfCqtCommon<T>::computeBandInfo(double frac, double fMin,
+                                                                                double fMax, double fRef)
 {
     // ceil() rounds both counts outward, so bax(0) <= fMin and
     // bax(end) >= fMax hold even when fRef lies outside [fMin, fMax]
@@ -31,8 +88,9 @@ NsgfCqtCommon::BandInfo NsgfCqtCommon::computeBandInfo(double frac, double fMin,
     return {nBands, nBandsDown, nBandsUp};
 }
 
-bool NsgfCqtCommon::validate(double fs, Index nSamps, double frac,
-                             double fMin, double fMax, double fRef)
+template <typename T>
+bool BasicNsgfCqtCommon<T>::validate(double fs, Index nSamps, double frac,
+                                     double fMin, double fMax, double fRef)
 {
     // Written as !(x > 0) rather than (x <= 0) so that NaNs fail too.
     if (!(fs > 0)) return false;                    // no sample rate yet (e.g. DAW placeholder)
@@ -46,23 +104,33 @@ bool NsgfCqtCommon::validate(double fs, Index nSamps, double frac,
     return true;
 }
 
-bool NsgfCqtCommon::checkFrameHealth() const
+template <typename T>
+bool BasicNsgfCqtCommon<T>::checkFrameHealth(const ArrayXd& dd) const
 {
     if (nFreqs == 0) return false;
-    auto dh = d.head(nFreqs / 2 + 1);
+    auto dh = dd.head(nFreqs / 2 + 1);
     return dh.minCoeff() > dHealthTol * dh.maxCoeff();
 }
 
-double NsgfCqtCommon::getFrameConditionNumber() const
+template <typename T>
+double BasicNsgfCqtCommon<T>::getFrameConditionNumber() const
 {
-    if (!valid || nFreqs == 0) return std::numeric_limits<double>::infinity();
-    auto dh = d.head(nFreqs / 2 + 1);
+    if (!valid || nFreqs == 0 || !d) return std::numeric_limits<double>::infinity();
+    auto dh = d->head(nFreqs / 2 + 1);
     return dh.maxCoeff() / dh.minCoeff();
 }
 
-NsgfCqtCommon::NsgfCqtCommon(double sampleRate, Index numSamples,
-                             double fraction, double minFrequency,
-                             double maxFrequency, double refFrequency) :
+template <typename T>
+const ArrayXd& BasicNsgfCqtCommon<T>::getDiagonalization() const
+{
+    static const ArrayXd empty;
+    return d ? *d : empty;
+}
+
+template <typename T>
+BasicNsgfCqtCommon<T>::BasicNsgfCqtCommon(double sampleRate, Index numSamples,
+                                          double fraction, double minFrequency,
+                                          double maxFrequency, double refFrequency) :
     valid(validate(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency)),
     fs(sampleRate),
     nSamps(valid ? numSamples : 0),
@@ -74,13 +142,9 @@ NsgfCqtCommon::NsgfCqtCommon(double sampleRate, Index numSamples,
     nBands(bandInfo.nBands),
     nFreqs(nSamps),
     bax(nBands),
-    fax(nFreqs),
-    d(nFreqs),
-    Xdft(nSamps),
-    dft(valid ? DFT(size_t(nSamps)) : DFT())
+    fax(nFreqs)
 {
     if (!valid) return; // inert: members stay empty, methods output silence
-    Xdft.setZero();
     bax = fRef * (frac * log(2) * regspace(-bandInfo.nBandsDown, bandInfo.nBandsUp)).exp();
     fax = ArrayXd::LinSpaced(nFreqs, 0, nFreqs - 1) * fs / double(nFreqs);
 }
@@ -89,173 +153,908 @@ NsgfCqtCommon::NsgfCqtCommon(double sampleRate, Index numSamples,
 //==========================================================================
 //==========================================================================
 
-NsgfCqtDense::NsgfCqtDense(double sampleRate, Index numSamples,
-                           double fraction, double minFrequency,
-                           double maxFrequency, double refFrequency) :
-    NsgfCqtCommon(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
-    Xmat(nSamps, nBands)
+template <typename T>
+BasicNsgfCqtDense<T>::BasicNsgfCqtDense(double sampleRate, Index numSamples,
+                                        double fraction, double minFrequency,
+                                        double maxFrequency, double refFrequency) :
+    Base(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency)
 {
+    static const std::shared_ptr<const SharedFrame> empty = std::make_shared<SharedFrame>();
+
+    frame = valid ? Registry::instance().get(this->getFrameKey(), [this] { return buildFrame(); }) : empty;
+    d     = std::shared_ptr<const ArrayXd>(frame, &frame->d);
     if (!valid) return;
 
-    ArrayXXd outerDif = fax.log2().rowwise().replicate(bax.size()) -
-                        bax.log2().transpose().colwise().replicate(fax.size());
+    frameOk = frame->ok; // inert when false: gaps in d, or atoms the grid cannot resolve
+    work    = makeWorkspace();
+    Xstage  = ComplexArray::Zero(nSamps);
+}
+
+template <typename T>
+std::shared_ptr<typename BasicNsgfCqtDense<T>::SharedFrame> BasicNsgfCqtDense<T>::buildFrame() const
+{
+    auto f = std::make_shared<SharedFrame>();
+
+    // The frame is designed in double and rounded to T once it is final.
+    ArrayXXd g_;
+    {
+        ArrayXXd outerDif = fax.log2().rowwise().replicate(bax.size()) -
+                            bax.log2().transpose().colwise().replicate(fax.size());
 
-    double c = log(4) / (square(frac));
-    g        = (-c * outerDif.square()).exp();
+        double c = log(4) / (square(frac));
+        g_       = (-c * outerDif.square()).exp();
+    }
 
-    Index end  = nBands - 1;
-    g.col(0)   = (fax < bax(0)).select(1, g.col(0));
-    g.col(end) = (fax > bax(end)).select(1, g.col(end));
-    d          = g.square().rowwise().sum();
+    Index end   = nBands - 1;
+    g_.col(0)   = (fax < bax(0)).select(1, g_.col(0));
+    g_.col(end) = (fax > bax(end)).select(1, g_.col(end));
+    f->d        = g_.square().rowwise().sum();
 
-    frameOk = checkFrameHealth();
-    for (Index k = 0; frameOk && k < nBands; k++) {
-        frameOk = (g.col(k) > th).count() >= minAtomSupport;
+    f->ok = this->checkFrameHealth(f->d);
+    for (Index k = 0; f->ok && k < nBands; k++) {
+        f->ok = (g_.col(k) > th).count() >= minAtomSupport;
     }
-    if (!frameOk) return; // inert: gaps in d, or atoms the grid cannot resolve
+    if (!f->ok) return f;
 
-    gDual = g.colwise() / d;
+    g_.bottomRows(nFreqs / 2 - 1).setZero();
+    f->g = g_.cast<T>();
+    g_.colwise() /= f->d;
+    f->gDual = g_.cast<T>();
+    return f;
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::forward(const RealArray& x, ComplexMatrix& Xcq)
+{
+    forward(x, Xcq, work);
+}
 
-    g.bottomRows(nFreqs / 2 - 1).setZero();
-    gDual.bottomRows(nFreqs / 2 - 1).setZero();
+template <typename T>
+void BasicNsgfCqtDense<T>::inverse(const ComplexMatrix& Xcq, RealArray& x)
+{
+    inverse(Xcq, x, work);
+}
 
-    Xmat.setZero();
+template <typename T>
+typename BasicNsgfCqtDense<T>::Workspace BasicNsgfCqtDense<T>::makeWorkspace() const
+{
+    if (!this->isValid()) return {};
+    Workspace ws{ComplexArray::Zero(nSamps), ComplexMatrix::Zero(nSamps, nBands), BasicDFT<T>(size_t(nSamps))};
+    ws.dft.prepareBatch(nBands, nSamps);
+    return ws;
 }
 
-void NsgfCqtDense::forward(const ArrayXd& x, ArrayXXcd& Xcq)
+template <typename T>
+void BasicNsgfCqtDense<T>::forward(const RealArray& x, ComplexMatrix& Xcq, Workspace& ws) const
 {
     RealTimeChecker ck;
 
-    if (!isValid()) {
+    if (!this->isValid()) {
         Xcq.setZero();
         return;
     }
     assert(x.size() == nSamps);
     assert(Xcq.cols() == Index(nBands));
     assert(Xcq.rows() == Index(nSamps));
-    dft.rdft(x, Xdft);
+    assert(ws.Xmat.rows() == nSamps && ws.Xmat.cols() == nBands);
+    const RealMatrix& g = frame->g;
+    ws.dft.rdft(x, ws.Xdft);
     for (Index k = 0; k < nBands; k++) {
-        Xmat.col(k) = 2 * g.col(k) * Xdft;
+        ws.Xmat.col(k) = T(2) * g.col(k) * ws.Xdft;
     }
-    dft.idft(Xmat, Xcq);
+    ws.dft.idft(ws.Xmat, Xcq);
 }
 
-void NsgfCqtDense::inverse(const ArrayXXcd& Xcq, ArrayXd& x)
+template <typename T>
+void BasicNsgfCqtDense<T>::inverse(const ComplexMatrix& Xcq, RealArray& x, Workspace& ws) const
 {
     RealTimeChecker ck;
 
-    if (!isValid()) {
+    if (!this->isValid()) {
         x.setZero();
         return;
     }
     assert(x.size() == nSamps);
     assert(Xcq.cols() == Index(nBands));
     assert(Xcq.rows() == Index(nSamps));
-    dft.dft(Xcq, Xmat);
-    Xdft = (Xmat * gDual).rowwise().sum() / 2;
-    dft.irdft(Xdft, x);
+    assert(ws.Xmat.rows() == nSamps && ws.Xmat.cols() == nBands);
+    ws.dft.dft(Xcq, ws.Xmat);
+    ws.Xdft = (ws.Xmat * frame->gDual).rowwise().sum() / T(2);
+    ws.dft.irdft(ws.Xdft, x);
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::bandEnergies(const RealArray& x, RealArray& e)
+{
+    bandEnergies(x, e, work);
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::bandEnergies(const RealArray& x, RealArray& e, Workspace& ws) const
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        e.setZero();
+        return;
+    }
+    assert(x.size() == nSamps);
+    assert(e.size() == Index(nBands));
+    // Xcq.col(k) = idft(2 g_k Xdft), and the idft scales by 1/N. The atoms
+    // are zero above Nyquist, so only the first nFreqs / 2 + 1 bins count.
+    const RealMatrix& g    = frame->g;
+    Index             half = nFreqs / 2 + 1;
+    ws.dft.rdft(x, ws.Xdft);
+    for (Index k = 0; k < nBands; k++) {
+        e(k) = (g.col(k).head(half).square() * ws.Xdft.head(half).abs2()).sum() * T(4) / T(nSamps);
+    }
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::forwardStart(const RealArray& x)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) return;
+    assert(x.size() == nSamps);
+    work.dft.rdft(x, work.Xdft);
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::forwardBand(Index k, ComplexMatrix& Xcq)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        Xcq.col(k).setZero();
+        return;
+    }
+    Xstage = T(2) * frame->g.col(k) * work.Xdft;
+    work.dft.idft(Xstage, Xstage);
+    Xcq.col(k) = Xstage;
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::inverseBand(Index k, const ComplexMatrix& Xcq)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) return;
+    Xstage = Xcq.col(k);
+    work.dft.dft(Xstage, Xstage);
+    work.Xmat.col(k) = Xstage;
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::inverseSkipBand(Index k)
+{
+    if (!this->isValid()) return;
+    work.Xmat.col(k).setZero();
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::inverseFinish(RealArray& x)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        x.setZero();
+        return;
+    }
+    assert(x.size() == nSamps);
+    work.Xdft = (work.Xmat * frame->gDual).rowwise().sum() / T(2);
+    work.dft.irdft(work.Xdft, x);
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::reserveChannels(Index nChannels)
+{
+    if (!this->isValid()) return;
+    if (XbandMulti.cols() == nChannels) return;
+    XdftMulti  = ComplexMatrix::Zero(nSamps, nChannels);
+    XbandMulti = ComplexMatrix::Zero(nSamps, nChannels);
+    work.dft.prepareBatch(nChannels, nSamps);
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::forward(const RealMatrix& x, MultiCoefs& Xcq)
+{
+    if (!this->isValid()) {
+        for (auto& c : Xcq) c.setZero();
+        return;
+    }
+    Index nCh = x.cols();
+    assert(x.rows() == nSamps);
+    assert(Index(Xcq.size()) == nCh);
+    reserveChannels(nCh);
+
+    RealTimeChecker ck;
+
+    const RealMatrix& g = frame->g;
+    work.dft.rdft(x, XdftMulti);
+    for (Index k = 0; k < nBands; k++) {
+        for (Index c = 0; c < nCh; c++) XbandMulti.col(c) = T(2) * g.col(k) * XdftMulti.col(c);
+        work.dft.idft(XbandMulti, XbandMulti);
+        for (Index c = 0; c < nCh; c++) Xcq[c].col(k) = XbandMulti.col(c);
+    }
+}
+
+template <typename T>
+void BasicNsgfCqtDense<T>::inverse(const MultiCoefs& Xcq, RealMatrix& x)
+{
+    if (!this->isValid()) {
+        x.setZero();
+        return;
+    }
+    Index nCh = x.cols();
+    assert(x.rows() == nSamps);
+    assert(Index(Xcq.size()) == nCh);
+    reserveChannels(nCh);
+
+    RealTimeChecker ck;
+
+    const RealMatrix& gDual = frame->gDual;
+    XdftMulti.setZero();
+    for (Index k = 0; k < nBands; k++) {
+        for (Index c = 0; c < nCh; c++) XbandMulti.col(c) = Xcq[c].col(k);
+        work.dft.dft(XbandMulti, XbandMulti);
+        for (Index c = 0; c < nCh; c++) XdftMulti.col(c) += gDual.col(k) * XbandMulti.col(c);
+    }
+    XdftMulti /= T(2);
+    work.dft.irdft(XdftMulti, x);
 }
 
 //==========================================================================
 //==========================================================================
 //==========================================================================
 
-NsgfCqtSparse::NsgfCqtSparse(double sampleRate, Index numSamples,
-                             double fraction, double minFrequency,
-                             double maxFrequency, double refFrequency) :
-    NsgfCqtCommon(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
-    idx(nBands),
-    g(nBands),
-    gDual(nBands),
-    phase(nBands),
-    scale(nBands),
-    dfts(nBands)
+template <typename T>
+BasicNsgfCqtSparse<T>::BasicNsgfCqtSparse(double sampleRate, Index numSamples,
+                                          double fraction, double minFrequency,
+                                          double maxFrequency, double refFrequency,
+                                          SpanPolicy spanPolicy) :
+    Base(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
+    spans(spanPolicy)
 {
+    static const std::shared_ptr<const SharedFrame> empty = std::make_shared<SharedFrame>();
+
+    frame = valid ? Registry::instance().get(getFrameKey(), [this] { return loadOrBuildFrame(); }) : empty;
+    d     = std::shared_ptr<const ArrayXd>(frame, &frame->d);
     if (!valid) return;
 
-    ArrayXXd outerDif = fax.log2().rowwise().replicate(bax.size()) -
-                        bax.log2().transpose().colwise().replicate(fax.size());
+    // Band DFTs route to whichever backend plans their length; mixed-radix
+    // lengths in a build with only power-of-two backends have none.
+    frameOk = frame->ok;
+    for (Index k = 0; frameOk && k < nBands; k++) frameOk = BasicDFT<T>::isSupported(size_t(frame->idx[k].len));
+    if (!frameOk) return;
 
-    double   c  = log(4) / (square(frac));
-    ArrayXXd g_ = (-c * outerDif.square()).exp();
+    work = makeWorkspace();
+    offsets.assign(size_t(nBands) + 1, 0);
+    for (Index k = 0; k < nBands; k++) offsets[k + 1] = offsets[k] + frame->idx[k].len;
+}
 
-    Index end   = nBands - 1;
-    g_.col(0)   = (fax < bax(0)).select(1, g_.col(0));
-    g_.col(end) = (fax > bax(end)).select(1, g_.col(end));
-    g_          = (g_ <= th).select(0.0, g_);
+template <typename T>
+std::shared_ptr<typename BasicNsgfCqtSparse<T>::SharedFrame> BasicNsgfCqtSparse<T>::buildFrame() const
+{
+    auto f = std::make_shared<SharedFrame>();
+    f->idx.resize(nBands);
+    f->g.resize(nBands);
+    f->gDual.resize(nBands);
+    f->phase.resize(nBands);
+    f->scale.resize(nBands);
+
+    // Each atom is a Gaussian in log-frequency, so the bins where it exceeds
+    // th are known in closed form: |log2(f) - log2(b_k)| < r, c·r² = -ln(th).
+    // Atoms are evaluated on that support only (widened by a couple of bins
+    // and to packet boundaries), so peak memory is O(total support) rather
+    // than a dense nFreqs x nBands design matrix. The result is bit-identical
+    // to the dense design: atoms come from the same Eigen expressions over
+    // packet-aligned ranges, and d is accumulated in rowwise().sum()'s order.
+    double  c   = log(4) / (square(frac));
+    double  r   = sqrt(-log(th) / c);
+    Index   end = nBands - 1;
+    ArrayXd lf  = fax.log2();
+    ArrayXd lb  = bax.log2();
+
+    std::vector<ArrayXd> atom(nBands); // thresholded atom on [lo[k], lo[k] + size)
+    std::vector<Index>   lo(nBands);
+    for (Index k = 0; k < nBands; k++) {
+        constexpr Index packet = 8; // widest double packet (AVX-512)
 
-    d = g_.square().rowwise().sum();
+        Index a = k == 0 ? 0 : Index(floor(bax(k) * exp2(-r) * double(nFreqs) / fs)) - 2;
+        Index b = k == end ? nFreqs : Index(ceil(bax(k) * exp2(r) * double(nFreqs) / fs)) + 3;
+        a       = std::clamp<Index>(a, 0, nFreqs) / packet * packet;
+        b       = std::clamp<Index>((b + packet - 1) / packet * packet, a, nFreqs);
+
+        ArrayXd v = (-c * (lf.segment(a, b - a) - lb(k)).square()).exp();
+        if (k == 0) v = (fax.segment(a, b - a) < bax(0)).select(1, v);
+        if (k == end) v = (fax.segment(a, b - a) > bax(end)).select(1, v);
+        v = (v <= th).select(0.0, v);
+
+        Index first = 0, last = v.size() - 1;
+        while (first <= last && v(first) == 0) first++;
+        while (last >= first && v(last) == 0) last--;
+        lo[k]   = a + first;
+        atom[k] = v.segment(first, last - first + 1);
+    }
+
+    // d = Σ_k g_k², summed like Eigen's packetwise rowwise().sum(): band 0,
+    // then bands in fours as (g1² + g2²) + (g3² + g4²), then the rest one by
+    // one. Adding an atom's zeros outside its support is exact, so only the
+    // bins each group touches need visiting.
+    f->d.setZero(nFreqs);
+    auto addBand = [&](ArrayXd& acc, Index accLo, Index k) {
+        if (atom[k].size() == 0) return;
+        acc.segment(lo[k] - accLo, atom[k].size()) += atom[k].square();
+    };
+    f->d.segment(lo[0], atom[0].size()) = atom[0].square();
+    Index k = 1;
+    for (Index size4 = (nBands - 1) & ~Index(3); k < size4; k += 4) {
+        Index gLo = nFreqs, gHi = 0;
+        for (Index j = k; j < k + 4; j++) {
+            if (atom[j].size() == 0) continue;
+            gLo = std::min(gLo, lo[j]);
+            gHi = std::max(gHi, lo[j] + atom[j].size());
+        }
+        if (gLo >= gHi) continue;
+        ArrayXd s01 = ArrayXd::Zero(gHi - gLo);
+        ArrayXd s23 = ArrayXd::Zero(gHi - gLo);
+        addBand(s01, gLo, k);
+        addBand(s01, gLo, k + 1);
+        addBand(s23, gLo, k + 2);
+        addBand(s23, gLo, k + 3);
+        f->d.segment(gLo, gHi - gLo) += s01 + s23;
+    }
+    for (; k < nBands; k++) addBand(f->d, 0, k);
 
     // Measured health: coverage gaps show up in d (condition number); atoms
     // the grid cannot resolve show up as insufficient support — the latter
     // would otherwise break the span extraction below.
-    frameOk = checkFrameHealth();
-    for (Index k = 0; frameOk && k < nBands; k++) {
-        frameOk = (g_.col(k) > th).count() >= minAtomSupport;
+    f->ok = this->checkFrameHealth(f->d);
+    for (k = 0; f->ok && k < nBands; k++) {
+        f->ok = atom[k].size() >= minAtomSupport; // the support is contiguous
     }
-    if (!frameOk) return;
+    if (!f->ok) return f;
+
+    using namespace std::complex_literals;
 
-    ArrayXXd gDual_ = g_.colwise() / d;
+    // Atoms and duals are kept up to Nyquist only (bins [0, nFreqs/2]).
+    // Atoms and phases are computed in double and rounded to T per band.
+    for (k = 0; k < nBands; k++) {
+        Index   n0    = std::min(atom[k].size(), std::max<Index>(0, nFreqs / 2 + 1 - lo[k]));
+        ArrayXd gk    = atom[k].head(n0);
+        ArrayXd dualk = gk / f->d.segment(lo[k], n0);
 
-    g_.bottomRows(nFreqs / 2 - 1).fill(0);
-    gDual_.bottomRows(nFreqs / 2 - 1).fill(0);
+        f->idx[k]   = getIdx(gk, lo[k]);
+        Index i0    = f->idx[k].i0;
+        Index len   = f->idx[k].len;
+        f->scale(k) = T(len);
+        ArrayXd n   = regspace(len);
+        f->phase[k] = exp(1i * 2.0 * std::numbers::pi * double(i0) * n / double(len)).template cast<std::complex<T>>();
 
-    using namespace std::complex_literals;
+        // The span starts at the support and is rounded up in length, so it
+        // covers the support and is zero past it.
+        Index m     = std::min(len, n0 - (i0 - lo[k]));
+        f->g[k]     = RealArray::Zero(len);
+        f->gDual[k] = RealArray::Zero(len);
+        f->g[k].head(m)     = gk.segment(i0 - lo[k], m).template cast<T>();
+        f->gDual[k].head(m) = dualk.segment(i0 - lo[k], m).template cast<T>();
+    }
+    return f;
+}
+
+template <typename T>
+BasicNsgfCqtSparse<T>::~BasicNsgfCqtSparse() = default;
+
+template <typename T>
+FrameKey BasicNsgfCqtSparse<T>::getFrameKey() const
+{
+    FrameKey key = Base::getFrameKey();
+    key.spans    = int(spans);
+    return key;
+}
+
+template <typename T>
+std::shared_ptr<const typename BasicNsgfCqtSparse<T>::SharedFrame> BasicNsgfCqtSparse<T>::loadOrBuildFrame() const
+{
+    std::string path = FrameCache::pathFor(getFrameKey(), cacheKind());
+    if (path.empty()) return buildFrame();
+
+    if (auto f = loadFrame(path)) return f;
 
+    auto f = buildFrame();
+    FrameCache::writeFile(path, serializeFrame(*f)); // best effort: a failed write only costs the next startup
+    return f;
+}
+
+template <typename T>
+bool BasicNsgfCqtSparse<T>::saveFrame(const std::string& path) const
+{
+    if (!valid) return false;
+    return FrameCache::writeFile(path, serializeFrame(*frame));
+}
+
+template <typename T>
+std::vector<unsigned char> BasicNsgfCqtSparse<T>::serializeFrame(const SharedFrame& f) const
+{
+    FrameKey        key = getFrameKey();
+    FrameFileHeader h   = {};
+    std::memcpy(h.magic, frameMagic, sizeof(frameMagic));
+    h.version    = FrameCache::version;
+    h.endianTag  = endianTag;
+    h.scalarSize = sizeof(T);
+    h.ok         = f.ok;
+    h.spans      = key.spans;
+    h.fs         = key.fs;
+    h.frac       = key.frac;
+    h.fMin       = key.fMin;
+    h.fMax       = key.fMax;
+    h.fRef       = key.fRef;
+    h.nSamps     = key.nSamps;
+    h.nBands     = nBands;
+    h.nFreqs     = nFreqs;
+    h.totalLen   = 0;
+    if (f.ok)
+        for (const auto& s : f.idx) h.totalLen += s.len;
+
+    std::vector<unsigned char> out;
+    putBytes(out, &h, 1);
+    putBytes(out, f.d.data(), f.d.size());
+    if (!f.ok) return out; // an unhealthy frame carries only d
+
+    for (const auto& s : f.idx) {
+        std::int64_t span[2] = {s.i0, s.len};
+        putBytes(out, span, 2);
+    }
+    putBytes(out, f.scale.data(), nBands);
+    for (const auto& a : f.g) putBytes(out, a.data(), a.size());
+    for (const auto& a : f.gDual) putBytes(out, a.data(), a.size());
+    for (const auto& a : f.phase) putBytes(out, a.data(), a.size());
+    return out;
+}
+
+template <typename T>
+std::shared_ptr<typename BasicNsgfCqtSparse<T>::SharedFrame> BasicNsgfCqtSparse<T>::loadFrame(const std::string& path) const
+{
+    FrameCache::MappedFile file(path);
+    if (!file.data()) return nullptr;
+
+    ByteReader      in(file.data(), file.size());
+    FrameFileHeader h;
+    if (!in.get(&h, 1)) return nullptr;
+
+    FrameKey key = getFrameKey();
+    if (std::memcmp(h.magic, frameMagic, sizeof(frameMagic)) != 0 || h.version != FrameCache::version ||
+        h.endianTag != endianTag || h.scalarSize != sizeof(T))
+        return nullptr;
+    if (!(FrameKey{h.fs, h.nSamps, h.frac, h.fMin, h.fMax, h.fRef, h.spans} == key) || h.nBands != nBands ||
+        h.nFreqs != nFreqs)
+        return nullptr;
+
+    auto f = std::make_shared<SharedFrame>();
+    f->ok  = h.ok != 0;
+    f->d.resize(nFreqs);
+    f->idx.resize(nBands);
+    f->g.resize(nBands);
+    f->gDual.resize(nBands);
+    f->phase.resize(nBands);
+    f->scale.resize(nBands);
+    if (!in.get(f->d.data(), nFreqs)) return nullptr;
+    if (!f->ok) return in.atEnd() ? f : nullptr;
+
+    Index total = 0;
+    for (auto& s : f->idx) {
+        std::int64_t span[2];
+        if (!in.get(span, 2)) return nullptr;
+        if (span[0] < 0 || span[1] < minAtomSupport || span[0] + span[1] > nFreqs) return nullptr;
+        if (roundSpan(Index(span[1])) != span[1] || !BasicDFT<T>::isSupported(size_t(span[1]))) return nullptr;
+        s = {Index(span[0]), Index(span[1])};
+        total += s.len;
+    }
+    if (total != h.totalLen) return nullptr;
+    if (!in.get(f->scale.data(), nBands)) return nullptr;
     for (Index k = 0; k < nBands; k++) {
-        idx[k]    = getIdx(g_.col(k));
-        Index i0  = idx[k].i0;
-        Index len = idx[k].len;
-        scale(k)  = double(len);
-        ArrayXd n = regspace(len);
-        phase[k]  = exp(1i * 2.0 * std::numbers::pi * double(i0) * n / double(len));
-        g[k]      = g_.col(k).segment(i0, len);
-        gDual[k]  = gDual_.col(k).segment(i0, len);
-        dfts[k].reset(new DFT(len));
+        f->g[k].resize(f->idx[k].len);
+        if (!in.get(f->g[k].data(), f->idx[k].len)) return nullptr;
     }
+    for (Index k = 0; k < nBands; k++) {
+        f->gDual[k].resize(f->idx[k].len);
+        if (!in.get(f->gDual[k].data(), f->idx[k].len)) return nullptr;
+    }
+    for (Index k = 0; k < nBands; k++) {
+        f->phase[k].resize(f->idx[k].len);
+        if (!in.get(f->phase[k].data(), f->idx[k].len)) return nullptr;
+    }
+    return in.atEnd() ? f : nullptr;
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::setNumThreads(unsigned numThreads)
+{
+    if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (numThreads == getNumThreads()) return;
+    pool.reset(numThreads > 1 ? new ThreadPool(numThreads) : nullptr);
+}
+
+template <typename T>
+unsigned BasicNsgfCqtSparse<T>::getNumThreads() const
+{
+    return pool ? pool->size() : 1;
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forward(const RealArray& x, Coefs& Xcq)
+{
+    forwardWith(x, Xcq, work, pool.get());
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverse(const Coefs& Xcq, RealArray& x)
+{
+    inverseWith(Xcq, x, work, pool.get());
+}
+
+template <typename T>
+typename BasicNsgfCqtSparse<T>::Workspace BasicNsgfCqtSparse<T>::makeWorkspace() const
+{
+    Workspace ws;
+    if (!this->isValid()) return ws;
+    ws.Xdft   = ComplexArray::Zero(nSamps);
+    ws.Xcoefs = getCoefs();
+    ws.dft    = BasicDFT<T>(size_t(nSamps));
+    ws.dfts.resize(nBands);
+    for (Index k = 0; k < nBands; k++) {
+        ws.dfts[k].reset(new BasicDFT<T>(frame->idx[k].len));
+    }
+    return ws;
+}
 
-    Xcoefs = getCoefs();
+template <typename T>
+void BasicNsgfCqtSparse<T>::forward(const RealArray& x, Coefs& Xcq, Workspace& ws) const
+{
+    forwardWith(x, Xcq, ws, nullptr);
 }
 
-void NsgfCqtSparse::forward(const ArrayXd& x, Coefs& Xcq)
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverse(const Coefs& Xcq, RealArray& x, Workspace& ws) const
+{
+    inverseWith(Xcq, x, ws, nullptr);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardWith(const RealArray& x, Coefs& Xcq, Workspace& ws,
+                                        ThreadPool* workers) const
 {
     RealTimeChecker ck;
 
-    if (!isValid()) {
+    if (!this->isValid()) {
         for (auto& c : Xcq) c.setZero();
         return;
     }
     assert(Index(Xcq.size()) == nBands);
-    Xdft.fill(0);
-    dft.rdft(x, Xdft);
-    Xdft /= nSamps;
-    for (Index k = 0; k < nBands; k++) {
-        Xcoefs[k] = g[k] * Xdft.segment(idx[k].i0, idx[k].len);
-        dfts[k]->idft(Xcoefs[k], Xcoefs[k]);
-        Xcq[k] = 2.0 * scale(k) * phase[k] * Xcoefs[k];
+    assert(Index(ws.Xcoefs.size()) == nBands);
+    ws.Xdft.fill(0);
+    ws.dft.rdft(x, ws.Xdft);
+    ws.Xdft /= T(nSamps);
+    if (workers) {
+        auto body = [&](Index k) { forwardBand(k, Xcq, ws); };
+        workers->parallelFor(nBands, body);
+    } else {
+        for (Index k = 0; k < nBands; k++) forwardBand(k, Xcq, ws);
     }
 }
 
-void NsgfCqtSparse::inverse(const Coefs& Xcq, ArrayXd& x)
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverseWith(const Coefs& Xcq, RealArray& x, Workspace& ws,
+                                        ThreadPool* workers) const
 {
     RealTimeChecker ck;
 
-    if (!isValid()) {
+    if (!this->isValid()) {
         x.setZero();
         return;
     }
     assert(Index(Xcq.size()) == nBands);
-    Xdft.fill(0);
+    assert(Index(ws.Xcoefs.size()) == nBands);
+    ws.Xdft.fill(0);
+    if (workers) {
+        // Bands overlap in frequency, so the accumulation is split by
+        // disjoint bin tiles rather than by band: no two threads ever add
+        // into the same bin, and every bin sums its bands in the serial order.
+        auto  bands  = [&](Index k) { inverseBand(k, Xcq, ws); };
+        Index nBins  = ws.Xdft.size();
+        Index nTiles = std::min<Index>(nBins, 4 * workers->size());
+        auto  tiles  = [&](Index t) { accumulate(t * nBins / nTiles, (t + 1) * nBins / nTiles, ws); };
+        workers->parallelFor(nBands, bands);
+        workers->parallelFor(nTiles, tiles);
+    } else {
+        for (Index k = 0; k < nBands; k++) inverseBand(k, Xcq, ws);
+        accumulate(0, ws.Xdft.size(), ws);
+    }
+    ws.dft.irdft(ws.Xdft, x);
+    x *= T(nSamps);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::bandEnergies(const RealArray& x, RealArray& e)
+{
+    bandEnergies(x, e, work);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::bandEnergies(const RealArray& x, RealArray& e, Workspace& ws) const
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        e.setZero();
+        return;
+    }
+    assert(x.size() == nSamps);
+    assert(e.size() == Index(nBands));
+    // Xcq[k] = 2 len phase_k idft_len(g_k Xdft / N) with |phase_k| = 1, and
+    // the idft scales by 1/len.
+    const SharedFrame& f = *frame;
+    ws.Xdft.fill(0);
+    ws.dft.rdft(x, ws.Xdft);
     for (Index k = 0; k < nBands; k++) {
-        Xcoefs[k] = 1.0 / (2.0 * scale(k)) * phase[k].conjugate() * Xcq[k];
-        dfts[k]->dft(Xcoefs[k], Xcoefs[k]);
-        Xdft.segment(idx[k].i0, idx[k].len) += gDual[k] * Xcoefs[k];
+        Index len = f.idx[k].len;
+        e(k)      = (f.g[k].square() * ws.Xdft.segment(f.idx[k].i0, len).abs2()).sum() * T(4 * len) / (T(nSamps) * T(nSamps));
+    }
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardMagnitude(const RealArray& x, ArrayXf& mag, MagnitudeScale scale)
+{
+    forwardMagnitudeWith(x, mag, scale, work, pool.get());
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardMagnitude(const RealArray& x, ArrayXd& mag, MagnitudeScale scale)
+{
+    forwardMagnitudeWith(x, mag, scale, work, pool.get());
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardMagnitude(const RealArray& x, ArrayXf& mag, MagnitudeScale scale,
+                                             Workspace& ws) const
+{
+    forwardMagnitudeWith(x, mag, scale, ws, nullptr);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardMagnitude(const RealArray& x, ArrayXd& mag, MagnitudeScale scale,
+                                             Workspace& ws) const
+{
+    forwardMagnitudeWith(x, mag, scale, ws, nullptr);
+}
+
+template <typename T>
+template <typename S>
+void BasicNsgfCqtSparse<T>::forwardMagnitudeWith(const RealArray& x, Array<S, Dynamic, 1>& mag, MagnitudeScale scale,
+                                                 Workspace& ws, ThreadPool* workers) const
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        mag.setZero();
+        return;
+    }
+    assert(x.size() == nSamps);
+    assert(mag.size() == getNumCoefs());
+    // |Xcq[k]| = 2 len |idft(g_k Xdft / N)|: the phase has unit modulus, so
+    // it is skipped, and the scale and the 1/N fold into one real gain.
+    const SharedFrame& f = *frame;
+    ws.Xdft.fill(0);
+    ws.dft.rdft(x, ws.Xdft);
+    auto band = [&](Index k) {
+        Index len = f.idx[k].len;
+        auto& c   = ws.Xcoefs[k];
+        c         = f.g[k] * ws.Xdft.segment(f.idx[k].i0, len);
+        ws.dfts[k]->idft(c, c);
+        T    gain = T(2) * f.scale(k) / T(nSamps);
+        auto out  = mag.segment(offsets[k], len);
+        out = (gain * c.abs()).template cast<S>();
+        if (scale == MagnitudeScale::Decibels) out = S(20) * out.max(S(1e-10)).log10();
+    };
+    if (workers) {
+        workers->parallelFor(nBands, band);
+    } else {
+        for (Index k = 0; k < nBands; k++) band(k);
+    }
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardStart(const RealArray& x)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) return;
+    assert(x.size() == nSamps);
+    work.Xdft.fill(0);
+    work.dft.rdft(x, work.Xdft);
+    work.Xdft /= T(nSamps);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardBand(Index k, Coefs& Xcq)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        Xcq[k].setZero();
+        return;
     }
-    dft.irdft(Xdft, x);
-    x *= nSamps;
+    forwardBand(k, Xcq, work);
 }
 
-NsgfCqtSparse::Span NsgfCqtSparse::getIdx(const ArrayXd& x)
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverseBand(Index k, const Coefs& Xcq)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) return;
+    inverseBand(k, Xcq, work);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverseSkipBand(Index k)
+{
+    if (!this->isValid()) return;
+    work.Xcoefs[k].setZero();
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverseFinish(RealArray& x)
+{
+    RealTimeChecker ck;
+
+    if (!this->isValid()) {
+        x.setZero();
+        return;
+    }
+    work.Xdft.fill(0);
+    accumulate(0, work.Xdft.size(), work);
+    work.dft.irdft(work.Xdft, x);
+    x *= T(nSamps);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardBand(Index k, Coefs& Xcq, Workspace& ws) const
+{
+    const SharedFrame& f = *frame;
+    ws.Xcoefs[k] = f.g[k] * ws.Xdft.segment(f.idx[k].i0, f.idx[k].len);
+    ws.dfts[k]->idft(ws.Xcoefs[k], ws.Xcoefs[k]);
+    Xcq[k] = T(2) * f.scale(k) * f.phase[k] * ws.Xcoefs[k];
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverseBand(Index k, const Coefs& Xcq, Workspace& ws) const
+{
+    const SharedFrame& f = *frame;
+    ws.Xcoefs[k] = T(1) / (T(2) * f.scale(k)) * f.phase[k].conjugate() * Xcq[k];
+    ws.dfts[k]->dft(ws.Xcoefs[k], ws.Xcoefs[k]);
+    ws.Xcoefs[k] *= f.gDual[k];
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::accumulate(Index b0, Index b1, Workspace& ws) const
+{
+    const SharedFrame& f = *frame;
+    for (Index k = 0; k < nBands; k++) {
+        Index lo = std::max(b0, f.idx[k].i0);
+        Index hi = std::min(b1, f.idx[k].i0 + f.idx[k].len);
+        if (lo >= hi) continue;
+        ws.Xdft.segment(lo, hi - lo) += ws.Xcoefs[k].segment(lo - f.idx[k].i0, hi - lo);
+    }
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::reserveChannels(Index nChannels)
+{
+    if (!this->isValid()) return;
+    if (XdftMulti.cols() == nChannels) return;
+    const SharedFrame& f = *frame;
+    XdftMulti = ComplexMatrix::Zero(nSamps, nChannels);
+    XcoefsMulti.resize(nBands);
+    for (Index k = 0; k < nBands; k++) {
+        XcoefsMulti[k] = ComplexMatrix::Zero(f.idx[k].len, nChannels);
+        work.dfts[k]->prepareBatch(nChannels, f.idx[k].len);
+    }
+    work.dft.prepareBatch(nChannels, nSamps);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forward(const RealMatrix& x, MultiCoefs& Xcq)
+{
+    if (!this->isValid()) {
+        for (auto& ch : Xcq)
+            for (auto& c : ch) c.setZero();
+        return;
+    }
+    assert(x.rows() == nSamps);
+    assert(Index(Xcq.size()) == x.cols());
+    reserveChannels(x.cols());
+
+    RealTimeChecker ck;
+
+    XdftMulti.setZero();
+    work.dft.rdft(x, XdftMulti);
+    XdftMulti /= T(nSamps);
+    if (pool) {
+        auto body = [&](Index k) { forwardBandMulti(k, Xcq); };
+        pool->parallelFor(nBands, body);
+    } else {
+        for (Index k = 0; k < nBands; k++) forwardBandMulti(k, Xcq);
+    }
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverse(const MultiCoefs& Xcq, RealMatrix& x)
+{
+    if (!this->isValid()) {
+        x.setZero();
+        return;
+    }
+    assert(x.rows() == nSamps);
+    assert(Index(Xcq.size()) == x.cols());
+    reserveChannels(x.cols());
+
+    RealTimeChecker ck;
+
+    XdftMulti.setZero();
+    if (pool) {
+        // Same disjoint-tile accumulation as the single-channel inverse.
+        auto  bands  = [&](Index k) { inverseBandMulti(k, Xcq); };
+        Index nBins  = XdftMulti.rows();
+        Index nTiles = std::min<Index>(nBins, 4 * pool->size());
+        auto  tiles  = [&](Index t) { accumulateMulti(t * nBins / nTiles, (t + 1) * nBins / nTiles); };
+        pool->parallelFor(nBands, bands);
+        pool->parallelFor(nTiles, tiles);
+    } else {
+        for (Index k = 0; k < nBands; k++) inverseBandMulti(k, Xcq);
+        accumulateMulti(0, XdftMulti.rows());
+    }
+    work.dft.irdft(XdftMulti, x);
+    x *= T(nSamps);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::forwardBandMulti(Index k, MultiCoefs& Xcq)
+{
+    const SharedFrame& f = *frame;
+    ComplexMatrix& B = XcoefsMulti[k];
+    for (Index c = 0; c < B.cols(); c++) B.col(c) = f.g[k] * XdftMulti.col(c).segment(f.idx[k].i0, f.idx[k].len);
+    work.dfts[k]->idft(B, B);
+    T s = T(2) * f.scale(k);
+    for (Index c = 0; c < B.cols(); c++) Xcq[c][k] = s * f.phase[k] * B.col(c);
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::inverseBandMulti(Index k, const MultiCoefs& Xcq)
+{
+    const SharedFrame& f = *frame;
+    ComplexMatrix& B = XcoefsMulti[k];
+    T              s = T(1) / (T(2) * f.scale(k));
+    for (Index c = 0; c < B.cols(); c++) B.col(c) = s * f.phase[k].conjugate() * Xcq[c][k];
+    work.dfts[k]->dft(B, B);
+    for (Index c = 0; c < B.cols(); c++) B.col(c) *= f.gDual[k];
+}
+
+template <typename T>
+void BasicNsgfCqtSparse<T>::accumulateMulti(Index b0, Index b1)
+{
+    const SharedFrame& f = *frame;
+    for (Index k = 0; k < nBands; k++) {
+        Index lo = std::max(b0, f.idx[k].i0);
+        Index hi = std::min(b1, f.idx[k].i0 + f.idx[k].len);
+        if (lo >= hi) continue;
+        XdftMulti.middleRows(lo, hi - lo) += XcoefsMulti[k].middleRows(lo - f.idx[k].i0, hi - lo);
+    }
+}
+
+template <typename T>
+typename BasicNsgfCqtSparse<T>::Span BasicNsgfCqtSparse<T>::getIdx(const ArrayXd& x, Index offset) const
 {
     Index i0 = 0;
     Index i1 = x.size();
@@ -273,39 +1072,64 @@ NsgfCqtSparse::Span NsgfCqtSparse::getIdx(const ArrayXd& x)
 
     Index len = i1 - i0 + 1;
     if (len < 4) len = 4;
-    len = Index(nextPow2((unsigned int)(len)));
-    return {i0, len};
+    return {offset + i0, roundSpan(len)};
 }
 
-NsgfCqtSparse::Frame NsgfCqtSparse::getRealCoefs() const
+template <typename T>
+Index BasicNsgfCqtSparse<T>::roundSpan(Index len) const
 {
-    Frame frame(nBands); // empty when invalid (nBands == 0)
+    // Even, so the sliding processors can split every span in halves.
+    if (spans == SpanPolicy::MixedRadix) return Index(nextSmooth(size_t(len), 2));
+    return Index(nextPow2((unsigned int)(len)));
+}
+
+template <typename T>
+typename BasicNsgfCqtSparse<T>::Frame BasicNsgfCqtSparse<T>::getRealCoefs() const
+{
+    Frame real(nBands); // empty when invalid (nBands == 0)
     for (Index k = 0; k < nBands; k++) {
-        Index sz = g[k].size();
-        frame[k].resize(sz);
+        Index sz = frame->g[k].size();
+        real[k].resize(sz);
     }
-    return frame;
+    return real;
 }
 
-NsgfCqtSparse::Coefs NsgfCqtSparse::getCoefs() const
+template <typename T>
+typename BasicNsgfCqtSparse<T>::Coefs BasicNsgfCqtSparse<T>::getCoefs() const
 {
     Coefs coefs(nBands); // empty when invalid (nBands == 0)
     for (Index k = 0; k < nBands; k++) {
-        Index sz = g[k].size();
+        Index sz = frame->g[k].size();
         coefs[k].resize(sz);
         coefs[k].setZero();
     }
     return coefs;
 }
 
-NsgfCqtSparse::Coefs NsgfCqtSparse::getValidCoefs() const
+template <typename T>
+typename BasicNsgfCqtSparse<T>::MultiCoefs BasicNsgfCqtSparse<T>::getCoefs(Index nChannels) const
+{
+    return MultiCoefs(nChannels, getCoefs());
+}
+
+template <typename T>
+typename BasicNsgfCqtSparse<T>::Coefs BasicNsgfCqtSparse<T>::getValidCoefs() const
 {
     Coefs coefs(nBands); // empty when invalid (nBands == 0)
     for (Index k = 0; k < nBands; k++) {
-        Index sz = g[k].size();
-        assert(sz % 2 == 0);
+        Index sz = frame->g[k].size();
+        assert(sz % 2 == 0); // getIdx() only builds even spans
         coefs[k].resize(sz / 2);
         coefs[k].setZero();
     }
     return coefs;
 }
+
+//==========================================================================
+
+template class jsa::cicuetea::BasicNsgfCqtCommon<float>;
+template class jsa::cicuetea::BasicNsgfCqtCommon<double>;
+template class jsa::cicuetea::BasicNsgfCqtDense<float>;
+template class jsa::cicuetea::BasicNsgfCqtDense<double>;
+template class jsa::cicuetea::BasicNsgfCqtSparse<float>;
+template class jsa::cicuetea::BasicNsgfCqtSparse<double>;
@@ -7,268 +7,1366 @@
 
 #include "CQTProcessor.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+#include "AsyncWorker.h"
 #include "RTChecker.h"
 #include "SignalUtils.h"
 
 using namespace Eigen;
 using namespace jsa::cicuetea;
 
-CqtDenseProcessor::CqtDenseProcessor(double sampleRate, Index numSamples,
-                                     double fraction, double minFrequency,
-                                     double maxFrequency, double refFrequency) :
-    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
+namespace {
+/// True when overlap is a whole divisor ≥ 2 of blockSize.
+bool overlapOk(Index blockSize, Index overlap) { return overlap >= 2 && blockSize % overlap == 0; }
+
+/// The hop of blockSize at overlap (any positive size for an invalid
+/// overlap, which leaves the processor inert).
+Index hopOf(Index blockSize, Index overlap) { return std::max<Index>(blockSize / std::max<Index>(overlap, 1), 1); }
+
+/// Coefficient count of band k: the block size for a dense transform.
+template <typename T>
+Index bandLength(const BasicNsgfCqtDense<T>& cqt, Index) { return cqt.getBlockSize(); }
+
+/// Coefficient count of band k of a sparse transform.
+template <typename T>
+Index bandLength(const BasicNsgfCqtSparse<T>& cqt, Index k) { return cqt.getLength(k); }
+
+/// overlapOk() for a sliding processor, whose per-band hops also need R to
+/// divide every band's coefficient count.
+template <typename Cqt>
+bool slidingOk(const Cqt& cqt, Index overlap)
+{
+    bool ok = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    for (Index k = 0; ok && k < cqt.getNumBands(); k++) ok = bandLength(cqt, k) % overlap == 0;
+    return ok;
+}
+
+/// Band k of dense coefficients: a column.
+template <typename Derived>
+auto bandOf(Eigen::ArrayBase<Derived>& X, Index k)
+{
+    return X.derived().col(k);
+}
+
+/// Band k of sparse coefficients.
+template <typename Band>
+Band& bandOf(std::vector<Band>& X, Index k)
+{
+    return X[size_t(k)];
+}
+
+/// Estimated cost of an n-point FFT, in the units of stageCosts().
+double fftCost(Index n) { return double(n) * std::log2(double(std::max<Index>(n, 2))); }
+
+/// Stage costs of an amortized processor (see StageScheduler): the window
+/// and forwardStart(), each band's forward, processBlock() (weighted as one
+/// pass over the coefficients), each band's inverse, then inverseFinish()
+/// and the window.
+template <typename Cqt>
+std::vector<double> stageCosts(const Cqt& cqt)
+{
+    Index N = cqt.getBlockSize(), K = cqt.getNumBands(), coefs = 0;
+    for (Index k = 0; k < K; k++) coefs += bandLength(cqt, k);
+
+    std::vector<double> costs;
+    costs.reserve(size_t(2 * K + 3));
+    costs.push_back(double(N) + fftCost(N) / 2);
+    for (Index k = 0; k < K; k++) costs.push_back(fftCost(bandLength(cqt, k)) + double(bandLength(cqt, k)));
+    costs.push_back(double(coefs));
+    for (Index k = 0; k < K; k++) costs.push_back(fftCost(bandLength(cqt, k)) + double(bandLength(cqt, k)));
+    costs.push_back(double(coefs + N) + fftCost(N) / 2);
+    return costs;
+}
+
+/// What stage i of an amortized processor over K bands does.
+enum class JobStage { Start, ForwardBand, Block, InverseBand, Finish };
+
+/// Decodes stage i into its kind and, for the band stages, the band.
+std::pair<JobStage, Index> stageOf(size_t i, Index K)
+{
+    Index s = Index(i);
+    if (s == 0) return {JobStage::Start, 0};
+    if (s <= K) return {JobStage::ForwardBand, s - 1};
+    if (s == K + 1) return {JobStage::Block, 0};
+    if (s <= 2 * K + 1) return {JobStage::InverseBand, s - K - 2};
+    return {JobStage::Finish, 0};
+}
+
+/// Streams n samples through a slicer/splicer pair in runs that end at hop
+/// boundaries, calling step(run) after each run and hop() whenever a block
+/// is complete: the sequence of operations of n processSample() calls, with
+/// the per-sample push, pull and wrap check replaced by block copies.
+template <typename T, typename Hop, typename Step>
+void processRuns(BasicSlicer<T>& slicer, BasicSplicer<T>& splicer, const T* input, T* output, Index n,
+                 Hop&& hop, Step&& step)
+{
+    while (n > 0) {
+        Index run = std::min(n, slicer.getSamplesToBlock());
+        slicer.pushSamples(input, run);
+        splicer.getSamples(output, run);
+        input += run;
+        output += run;
+        n -= run;
+        step(run);
+        if (slicer.hasBlock()) hop();
+    }
+}
+
+/// processRuns() over one slicer/splicer pair per channel, all advancing in
+/// step, so every channel completes its block in the same hop.
+template <typename T, typename Hop>
+void processRunsMulti(std::vector<BasicSlicer<T>>& slicers, std::vector<BasicSplicer<T>>& splicers,
+                      const T* const* inputs, T* const* outputs, Index n, Hop&& hop)
+{
+    for (Index i = 0; i < n;) {
+        Index run = std::min(n - i, slicers.front().getSamplesToBlock());
+        for (size_t c = 0; c < slicers.size(); c++) {
+            slicers[c].pushSamples(inputs[c] + i, run);
+            splicers[c].getSamples(outputs[c] + i, run);
+        }
+        i += run;
+        if (slicers.front().hasBlock()) hop();
+    }
+}
+
+/// processRuns() for an analyzer: a slicer alone, no output.
+template <typename T, typename Hop>
+void analyzeRuns(BasicSlicer<T>& slicer, const T* input, Index n, Hop&& hop)
+{
+    while (n > 0) {
+        Index run = std::min(n, slicer.getSamplesToBlock());
+        slicer.pushSamples(input, run);
+        input += run;
+        n -= run;
+        if (slicer.hasBlock()) hop();
+    }
+}
+
+/// Zero-fills n samples of every channel (the inert processors' output).
+template <typename T>
+void silence(T* const* outputs, size_t numChannels, Index n)
+{
+    for (size_t c = 0; c < numChannels; c++) std::fill(outputs[c], outputs[c] + n, T(0));
+}
+} // namespace
+
+template <typename T, typename Cqt, typename Block>
+template <typename... Args>
+BasicHopDriver<T, Cqt, Block>::BasicHopDriver(bool sliding, Index overlap, Args&&... cqtArgs) :
+    cqt(std::forward<Args>(cqtArgs)...),
     xi(cqt.getBlockSize()),
     win(cqt.getBlockSize()),
-    Xcq(cqt.getBlockSize(), cqt.getNumBands()),
-    slicer(cqt.getBlockSize(), cqt.getBlockSize() / 2),
-    splicer(cqt.getBlockSize(), cqt.getBlockSize() / 2)
+    slicer(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap)),
+    splicer(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap)),
+    sliding(sliding)
 {
-    if (!cqt.isValid()) return;
+    valid = sliding ? slidingOk(cqt, overlap) : cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
 
-    win = hann(cqt.getBlockSize()).sqrt();
+    win = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
     xi.setZero();
-    Xcq.setZero();
+    stages.configure(stageCosts(cqt), slicer.getHopSize());
     assert(cqt.getBlockSize() == win.size());
     assert(cqt.getBlockSize() == slicer.getBlockSize());
     assert(cqt.getBlockSize() == splicer.getBlockSize());
     assert(cqt.getBlockSize() == xi.size());
-    assert(cqt.getBlockSize() == Xcq.rows());
 }
 
-double CqtDenseProcessor::processSample(double sample)
+template <typename T, typename Cqt, typename Block>
+BasicHopDriver<T, Cqt, Block>::~BasicHopDriver() = default;
+
+template <typename T, typename Cqt, typename Block>
+T BasicHopDriver<T, Cqt, Block>::processSample(T sample)
 {
     RealTimeChecker ck;
 
-    if (!cqt.isValid()) return 0.0; // inert: silence, never touch internals
+    if (!valid) return T(0); // inert: silence, never touch internals
+    if (worker) {
+        worker->process(&sample, &sample, 1);
+        return sample;
+    }
     slicer.pushSample(sample);
     sample = splicer.getSample();
-    if (slicer.hasBlock()) {
-        xi = slicer.getBlock();
-        assert(xi.size() == win.size());
-        assert(xi.size() == cqt.getBlockSize());
-        assert(xi.size() == Xcq.rows());
-        xi *= win;
-        cqt.forward(xi, Xcq);
-        processBlock(Xcq);
-        cqt.inverse(Xcq, xi);
-        xi *= win;
+    step(1);
+    if (slicer.hasBlock()) processHop();
+    return sample;
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::process(const T* input, T* output, Index n)
+{
+    RealTimeChecker ck;
+
+    if (!valid) {
+        std::fill(output, output + n, T(0));
+        return;
+    }
+    if (worker) worker->process(input, output, n);
+    else processDirect(input, output, n);
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::processDirect(const T* input, T* output, Index n)
+{
+    processRuns(slicer, splicer, input, output, n, [this] { processHop(); }, [this](Index run) { step(run); });
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::processHop()
+{
+    if (amortized) {
+        stages.finish([this](size_t i) { runStage(i); });
         splicer.pushBlock(xi);
+        xi = slicer.getBlock();
+        stages.start();
+        return;
     }
-    return sample;
+
+    xi = slicer.getBlock();
+    assert(xi.size() == win.size());
+    xi *= win;
+    analyze(xi);
+    runBlock();
+    if (delta) {
+        for (Index k = 0; k < cqt.getNumBands(); k++) inverseChange(k);
+        addChanges();
+    } else {
+        synthesize(xi);
+    }
+    xi *= win;
+    finishHop();
+    splicer.pushBlock(xi);
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::runBlock()
+{
+    Block& X = hopCoefs();
+    if (delta) Xref = X;
+    if (tap) tap->publish(X);
+    processBlock(X);
+    if (delta) findChanges();
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::runStage(size_t i)
+{
+    // processHop() one stage at a time; xi holds the block throughout.
+    auto [stage, k] = stageOf(i, cqt.getNumBands());
+    switch (stage) {
+        case JobStage::Start:
+            xi *= win;
+            cqt.forwardStart(xi);
+            break;
+        case JobStage::ForwardBand: analyzeBand(k); break;
+        case JobStage::Block: runBlock(); break;
+        case JobStage::InverseBand:
+            if (delta) inverseChange(k);
+            else synthesizeBand(k);
+            break;
+        case JobStage::Finish:
+            if (delta) addChanges();
+            else cqt.inverseFinish(xi);
+            xi *= win;
+            finishHop();
+            break;
+    }
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::findChanges()
+{
+    Block& X = hopCoefs();
+    nDirty   = 0;
+    for (Index k = 0; k < cqt.getNumBands(); k++) {
+        auto&& ref = bandOf(Xref, k);
+        auto&& cur = bandOf(X, k);
+        dirty[size_t(k)] = (cur != ref).any();
+        if (!dirty[size_t(k)]) continue;
+        ref = cur - ref;
+        nDirty++;
+    }
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::inverseChange(Index k)
+{
+    if (nDirty == 0) return;
+    if (dirty[size_t(k)]) cqt.inverseBand(k, Xref);
+    else cqt.inverseSkipBand(k);
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::addChanges()
+{
+    if (nDirty == 0) return;
+    cqt.inverseFinish(xd);
+    xi += xd;
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::setDeltaInverse(bool on)
+{
+    if (!valid || sliding) return;
+    settle(); // finish a pending job under the old setting
+    delta = on;
+    if (!on) return;
+    Xref = hopCoefs();
+    xd.setZero(cqt.getBlockSize());
+    dirty.assign(size_t(cqt.getNumBands()), false);
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::setAmortized(bool on)
+{
+    if (!valid) return;
+    // Settle the pending job (the sliding state must see every hop), then
+    // drop whatever xi holds: it was either already spliced or belongs to
+    // the other mode's timeline.
+    settle();
+    xi.setZero();
+    amortized = on;
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::settle()
+{
+    stages.finish([this](size_t i) { runStage(i); });
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::setSnapshotTap(SnapshotTap* t, const SnapshotOptions& options)
+{
+    tap = t;
+    if (tap && valid) tap->configure(hopCoefs(), options);
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::step(Index n)
+{
+    if (amortized) stages.advance(n, [this](size_t i) { runStage(i); });
+}
+
+template <typename T, typename Cqt, typename Block>
+void BasicHopDriver<T, Cqt, Block>::setAsync(bool on, const AsyncOptions& options)
+{
+    worker.reset();
+    if (!valid || !on) return;
+    Index latency = options.extraLatency > 0 ? options.extraLatency : slicer.getHopSize();
+    auto  run     = [this](const T* input, T* output, Index n) {
+        RealTimeChecker ck;
+        processDirect(input, output, n);
+    };
+    worker = std::make_unique<AsyncWorker<T>>(run, latency, slicer.getBlockSize(), options.cpu, options.realtime);
+}
+
+template <typename T, typename Cqt, typename Block>
+Index BasicHopDriver<T, Cqt, Block>::getDeadlineMisses() const
+{
+    return worker ? worker->getDeadlineMisses() : 0;
+}
+
+template <typename T, typename Cqt, typename Block>
+Index BasicHopDriver<T, Cqt, Block>::asyncLatency() const
+{
+    return worker ? worker->getLatency() : 0;
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicCqtDenseProcessor<T>::BasicCqtDenseProcessor(double sampleRate, Index numSamples,
+                                                  double fraction, double minFrequency,
+                                                  double maxFrequency, double refFrequency,
+                                                  Index overlap) :
+    Base(false, overlap, sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
+    Xcq(ComplexMatrix::Zero(cqt.getBlockSize(), cqt.getNumBands()))
+{
+}
+
+template <typename T>
+void BasicCqtDenseProcessor<T>::analyze(const RealArray& x)
+{
+    assert(x.size() == Xcq.rows());
+    cqt.forward(x, Xcq);
+}
+
+template <typename T>
+void BasicCqtDenseProcessor<T>::analyzeBand(Index k)
+{
+    cqt.forwardBand(k, Xcq);
+}
+
+template <typename T>
+void BasicCqtDenseProcessor<T>::synthesize(RealArray& x)
+{
+    cqt.inverse(Xcq, x);
+}
+
+template <typename T>
+void BasicCqtDenseProcessor<T>::synthesizeBand(Index k)
+{
+    cqt.inverseBand(k, Xcq);
 }
 
 //==========================================================================
 //==========================================================================
 
-CqtSparseProcessor::CqtSparseProcessor(double sampleRate, Index numSamples,
-                                       double fraction, double minFrequency,
-                                       double maxFrequency, double refFrequency) :
+template <typename T>
+BasicCqtSparseProcessor<T>::BasicCqtSparseProcessor(double sampleRate, Index numSamples,
+                                                    double fraction, double minFrequency,
+                                                    double maxFrequency, double refFrequency,
+                                                    SpanPolicy spanPolicy, Index overlap) :
+    Base(false, overlap, sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency, spanPolicy),
+    Xcq(cqt.getCoefs())
+{
+}
+
+template <typename T>
+void BasicCqtSparseProcessor<T>::analyze(const RealArray& x)
+{
+    assert(x.size() == cqt.getNumSamps());
+    cqt.forward(x, Xcq);
+}
+
+template <typename T>
+void BasicCqtSparseProcessor<T>::analyzeBand(Index k)
+{
+    cqt.forwardBand(k, Xcq);
+}
+
+template <typename T>
+void BasicCqtSparseProcessor<T>::synthesize(RealArray& x)
+{
+    cqt.inverse(Xcq, x);
+}
+
+template <typename T>
+void BasicCqtSparseProcessor<T>::synthesizeBand(Index k)
+{
+    cqt.inverseBand(k, Xcq);
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicSlidingCqtDenseProcessor<T>::BasicSlidingCqtDenseProcessor(double sampleRate, Index numSamples,
+                                                                double fraction, double minFrequency,
+                                                                double maxFrequency, double refFrequency,
+                                                                Index overlap) :
+    Base(true, overlap, sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency)
+{
+    if (!this->isValid()) return;
+
+    Index nBands    = cqt.getNumBands();
+    Index blockSize = cqt.getBlockSize();
+    ComplexMatrix coefs = ComplexMatrix::Zero(blockSize, nBands);
+    Xcq.fill(coefs, size_t(overlap));
+    Zcq.fill(ComplexMatrix::Zero(blockSize / overlap, nBands), size_t(overlap));
+    Ycq = coefs;
+
+    assert(blockSize == Xcq[0].rows());
+    assert(blockSize == Zcq[0].rows() * overlap);
+    assert(blockSize == Ycq.rows());
+}
+
+// Slice i spans hops i - R + 1 ... i (R = overlap); Xcq[j] and Zcq[j] are
+// the slice and the hop j steps back. Xcq[0] and Zcq[0] stay the current
+// slice and hop until finishHop() advances them.
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::analyze(const RealArray& x)
+{
+    cqt.forward(x, Xcq[0]);
+    for (Index k = 0; k < cqt.getNumBands(); k++) addSlice(k);
+}
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::analyzeBand(Index k)
+{
+    cqt.forwardBand(k, Xcq[0]);
+    addSlice(k);
+}
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::addSlice(Index k)
+{
+    // The first hop of slice i is the last one still missing a slice: with
+    // slice i it has all R of them, overlap-added under the squared window.
+    Index R   = Index(Xcq.size());
+    Index hop = this->getHopSize();
+    Xcq[0].col(k) *= this->getWindow();
+    Zcq[0].col(k) = Xcq[0].col(k).head(hop);
+    for (Index j = 1; j < R; j++) Zcq[0].col(k) += Xcq[j].col(k).segment(j * hop, hop);
+}
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::synthesize(RealArray& x)
+{
+    for (Index k = 0; k < cqt.getNumBands(); k++) gatherHops(k);
+    cqt.inverse(Ycq, x);
+}
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::synthesizeBand(Index k)
+{
+    gatherHops(k);
+    cqt.inverseBand(k, Ycq);
+}
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::gatherHops(Index k)
+{
+    Index R   = Index(Xcq.size());
+    Index hop = this->getHopSize();
+    for (Index j = 0; j < R; j++) Ycq.col(k).segment(j * hop, hop) = Zcq[R - 1 - j].col(k);
+    Ycq.col(k) *= this->getWindow();
+}
+
+template <typename T>
+void BasicSlidingCqtDenseProcessor<T>::finishHop()
+{
+    Xcq.advance();
+    Zcq.advance();
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicSlidingCqtSparseProcessor<T>::BasicSlidingCqtSparseProcessor(double sampleRate, Index numSamples,
+                                                                  double fraction, double minFrequency,
+                                                                  double maxFrequency, double refFrequency,
+                                                                  SpanPolicy spanPolicy, Index overlap) :
+    Base(true, overlap, sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency, spanPolicy)
+{
+    if (!this->isValid()) return;
+
+    Win = cqt.getFrame();
+    for (Index n = 0; n < cqt.getNumBands(); n++) {
+        Index sz = Win[n].size();
+        Win[n]   = wolaWindow(sz, overlap).template cast<T>();
+    }
+
+    Coefs coefs = cqt.getCoefs();
+    Coefs hops  = coefs;
+    for (auto& band : hops) band.setZero(band.size() / overlap);
+    Xcq.fill(coefs, size_t(overlap));
+    Zcq.fill(hops, size_t(overlap));
+    Ycq = coefs;
+}
+
+// As in the dense sliding processor, per band: band k's hop is
+// getLength(k)/R coefficients long.
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::analyze(const RealArray& x)
+{
+    cqt.forward(x, Xcq[0]);
+    for (Index k = 0; k < cqt.getNumBands(); k++) addSlice(k);
+}
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::analyzeBand(Index k)
+{
+    cqt.forwardBand(k, Xcq[0]);
+    addSlice(k);
+}
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::addSlice(Index k)
+{
+    Index R   = Index(Xcq.size());
+    Index hop = cqt.getLength(k) / R;
+    Xcq[0][k] *= Win[k];
+    Zcq[0][k] = Xcq[0][k].head(hop);
+    for (Index j = 1; j < R; j++) Zcq[0][k] += Xcq[j][k].segment(j * hop, hop);
+}
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::synthesize(RealArray& x)
+{
+    for (Index k = 0; k < cqt.getNumBands(); k++) gatherHops(k);
+    cqt.inverse(Ycq, x);
+}
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::synthesizeBand(Index k)
+{
+    gatherHops(k);
+    cqt.inverseBand(k, Ycq);
+}
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::gatherHops(Index k)
+{
+    Index R   = Index(Xcq.size());
+    Index hop = cqt.getLength(k) / R;
+    for (Index j = 0; j < R; j++) Ycq[k].segment(j * hop, hop) = Zcq[R - 1 - j][k];
+    Ycq[k] *= Win[k];
+}
+
+template <typename T>
+void BasicSlidingCqtSparseProcessor<T>::finishHop()
+{
+    Xcq.advance();
+    Zcq.advance();
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicMultirateCqtProcessor<T>::BasicMultirateCqtProcessor(double sampleRate, Index numSamples,
+                                                          double fraction, double minFrequency,
+                                                          double maxFrequency, double refFrequency,
+                                                          SpanPolicy spanPolicy)
+{
+    // Positive comparisons, so that NaNs fail too. The remaining conditions
+    // (sample rate, block size, atom support) are checked by the octave CQT
+    // itself.
+    double P  = std::round(1.0 / fraction);
+    bool   ok = P >= 2 && std::abs(1.0 / fraction - P) < 1e-9 * P && refFrequency > 0 &&
+              minFrequency > 0 && minFrequency < maxFrequency && 2 * maxFrequency < sampleRate;
+
+    // Octave 0 holds grid bands nTop - P + 1 ... nTop, the highest of which
+    // sits half a band below Nyquist; octave o holds the same bands shifted
+    // down by o·P. The requested range spans grid bands nLo ... nHi.
+    Index  ppo = ok ? Index(P) : 1;
+    Index  nTop = 0, nLo = 0, nHi = 0, nStages = 1;
+    double fTop = 0;
+    if (ok) {
+        nTop    = Index(std::floor(P * std::log2(sampleRate / (2 * refFrequency)) - 0.5));
+        nLo     = Index(std::floor(P * std::log2(minFrequency / refFrequency)));
+        nHi     = Index(std::ceil(P * std::log2(maxFrequency / refFrequency)));
+        nStages = std::max<Index>(nTop - nLo, 0) / ppo + 1;
+        fTop    = refFrequency * std::exp2(double(nTop) / P);
+    }
+
+    // Every stage uses the same CQT: exactly P bands ending at fTop (fMin
+    // and fMax fall strictly between grid points, so the band counts cannot
+    // be rounded either way), relative to the input rate.
+    double fLo = fTop * std::exp2(-(P - 1.5) / P);
+    double fHi = fTop * std::exp2(-0.25 / P);
+    stages.resize(size_t(nStages));
+    for (Index o = 0; o < nStages; o++) {
+        Index top = nTop - o * ppo;
+        bool  any = top >= nLo && top - ppo + 1 <= nHi;
+        if (any || o == nStages - 1)
+            stages[o].octave = std::make_unique<Octave>(*this, o, ok ? sampleRate : 0.0, numSamples,
+                                                        fraction, fLo, fHi, fTop, spanPolicy);
+    }
+    valid = ok;
+    for (const Stage& s : stages) valid = valid && (!s.octave || s.octave->isValid());
+    if (!valid) return;
+
+    ArrayXd h = halfBand(filterDelay, filterBeta);
+    taps      = ArrayXd(Map<ArrayXd, 0, InnerStride<2>>(h.data(), filterDelay + 1)).template cast<T>();
+
+    // Latency recursion, lowest stage up: stage o delays by
+    // 2·filterDelay (decimation + interpolation) plus twice the latency of
+    // stage o + 1, and its residual must wait for that minus its own CQT.
+    Index blockLatency = stages.back().octave->getLatency();
+    latency            = blockLatency;
+    for (Index o = nStages - 2; o >= 0; o--) {
+        Stage& s = stages[o];
+        s.delay  = s.octave ? 2 * latency - blockLatency : 2 * latency;
+        s.x.resize(2 * filterDelay + 1);
+        s.low.resize(filterDelay + 1);
+        s.lowOut.resize(filterDelay + 1);
+        s.residual.resize(s.delay + 1);
+        latency = 2 * filterDelay + 2 * latency;
+    }
+}
+
+template <typename T>
+void BasicMultirateCqtProcessor<T>::History::resize(Index minSize)
+{
+    buffer = RealArray::Zero(Index(nextPow2(size_t(minSize))));
+    mask   = buffer.size() - 1;
+    pos    = 0;
+}
+
+template <typename T>
+T BasicMultirateCqtProcessor<T>::processSample(T sample)
+{
+    RealTimeChecker ck;
+
+    if (!valid) return T(0); // inert: silence, never touch internals
+    return processStage(0, sample);
+}
+
+template <typename T>
+void BasicMultirateCqtProcessor<T>::process(const T* input, T* output, Index n)
+{
+    RealTimeChecker ck;
+
+    if (!valid) {
+        std::fill(output, output + n, T(0));
+        return;
+    }
+    for (Index i = 0; i < n; i++) output[i] = processStage(0, input[i]);
+}
+
+template <typename T>
+void BasicMultirateCqtProcessor<T>::setSnapshotTap(Index octave, SnapshotTap* tap, const SnapshotOptions& options)
+{
+    if (!valid) return;
+    assert(octave >= 0 && octave < getNumOctaves());
+    if (auto& o = stages[size_t(octave)].octave) o->setSnapshotTap(tap, options);
+}
+
+template <typename T>
+T BasicMultirateCqtProcessor<T>::processStage(Index o, T sample)
+{
+    Stage& s = stages[o];
+    if (o + 1 == Index(stages.size())) return s.octave->processSample(sample);
+
+    // Half-band split around a factor-2 rate change. With h[D] = 1/2 and
+    // the other odd taps zero, the decimator needs the even taps plus the
+    // centre, and the interpolator alternates between the even taps (even
+    // phase) and a pure delay (odd phase, 2·h[D] = 1).
+    constexpr Index D = filterDelay;
+    s.x.push(sample);
+    T lowpass, lower;
+    if (s.even) {
+        T l = T(0.5) * s.x(D);
+        for (Index i = 0; i <= D; i++) l += taps(i) * s.x(2 * i);
+        s.low.push(l);
+        s.lowOut.push(processStage(o + 1, l));
+
+        lowpass = lower = T(0);
+        for (Index i = 0; i <= D; i++) {
+            lowpass += taps(i) * s.low(i);
+            lower += taps(i) * s.lowOut(i);
+        }
+        lowpass *= T(2);
+        lower *= T(2);
+    } else {
+        lowpass = s.low((D - 1) / 2);
+        lower   = s.lowOut((D - 1) / 2);
+    }
+    s.even = !s.even;
+
+    // The residual is aligned with the interpolated lowpass (both delayed by
+    // 2D), so what the stage below returns plus the delayed residual is the
+    // input itself, delayed, whatever the filter response.
+    T high = s.x(2 * D) - lowpass;
+    s.residual.push(s.octave ? s.octave->processSample(high) : high);
+    return s.residual(s.delay) + lower;
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicMultiChannelCqtDenseProcessor<T>::BasicMultiChannelCqtDenseProcessor(Index numChannels, double sampleRate,
+                                                                          Index numSamples, double fraction,
+                                                                          double minFrequency, double maxFrequency,
+                                                                          double refFrequency, Index overlap) :
     cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
-    xi(cqt.getBlockSize()),
+    xi(RealMatrix::Zero(cqt.getBlockSize(), numChannels)),
     win(cqt.getBlockSize()),
-    Xcq(cqt.getCoefs()),
-    slicer(cqt.getBlockSize(), cqt.getBlockSize() / 2),
-    splicer(cqt.getBlockSize(), cqt.getBlockSize() / 2)
+    Xcq(size_t(numChannels), ComplexMatrix::Zero(cqt.getBlockSize(), cqt.getNumBands())),
+    slicers(size_t(numChannels), BasicSlicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    splicers(size_t(numChannels), BasicSplicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    taps(size_t(numChannels))
 {
-    if (!cqt.isValid()) return;
+    assert(numChannels >= 1);
+    valid = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
 
-    win = hann(cqt.getBlockSize()).sqrt();
-    xi.setZero();
+    win = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
+    cqt.reserveChannels(numChannels);
     assert(cqt.getBlockSize() == win.size());
-    assert(cqt.getBlockSize() == slicer.getBlockSize());
-    assert(cqt.getBlockSize() == splicer.getBlockSize());
-    assert(cqt.getBlockSize() == xi.size());
+    assert(cqt.getBlockSize() == slicers.front().getBlockSize());
+    assert(cqt.getBlockSize() == splicers.front().getBlockSize());
 }
 
-double CqtSparseProcessor::processSample(double sample)
+template <typename T>
+void BasicMultiChannelCqtDenseProcessor<T>::process(const T* const* inputs, T* const* outputs, Index n)
 {
     RealTimeChecker ck;
 
-    if (!cqt.isValid()) return 0.0; // inert: silence, never touch internals
-    slicer.pushSample(sample);
-    sample = splicer.getSample();
-    if (slicer.hasBlock()) {
-        xi = slicer.getBlock();
-        assert(xi.size() == win.size());
-        assert(xi.size() == cqt.getNumSamps());
-        xi *= win;
-        cqt.forward(xi, Xcq);
-        processBlock(Xcq);
-        cqt.inverse(Xcq, xi);
-        xi *= win;
-        splicer.pushBlock(xi);
+    if (!valid) {
+        silence(outputs, slicers.size(), n);
+        return;
     }
-    return sample;
+    processRunsMulti(slicers, splicers, inputs, outputs, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicMultiChannelCqtDenseProcessor<T>::processHop()
+{
+    assert(xi.rows() == win.size());
+    for (Index c = 0; c < xi.cols(); c++) xi.col(c) = slicers[c].getBlock() * win;
+    cqt.forward(xi, Xcq);
+    taps.publish(Xcq);
+    processBlock(Xcq);
+    cqt.inverse(Xcq, xi);
+    xi.colwise() *= win;
+    for (Index c = 0; c < xi.cols(); c++) splicers[c].pushBlock(xi.col(c));
+}
+
+template <typename T>
+void BasicMultiChannelCqtDenseProcessor<T>::setSnapshotTap(Index channel, SnapshotTap* t, const SnapshotOptions& options)
+{
+    if (valid) taps.attach(channel, t, Xcq, options);
 }
 
 //==========================================================================
 //==========================================================================
 
-SlidingCqtDenseProcessor::SlidingCqtDenseProcessor(double sampleRate, Index numSamples,
-                                                   double fraction, double minFrequency,
-                                                   double maxFrequency, double refFrequency) :
-    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
-    xi(cqt.getBlockSize()),
+template <typename T>
+BasicMultiChannelCqtSparseProcessor<T>::BasicMultiChannelCqtSparseProcessor(Index numChannels, double sampleRate,
+                                                                            Index numSamples, double fraction,
+                                                                            double minFrequency, double maxFrequency,
+                                                                            double refFrequency, SpanPolicy spanPolicy,
+                                                                            Index overlap) :
+    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency, spanPolicy),
+    xi(RealMatrix::Zero(cqt.getBlockSize(), numChannels)),
     win(cqt.getBlockSize()),
-    slicer(cqt.getBlockSize(), cqt.getBlockSize() / 2),
-    splicer(cqt.getBlockSize(), cqt.getBlockSize() / 2)
+    Xcq(cqt.getCoefs(numChannels)),
+    slicers(size_t(numChannels), BasicSlicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    splicers(size_t(numChannels), BasicSplicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    taps(size_t(numChannels))
+{
+    assert(numChannels >= 1);
+    valid = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
+
+    win = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
+    cqt.reserveChannels(numChannels);
+    assert(cqt.getBlockSize() == win.size());
+    assert(cqt.getBlockSize() == slicers.front().getBlockSize());
+    assert(cqt.getBlockSize() == splicers.front().getBlockSize());
+}
 
+template <typename T>
+void BasicMultiChannelCqtSparseProcessor<T>::process(const T* const* inputs, T* const* outputs, Index n)
 {
-    if (!cqt.isValid()) return;
+    RealTimeChecker ck;
+
+    if (!valid) {
+        silence(outputs, slicers.size(), n);
+        return;
+    }
+    processRunsMulti(slicers, splicers, inputs, outputs, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicMultiChannelCqtSparseProcessor<T>::processHop()
+{
+    assert(xi.rows() == win.size());
+    for (Index c = 0; c < xi.cols(); c++) xi.col(c) = slicers[c].getBlock() * win;
+    cqt.forward(xi, Xcq);
+    taps.publish(Xcq);
+    processBlock(Xcq);
+    cqt.inverse(Xcq, xi);
+    xi.colwise() *= win;
+    for (Index c = 0; c < xi.cols(); c++) splicers[c].pushBlock(xi.col(c));
+}
 
-    Index nBands         = cqt.getNumBands();
-    Index blockSize      = cqt.getBlockSize();
-    win                  = hann(blockSize).sqrt();
-    ArrayXXcd coefs      = ArrayXXcd::Zero(blockSize, nBands);
-    ArrayXXcd validCoefs = ArrayXXcd::Zero(blockSize / 2, nBands);
-    Xcq.fill(coefs);
-    Zcq.fill(validCoefs);
+template <typename T>
+void BasicMultiChannelCqtSparseProcessor<T>::setSnapshotTap(Index channel, SnapshotTap* t, const SnapshotOptions& options)
+{
+    if (valid) taps.attach(channel, t, Xcq, options);
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicMultiChannelSlidingCqtDenseProcessor<T>::BasicMultiChannelSlidingCqtDenseProcessor(Index numChannels, double sampleRate,
+                                                                                        Index numSamples, double fraction,
+                                                                                        double minFrequency, double maxFrequency,
+                                                                                        double refFrequency, Index overlap) :
+    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
+    xi(RealMatrix::Zero(cqt.getBlockSize(), numChannels)),
+    win(cqt.getBlockSize()),
+    slicers(size_t(numChannels), BasicSlicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    splicers(size_t(numChannels), BasicSplicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    taps(size_t(numChannels))
+{
+    assert(numChannels >= 1);
+    valid = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
+
+    Index nBands    = cqt.getNumBands();
+    Index blockSize = cqt.getBlockSize();
+    win             = wolaWindow(blockSize, overlap).template cast<T>();
+    MultiCoefs coefs(size_t(numChannels), ComplexMatrix::Zero(blockSize, nBands));
+    Xcq.fill(coefs, size_t(overlap));
+    Zcq.fill(MultiCoefs(size_t(numChannels), ComplexMatrix::Zero(blockSize / overlap, nBands)), size_t(overlap));
     Ycq = coefs;
+    cqt.reserveChannels(numChannels);
 
-    assert(blockSize == cqt.getNumSamps());
     assert(blockSize == win.size());
-    assert(blockSize == slicer.getBlockSize());
-    assert(blockSize == splicer.getBlockSize());
-    assert(blockSize == xi.size());
-    assert(blockSize == Xcq.current().rows());
-    assert(blockSize == Xcq.last().rows());
-    assert(blockSize == Zcq.current().rows() * 2);
-    assert(blockSize == Zcq.last().rows() * 2);
-    assert(blockSize == Ycq.rows());
+    assert(blockSize == slicers.front().getBlockSize());
+    assert(blockSize == splicers.front().getBlockSize());
+}
+
+template <typename T>
+void BasicMultiChannelSlidingCqtDenseProcessor<T>::process(const T* const* inputs, T* const* outputs, Index n)
+{
+    RealTimeChecker ck;
+
+    if (!valid) {
+        silence(outputs, slicers.size(), n);
+        return;
+    }
+    processRunsMulti(slicers, splicers, inputs, outputs, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicMultiChannelSlidingCqtDenseProcessor<T>::processHop()
+{
+    // BasicSlidingCqtDenseProcessor::processHop() on every channel.
+    MultiCoefs& Xi = Xcq[0];
+    MultiCoefs& Zi = Zcq[0];
+    MultiCoefs& Yi = Ycq;
+
+    Index nCh = xi.cols();
+    Index R   = Index(Xcq.size());
+    Index hop = xi.rows() / R;
+    assert(xi.rows() == win.size());
+
+    for (Index c = 0; c < nCh; c++) xi.col(c) = slicers[c].getBlock() * win;
+
+    cqt.forward(xi, Xi);
+    for (Index c = 0; c < nCh; c++) {
+        Xi[c].colwise() *= win;
+        Zi[c] = Xi[c].topRows(hop);
+        for (Index j = 1; j < R; j++) Zi[c] += Xcq[j][c].middleRows(j * hop, hop);
+    }
+
+    taps.publish(Zi);
+    processBlock(Zi);
+
+    for (Index c = 0; c < nCh; c++) {
+        for (Index j = 0; j < R; j++) Yi[c].middleRows(j * hop, hop) = Zcq[R - 1 - j][c];
+        Yi[c].colwise() *= win;
+    }
+
+    cqt.inverse(Yi, xi);
+    xi.colwise() *= win;
+    for (Index c = 0; c < nCh; c++) splicers[c].pushBlock(xi.col(c));
+    Xcq.advance();
+    Zcq.advance();
+}
+
+template <typename T>
+void BasicMultiChannelSlidingCqtDenseProcessor<T>::setSnapshotTap(Index channel, SnapshotTap* t, const SnapshotOptions& options)
+{
+    if (valid) taps.attach(channel, t, Zcq[0], options);
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicMultiChannelSlidingCqtSparseProcessor<T>::BasicMultiChannelSlidingCqtSparseProcessor(Index numChannels, double sampleRate,
+                                                                                          Index numSamples, double fraction,
+                                                                                          double minFrequency, double maxFrequency,
+                                                                                          double refFrequency, SpanPolicy spanPolicy,
+                                                                                          Index overlap) :
+    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency, spanPolicy),
+    xi(RealMatrix::Zero(cqt.getBlockSize(), numChannels)),
+    win(cqt.getBlockSize()),
+    slicers(size_t(numChannels), BasicSlicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    splicers(size_t(numChannels), BasicSplicer<T>(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))),
+    taps(size_t(numChannels))
+{
+    assert(numChannels >= 1);
+    valid = slidingOk(cqt, overlap);
+    if (!valid) return;
+
+    Index nBands = cqt.getNumBands();
+    win          = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
+    Win          = cqt.getFrame();
+    for (Index k = 0; k < nBands; k++) Win[k] = wolaWindow(Win[k].size(), overlap).template cast<T>();
+
+    MultiCoefs coefs = cqt.getCoefs(numChannels);
+    MultiCoefs hops  = coefs;
+    for (auto& channel : hops)
+        for (auto& band : channel) band.setZero(band.size() / overlap);
+    Xcq.fill(coefs, size_t(overlap));
+    Zcq.fill(hops, size_t(overlap));
+    Ycq = coefs;
+    cqt.reserveChannels(numChannels);
+
+    assert(cqt.getBlockSize() == win.size());
+    assert(cqt.getBlockSize() == slicers.front().getBlockSize());
+    assert(cqt.getBlockSize() == splicers.front().getBlockSize());
 }
 
-double SlidingCqtDenseProcessor::processSample(double sample)
+template <typename T>
+void BasicMultiChannelSlidingCqtSparseProcessor<T>::process(const T* const* inputs, T* const* outputs, Index n)
 {
     RealTimeChecker ck;
 
-    if (!cqt.isValid()) return 0.0; // inert: silence, never touch internals
+    if (!valid) {
+        silence(outputs, slicers.size(), n);
+        return;
+    }
+    processRunsMulti(slicers, splicers, inputs, outputs, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicMultiChannelSlidingCqtSparseProcessor<T>::processHop()
+{
+    // BasicSlidingCqtSparseProcessor::processHop() on every channel.
+    MultiCoefs& Xi     = Xcq[0];
+    MultiCoefs& Zi     = Zcq[0];
+    MultiCoefs& Yi     = Ycq;
+    Index       nCh    = xi.cols();
+    Index       R      = Index(Xcq.size());
+    Index       nBands = cqt.getNumBands();
+    assert(xi.rows() == win.size());
+
+    for (Index c = 0; c < nCh; c++) xi.col(c) = slicers[c].getBlock() * win;
+
+    cqt.forward(xi, Xi);
+
+    for (Index c = 0; c < nCh; c++)
+        for (Index k = 0; k < nBands; k++) {
+            Index hop = cqt.getLength(k) / R;
+            Xi[c][k] *= Win[k];
+            Zi[c][k] = Xi[c][k].head(hop);
+            for (Index j = 1; j < R; j++) Zi[c][k] += Xcq[j][c][k].segment(j * hop, hop);
+        }
+
+    taps.publish(Zi);
+    processBlock(Zi);
+
+    for (Index c = 0; c < nCh; c++)
+        for (Index k = 0; k < nBands; k++) {
+            Index hop = cqt.getLength(k) / R;
+            for (Index j = 0; j < R; j++) Yi[c][k].segment(j * hop, hop) = Zcq[R - 1 - j][c][k];
+            Yi[c][k] *= Win[k];
+        }
+
+    cqt.inverse(Yi, xi);
+    xi.colwise() *= win;
+    for (Index c = 0; c < nCh; c++) splicers[c].pushBlock(xi.col(c));
+    Xcq.advance();
+    Zcq.advance();
+}
+
+template <typename T>
+void BasicMultiChannelSlidingCqtSparseProcessor<T>::setSnapshotTap(Index channel, SnapshotTap* t, const SnapshotOptions& options)
+{
+    if (valid) taps.attach(channel, t, Zcq[0], options);
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicCqtDenseAnalyzer<T>::BasicCqtDenseAnalyzer(double sampleRate, Index numSamples,
+                                                double fraction, double minFrequency,
+                                                double maxFrequency, double refFrequency,
+                                                Index overlap) :
+    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
+    xi(cqt.getBlockSize()),
+    win(cqt.getBlockSize()),
+    Xcq(cqt.getBlockSize(), cqt.getNumBands()),
+    energies(RealArray::Zero(cqt.getNumBands())),
+    slicer(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))
+{
+    valid = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
+
+    win = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
+    xi.setZero();
+    Xcq.setZero();
+}
+
+template <typename T>
+void BasicCqtDenseAnalyzer<T>::processSample(T sample)
+{
+    RealTimeChecker ck;
+
+    if (!valid) return;
     slicer.pushSample(sample);
-    sample = splicer.getSample();
-    if (slicer.hasBlock()) {
-        Eigen::ArrayXXcd& Xi   = Xcq.current();
-        Eigen::ArrayXXcd& Xim1 = Xcq.last();
-        Eigen::ArrayXXcd& Zi   = Zcq.current();
-        Eigen::ArrayXXcd& Zim1 = Zcq.last();
-        Eigen::ArrayXXcd& Yi   = Ycq;
-
-        Index sz = xi.size();
-        Index ol = sz / 2;
-
-        assert(sz == Xi.rows());
-        assert(sz == 2 * Zi.rows());
-        assert(sz == Ycq.rows());
-        assert(sz == xi.size());
-        assert(sz == win.size());
-        assert(sz == cqt.getNumSamps());
+    if (slicer.hasBlock()) processHop();
+}
 
-        xi = slicer.getBlock();
-        xi *= win; // xi *= win; xi /= 2;
+template <typename T>
+void BasicCqtDenseAnalyzer<T>::process(const T* input, Index n)
+{
+    RealTimeChecker ck;
+
+    if (!valid) return;
+    analyzeRuns(slicer, input, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicCqtDenseAnalyzer<T>::processHop()
+{
+    xi = slicer.getBlock();
+    xi *= win;
+    if (energyOnly) {
+        cqt.bandEnergies(xi, energies);
+        processEnergies(energies);
+        return;
+    }
+    cqt.forward(xi, Xcq);
+    if (tap) tap->publish(Xcq);
+    processBlock(Xcq);
+}
 
-        cqt.forward(xi, Xi);
-        Xi.colwise() *= win;
-        Zi = Xi.topRows(ol) + Xim1.bottomRows(ol);
+template <typename T>
+void BasicCqtDenseAnalyzer<T>::setSnapshotTap(SnapshotTap* t, const SnapshotOptions& options)
+{
+    tap = t;
+    if (tap && valid) tap->configure(Xcq, options);
+}
 
-        processBlock(Zi);
+//==========================================================================
+//==========================================================================
 
-        Yi.topRows(ol)    = Zim1;
-        Yi.bottomRows(ol) = Zi;
+template <typename T>
+BasicCqtSparseAnalyzer<T>::BasicCqtSparseAnalyzer(double sampleRate, Index numSamples,
+                                                  double fraction, double minFrequency,
+                                                  double maxFrequency, double refFrequency,
+                                                  SpanPolicy spanPolicy, Index overlap) :
+    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency, spanPolicy),
+    xi(cqt.getBlockSize()),
+    win(cqt.getBlockSize()),
+    Xcq(cqt.getCoefs()),
+    energies(RealArray::Zero(cqt.getNumBands())),
+    slicer(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))
+{
+    valid = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
 
-        Yi.colwise() *= win;
+    win = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
+    xi.setZero();
+}
 
-        cqt.inverse(Yi, xi);
-        xi *= win;
+template <typename T>
+void BasicCqtSparseAnalyzer<T>::processSample(T sample)
+{
+    RealTimeChecker ck;
 
-        splicer.pushBlock(xi);
-        Xcq.advance();
-        Zcq.advance();
+    if (!valid) return;
+    slicer.pushSample(sample);
+    if (slicer.hasBlock()) processHop();
+}
+
+template <typename T>
+void BasicCqtSparseAnalyzer<T>::process(const T* input, Index n)
+{
+    RealTimeChecker ck;
+
+    if (!valid) return;
+    analyzeRuns(slicer, input, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicCqtSparseAnalyzer<T>::processHop()
+{
+    xi = slicer.getBlock();
+    xi *= win;
+    if (energyOnly) {
+        cqt.bandEnergies(xi, energies);
+        processEnergies(energies);
+        return;
     }
-    return sample;
+    cqt.forward(xi, Xcq);
+    if (tap) tap->publish(Xcq);
+    processBlock(Xcq);
+}
+
+template <typename T>
+void BasicCqtSparseAnalyzer<T>::setSnapshotTap(SnapshotTap* t, const SnapshotOptions& options)
+{
+    tap = t;
+    if (tap && valid) tap->configure(Xcq, options);
 }
 
 //==========================================================================
 //==========================================================================
 
-SlidingCqtSparseProcessor::SlidingCqtSparseProcessor(double sampleRate, Index numSamples,
-                                                     double fraction, double minFrequency,
-                                                     double maxFrequency, double refFrequency) :
+template <typename T>
+BasicSlidingCqtDenseAnalyzer<T>::BasicSlidingCqtDenseAnalyzer(double sampleRate, Index numSamples,
+                                                              double fraction, double minFrequency,
+                                                              double maxFrequency, double refFrequency,
+                                                              Index overlap) :
     cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency),
     xi(cqt.getBlockSize()),
     win(cqt.getBlockSize()),
-    slicer(cqt.getBlockSize(), cqt.getBlockSize() / 2),
-    splicer(cqt.getBlockSize(), cqt.getBlockSize() / 2)
+    slicer(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))
 {
-    if (!cqt.isValid()) return;
+    valid = cqt.isValid() && overlapOk(cqt.getBlockSize(), overlap);
+    if (!valid) return;
 
     Index nBands    = cqt.getNumBands();
     Index blockSize = cqt.getBlockSize();
+    win             = wolaWindow(blockSize, overlap).template cast<T>();
     xi.setZero();
-    win = hann(blockSize).sqrt();
-    Win = cqt.getFrame();
+    Xcq.fill(ComplexMatrix::Zero(blockSize, nBands), size_t(overlap));
+    Zcq = ComplexMatrix::Zero(blockSize / overlap, nBands);
+}
 
-    for (Index n = 0; n < nBands; n++) {
-        Index sz = Win[n].size();
-        Win[n]   = hann(sz).sqrt();
-    }
+template <typename T>
+void BasicSlidingCqtDenseAnalyzer<T>::processSample(T sample)
+{
+    RealTimeChecker ck;
 
-    auto coefs      = cqt.getCoefs();
-    auto validCoefs = cqt.getValidCoefs();
-    Xcq.fill(coefs);
-    Zcq.fill(validCoefs);
-    Ycq = coefs;
+    if (!valid) return;
+    slicer.pushSample(sample);
+    if (slicer.hasBlock()) processHop();
+}
 
-    assert(blockSize == cqt.getBlockSize());
-    assert(blockSize == win.size());
-    assert(blockSize == slicer.getBlockSize());
-    assert(blockSize == splicer.getBlockSize());
-    assert(blockSize == xi.size());
+template <typename T>
+void BasicSlidingCqtDenseAnalyzer<T>::process(const T* input, Index n)
+{
+    RealTimeChecker ck;
+
+    if (!valid) return;
+    analyzeRuns(slicer, input, n, [this] { processHop(); });
+}
+
+template <typename T>
+void BasicSlidingCqtDenseAnalyzer<T>::processHop()
+{
+    // The analysis half of BasicSlidingCqtDenseProcessor::processHop().
+    ComplexMatrix& Xi  = Xcq[0];
+    Index          R   = Index(Xcq.size());
+    Index          hop = xi.size() / R;
+
+    xi = slicer.getBlock();
+    xi *= win;
+    cqt.forward(xi, Xi);
+    Xi.colwise() *= win;
+
+    Zcq = Xi.topRows(hop);
+    for (Index j = 1; j < R; j++) Zcq += Xcq[j].middleRows(j * hop, hop);
+
+    if (tap) tap->publish(Zcq);
+    processBlock(Zcq);
+    Xcq.advance();
+}
+
+template <typename T>
+void BasicSlidingCqtDenseAnalyzer<T>::setSnapshotTap(SnapshotTap* t, const SnapshotOptions& options)
+{
+    tap = t;
+    if (tap && valid) tap->configure(Zcq, options);
+}
+
+//==========================================================================
+//==========================================================================
+
+template <typename T>
+BasicSlidingCqtSparseAnalyzer<T>::BasicSlidingCqtSparseAnalyzer(double sampleRate, Index numSamples,
+                                                                double fraction, double minFrequency,
+                                                                double maxFrequency, double refFrequency,
+                                                                SpanPolicy spanPolicy, Index overlap) :
+    cqt(sampleRate, numSamples, fraction, minFrequency, maxFrequency, refFrequency, spanPolicy),
+    xi(cqt.getBlockSize()),
+    win(cqt.getBlockSize()),
+    slicer(cqt.getBlockSize(), hopOf(cqt.getBlockSize(), overlap))
+{
+    valid = slidingOk(cqt, overlap);
+    if (!valid) return;
+
+    xi.setZero();
+    win = wolaWindow(cqt.getBlockSize(), overlap).template cast<T>();
+    Win = cqt.getFrame();
+    for (auto& w : Win) w = wolaWindow(w.size(), overlap).template cast<T>();
+
+    Coefs coefs = cqt.getCoefs();
+    Xcq.fill(coefs, size_t(overlap));
+    Zcq = coefs;
+    for (auto& band : Zcq) band.setZero(band.size() / overlap);
 }
 
-double SlidingCqtSparseProcessor::processSample(double sample)
+template <typename T>
+void BasicSlidingCqtSparseAnalyzer<T>::processSample(T sample)
 {
     RealTimeChecker ck;
 
-    if (!cqt.isValid()) return 0.0; // inert: silence, never touch internals
+    if (!valid) return;
     slicer.pushSample(sample);
-    sample = splicer.getSample();
-    if (slicer.hasBlock()) {
-        NsgfCqtSparse::Coefs& Xi     = Xcq.current();
-        NsgfCqtSparse::Coefs& Xim1   = Xcq.last();
-        NsgfCqtSparse::Coefs& Zi     = Zcq.current();
-        NsgfCqtSparse::Coefs& Zim1   = Zcq.last();
-        NsgfCqtSparse::Coefs& Yi     = Ycq;
-        Index                 nBands = cqt.getNumBands();
-        assert(xi.size() == cqt.getBlockSize());
-        xi = slicer.getBlock();
+    if (slicer.hasBlock()) processHop();
+}
 
-        xi *= win;
+template <typename T>
+void BasicSlidingCqtSparseAnalyzer<T>::process(const T* input, Index n)
+{
+    RealTimeChecker ck;
 
-        cqt.forward(xi, Xi);
+    if (!valid) return;
+    analyzeRuns(slicer, input, n, [this] { processHop(); });
+}
 
-        for (Index k = 0; k < nBands; k++) {
-            Xi[k] *= Win[k];
-        }
+template <typename T>
+void BasicSlidingCqtSparseAnalyzer<T>::processHop()
+{
+    // The analysis half of BasicSlidingCqtSparseProcessor::processHop().
+    Coefs& Xi     = Xcq[0];
+    Index  R      = Index(Xcq.size());
+    Index  nBands = cqt.getNumBands();
 
-        for (Index k = 0; k < nBands; k++) {
-            Index ol = cqt.getLength(k) / 2;
-            Zi[k]    = Xim1[k].tail(ol) + Xi[k].head(ol);
-        }
+    xi = slicer.getBlock();
+    xi *= win;
+    cqt.forward(xi, Xi);
 
-        processBlock(Zi);
+    for (Index k = 0; k < nBands; k++) {
+        Index hop = cqt.getLength(k) / R;
+        Xi[k] *= Win[k];
+        Zcq[k] = Xi[k].head(hop);
+        for (Index j = 1; j < R; j++) Zcq[k] += Xcq[j][k].segment(j * hop, hop);
+    }
 
-        for (Index k = 0; k < nBands; k++) {
-            Index ol       = cqt.getLength(k) / 2;
-            Yi[k].head(ol) = Zim1[k];
-            Yi[k].tail(ol) = Zi[k];
-        }
-        for (Index k = 0; k < nBands; k++) {
-            Yi[k] *= Win[k];
-        }
+    if (tap) tap->publish(Zcq);
+    processBlock(Zcq);
+    Xcq.advance();
+}
 
-        cqt.inverse(Yi, xi);
-        xi *= win;
-        splicer.pushBlock(xi);
-        Xcq.advance();
-        Zcq.advance();
-    }
-    return sample;
+template <typename T>
+void BasicSlidingCqtSparseAnalyzer<T>::setSnapshotTap(SnapshotTap* t, const SnapshotOptions& options)
+{
+    tap = t;
+    if (tap && valid) tap->configure(Zcq, options);
 }
+
+//==========================================================================
+
+template class jsa::cicuetea::BasicHopDriver<float, BasicNsgfCqtDense<float>, BasicNsgfCqtDense<float>::ComplexMatrix>;
+template class jsa::cicuetea::BasicHopDriver<double, BasicNsgfCqtDense<double>, BasicNsgfCqtDense<double>::ComplexMatrix>;
+template class jsa::cicuetea::BasicHopDriver<float, BasicNsgfCqtSparse<float>, BasicNsgfCqtSparse<float>::Coefs>;
+template class jsa::cicuetea::BasicHopDriver<double, BasicNsgfCqtSparse<double>, BasicNsgfCqtSparse<double>::Coefs>;
+template class jsa::cicuetea::BasicCqtDenseProcessor<float>;
+template class jsa::cicuetea::BasicCqtDenseProcessor<double>;
+template class jsa::cicuetea::BasicCqtSparseProcessor<float>;
+template class jsa::cicuetea::BasicCqtSparseProcessor<double>;
+template class jsa::cicuetea::BasicSlidingCqtDenseProcessor<float>;
+template class jsa::cicuetea::BasicSlidingCqtDenseProcessor<double>;
+template class jsa::cicuetea::BasicSlidingCqtSparseProcessor<float>;
+template class jsa::cicuetea::BasicSlidingCqtSparseProcessor<double>;
+template class jsa::cicuetea::BasicMultirateCqtProcessor<float>;
+template class jsa::cicuetea::BasicMultirateCqtProcessor<double>;
+template class jsa::cicuetea::BasicMultiChannelCqtDenseProcessor<float>;
+template class jsa::cicuetea::BasicMultiChannelCqtDenseProcessor<double>;
+template class jsa::cicuetea::BasicMultiChannelCqtSparseProcessor<float>;
+template class jsa::cicuetea::BasicMultiChannelCqtSparseProcessor<double>;
+template class jsa::cicuetea::BasicMultiChannelSlidingCqtDenseProcessor<float>;
+template class jsa::cicuetea::BasicMultiChannelSlidingCqtDenseProcessor<double>;
+template class jsa::cicuetea::BasicMultiChannelSlidingCqtSparseProcessor<float>;
+template class jsa::cicuetea::BasicMultiChannelSlidingCqtSparseProcessor<double>;
+template class jsa::cicuetea::BasicCqtDenseAnalyzer<float>;
+template class jsa::cicuetea::BasicCqtDenseAnalyzer<double>;
+template class jsa::cicuetea::BasicCqtSparseAnalyzer<float>;
+template class jsa::cicuetea::BasicCqtSparseAnalyzer<double>;
+template class jsa::cicuetea::BasicSlidingCqtDenseAnalyzer<float>;
+template class jsa::cicuetea::BasicSlidingCqtDenseAnalyzer<double>;
+template class jsa::cicuetea::BasicSlidingCqtSparseAnalyzer<float>;
+template class jsa::cicuetea::BasicSlidingCqtSparseAnalyzer<double>;
@@ -7,84 +7,519 @@
 
 #include "FFT.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
 
-#ifdef FFT_FFTW
-#    include "FFT_FFTW.h"
-#endif
+#include "FFT_Backends.h"
+#include "FFT_Codelets.h"
 
-#ifdef FFT_PFFFT
-#    include "FFT_PFFFT.h"
-#endif
+using namespace jsa::cicuetea;
+using namespace Eigen;
 
-#ifdef FFT_VDSP
-#    include "FFT_vDSP.h"
-#endif
+namespace {
+/// Serializes plan creation and destruction: planners (FFTW's in
+/// particular) are not thread-safe, executing distinct plans is.
+std::mutex& planMutex()
+{
+    static std::mutex m;
+    return m;
+}
 
-#ifdef FFT_MKL
-#    include "FFT_MKL.h"
-#endif
+/// Rigor new DFTs of precision T are planned with.
+template <typename T>
+std::atomic<PlanRigor>& planRigor()
+{
+    static std::atomic<PlanRigor> rigor{PlanRigor::Estimate};
+    return rigor;
+}
 
-using namespace jsa::cicuetea;
-using namespace Eigen;
+/// Largest size new DFTs of precision T run through a codelet.
+template <typename T>
+std::atomic<size_t>& maxCodelet()
+{
+    static std::atomic<size_t> n{codelets::maxCodeletSize};
+    return n;
+}
 
-DFT::DFT(size_t fftSize) : pImpl(std::make_unique<DFTImpl>(fftSize)) {}
-DFT::DFT() = default; // unplanned: pImpl stays null, transforms must not be called
-DFT::~DFT()                         = default;
-DFT::DFT(DFT&&) noexcept            = default;
-DFT& DFT::operator=(DFT&&) noexcept = default;
+/// Backend of new DFTs of precision T whose size has no tuned route.
+template <typename T>
+std::atomic<DFTBackend>& defaultBackend()
+{
+    static std::atomic<DFTBackend> backend{compiledBackends<T>().front().id};
+    return backend;
+}
+
+template <typename T>
+std::atomic<bool>& autoTune()
+{
+    static std::atomic<bool> enabled{false};
+    return enabled;
+}
+
+/// Tuned routes of precision T: the fastest backend per size. Guarded by
+/// planMutex().
+template <typename T>
+std::map<size_t, DFTBackend>& tunedRoutes()
+{
+    static std::map<size_t, DFTBackend> routes;
+    return routes;
+}
 
-void DFT::dft(const ArrayXcd& X, ArrayXcd& Y)
+template <typename T>
+const BackendInfo<T>* findBackend(DFTBackend id)
 {
-    pImpl->dft(X.data(), Y.data());
+    for (const auto& info : compiledBackends<T>())
+        if (info.id == id) return &info;
+    return nullptr;
 }
 
-void DFT::idft(const ArrayXcd& X, ArrayXcd& Y)
+/// Plan registry: the backend plans of each (backend, size, rigor) are built
+/// once and shared by every live DFT of that size (a sparse CQT's bands
+/// repeat a few span lengths, and instances of one configuration repeat all
+/// of them). Tracked weakly, so a size's plans go away with its last DFT.
+/// Guarded by planMutex(), like everything that creates or destroys plans.
+template <typename T>
+std::map<std::tuple<DFTBackend, size_t, PlanRigor>, std::weak_ptr<const void>>& planRegistry()
 {
-    pImpl->idft(X.data(), Y.data());
+    static std::map<std::tuple<DFTBackend, size_t, PlanRigor>, std::weak_ptr<const void>> plans;
+    return plans;
 }
 
-void DFT::rdft(const ArrayXd& x, ArrayXcd& X)
+template <typename T>
+std::unique_ptr<DFTImpl<T>> makeImpl(const BackendInfo<T>& info, size_t fftSize, PlanRigor rigor)
+{
+    auto& registry = planRegistry<T>();
+    auto& entry    = registry[{info.id, fftSize, rigor}];
+    if (auto plans = entry.lock()) return info.make(std::move(plans));
+
+    std::shared_ptr<const void> plans = info.makePlans(fftSize, rigor);
+    entry                             = plans;
+    for (auto it = registry.begin(); it != registry.end();) {
+        if (it->second.expired()) it = registry.erase(it);
+        else ++it;
+    }
+    return info.make(std::move(plans));
+}
+
+/// Times one transform set (dft, idft, rdft, irdft) on every backend that
+/// plans the size and returns the fastest; best of three runs, the first
+/// also warming up. Called with planMutex() held.
+template <typename T>
+DFTBackend fastest(size_t fftSize)
+{
+    using Complex = std::complex<T>;
+
+    const auto& backends = compiledBackends<T>();
+    DFTBackend  best     = defaultBackend<T>().load();
+    if (backends.size() == 1) return best;
+
+    Index                      n = Index(fftSize);
+    Array<Complex, Dynamic, 1> a = Array<Complex, Dynamic, 1>::Random(n), b(n);
+    Array<T, Dynamic, 1>       r = Array<T, Dynamic, 1>::Random(n);
+
+    PlanRigor rigor    = planRigor<T>().load();
+    int       reps     = std::max(4, int((size_t(1) << 18) / fftSize));
+    double    bestTime = std::numeric_limits<double>::infinity();
+    for (const auto& info : backends) {
+        if (!info.supports(fftSize)) continue;
+        auto   impl = makeImpl(info, fftSize, rigor);
+        double time = std::numeric_limits<double>::infinity();
+        for (int run = 0; run < 3; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < reps; i++) {
+                impl->dft(a.data(), b.data());
+                impl->idft(b.data(), a.data());
+                impl->rdft(r.data(), b.data());
+                impl->irdft(b.data(), r.data());
+            }
+            time = std::min(time, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        if (time < bestTime) {
+            bestTime = time;
+            best     = info.id;
+        }
+    }
+    return best;
+}
+
+/// The backend a size-only DFT of this size runs on (planMutex() held):
+/// the tuned route, tuning the size first under auto-tuning, otherwise the
+/// default backend, or the first backend that plans the size if the
+/// default does not. Only backends that plan the size qualify (a tuning
+/// file may name any), so this is null when no compiled-in backend does.
+template <typename T>
+const BackendInfo<T>* route(size_t fftSize)
+{
+    auto& routes = tunedRoutes<T>();
+    auto  it     = routes.find(fftSize);
+    if (it == routes.end() && autoTune<T>().load()) it = routes.emplace(fftSize, fastest<T>(fftSize)).first;
+    if (it != routes.end())
+        if (const auto* info = findBackend<T>(it->second); info && info->supports(fftSize)) return info;
+
+    const BackendInfo<T>* fallback = findBackend<T>(defaultBackend<T>().load());
+    if (fallback->supports(fftSize)) return fallback;
+    for (const auto& info : compiledBackends<T>())
+        if (info.supports(fftSize)) return &info;
+    return nullptr;
+}
+
+template <typename T>
+const char* precisionTag()
+{
+    return sizeof(T) == sizeof(float) ? "float" : "double";
+}
+} // namespace
+
+template <typename T>
+BasicDFT<T>::BasicDFT(size_t fftSize)
+{
+    std::lock_guard<std::mutex> lock(planMutex());
+    const BackendInfo<T>*       info = route<T>(fftSize);
+    assert(info && "no compiled-in backend plans this size (see isSupported())");
+    if (!info) return; // left unplanned
+
+    pImpl          = makeImpl(*info, fftSize, planRigor<T>().load());
+    size_t limit   = maxCodelet<T>().load();
+    forwardCodelet = codelets::find<T>(fftSize, limit, false);
+    inverseCodelet = codelets::find<T>(fftSize, limit, true);
+}
+template <typename T>
+BasicDFT<T>::BasicDFT(size_t fftSize, DFTBackend backend)
+{
+    const BackendInfo<T>* info = findBackend<T>(backend);
+    if (!info || !info->supports(fftSize)) {
+        *this = BasicDFT(fftSize); // not compiled in, or cannot plan the size: routed instead
+        return;
+    }
+    // Pinned: no codelets either, so getBackend() is what runs.
+    std::lock_guard<std::mutex> lock(planMutex());
+    pImpl = makeImpl(*info, fftSize, planRigor<T>().load());
+}
+template <typename T>
+BasicDFT<T>::BasicDFT() = default; // unplanned: pImpl stays null, transforms must not be called
+template <typename T>
+BasicDFT<T>::~BasicDFT()
+{
+    if (!pImpl) return;
+    std::lock_guard<std::mutex> lock(planMutex());
+    pImpl.reset();
+}
+template <typename T>
+BasicDFT<T>::BasicDFT(BasicDFT&&) noexcept = default;
+template <typename T>
+BasicDFT<T>& BasicDFT<T>::operator=(BasicDFT&& other) noexcept
+{
+    if (this == &other) return *this;
+    std::unique_ptr<DFTImpl<T>> old = std::exchange(pImpl, std::move(other.pImpl));
+    forwardCodelet                  = other.forwardCodelet;
+    inverseCodelet                  = other.inverseCodelet;
+    if (old) {
+        std::lock_guard<std::mutex> lock(planMutex());
+        old.reset();
+    }
+    return *this;
+}
+
+template <typename T>
+void BasicDFT<T>::dft(const ComplexArray& X, ComplexArray& Y)
+{
+    if (forwardCodelet) forwardCodelet(X.data(), Y.data());
+    else pImpl->dft(X.data(), Y.data());
+}
+
+template <typename T>
+void BasicDFT<T>::idft(const ComplexArray& X, ComplexArray& Y)
+{
+    if (inverseCodelet) inverseCodelet(X.data(), Y.data());
+    else pImpl->idft(X.data(), Y.data());
+}
+
+template <typename T>
+void BasicDFT<T>::rdft(const RealArray& x, ComplexArray& X)
 {
     pImpl->rdft(x.data(), X.data());
 }
 
-void DFT::irdft(const ArrayXcd& X, ArrayXd& x)
+template <typename T>
+void BasicDFT<T>::irdft(const ComplexArray& X, RealArray& x)
 {
     pImpl->irdft(X.data(), x.data());
 }
 
-std::string DFT::getName()
+template <typename T>
+DFTBackend BasicDFT<T>::getBackend() const
+{
+    assert(pImpl);
+    return pImpl->backend();
+}
+
+template <typename T>
+std::string BasicDFT<T>::getName()
+{
+    return getName(getDefaultBackend());
+}
+
+template <typename T>
+std::string BasicDFT<T>::getName(DFTBackend backend)
+{
+    const auto* info = findBackend<T>(backend);
+    return info ? info->getName() : "";
+}
+
+template <typename T>
+std::vector<DFTBackend> BasicDFT<T>::getBackends()
+{
+    std::vector<DFTBackend> ids;
+    for (const auto& info : compiledBackends<T>()) ids.push_back(info.id);
+    return ids;
+}
+
+template <typename T>
+bool BasicDFT<T>::setDefaultBackend(DFTBackend backend)
+{
+    if (!findBackend<T>(backend)) return false;
+    defaultBackend<T>().store(backend);
+    return true;
+}
+
+template <typename T>
+DFTBackend BasicDFT<T>::getDefaultBackend()
+{
+    return defaultBackend<T>().load();
+}
+
+template <typename T>
+size_t BasicDFT<T>::nextFastSize(size_t n)
+{
+    return findBackend<T>(getDefaultBackend())->nextFastSize(n);
+}
+
+template <typename T>
+bool BasicDFT<T>::isSupported(size_t n)
+{
+    for (const auto& info : compiledBackends<T>())
+        if (info.supports(n)) return true;
+    return false;
+}
+
+template <typename T>
+size_t BasicDFT<T>::getNumSharedPlans()
+{
+    std::lock_guard<std::mutex> lock(planMutex());
+    size_t n = 0;
+    for (const auto& entry : planRegistry<T>()) n += !entry.second.expired();
+    return n;
+}
+
+template <typename T>
+void BasicDFT<T>::setPlanRigor(PlanRigor rigor)
+{
+    planRigor<T>().store(rigor);
+}
+
+template <typename T>
+PlanRigor BasicDFT<T>::getPlanRigor()
+{
+    return planRigor<T>().load();
+}
+
+// Wisdom goes to every backend that keeps some (in practice FFTW).
+
+template <typename T>
+bool BasicDFT<T>::loadWisdom(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(planMutex());
+    bool loaded = false;
+    for (const auto& info : compiledBackends<T>()) loaded |= info.importWisdom(path);
+    return loaded;
+}
+
+template <typename T>
+bool BasicDFT<T>::saveWisdom(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(planMutex());
+    bool saved = false;
+    for (const auto& info : compiledBackends<T>()) saved |= info.exportWisdom(path);
+    return saved;
+}
+
+template <typename T>
+void BasicDFT<T>::tune(const std::vector<size_t>& sizes)
+{
+    std::lock_guard<std::mutex> lock(planMutex());
+    for (size_t n : sizes) tunedRoutes<T>()[n] = fastest<T>(n);
+}
+
+template <typename T>
+void BasicDFT<T>::setAutoTune(bool enabled)
+{
+    autoTune<T>().store(enabled);
+}
+
+template <typename T>
+bool BasicDFT<T>::getAutoTune()
+{
+    return autoTune<T>().load();
+}
+
+template <typename T>
+void BasicDFT<T>::clearTuning()
 {
-    return DFTImpl::getName();
+    std::lock_guard<std::mutex> lock(planMutex());
+    tunedRoutes<T>().clear();
+}
+
+// Tuning files are text: a header line naming the format and precision,
+// then one "<size> <backend key>" line per route.
+
+template <typename T>
+bool BasicDFT<T>::loadTuning(const std::string& path)
+{
+    std::ifstream in(path);
+    std::string   magic, precision;
+    int           version = 0;
+    if (!(in >> magic >> version >> precision)) return false;
+    if (magic != "cicuetea-tuning" || version != 1 || precision != precisionTag<T>()) return false;
+
+    std::lock_guard<std::mutex> lock(planMutex());
+    size_t                      n;
+    std::string                 key;
+    while (in >> n >> key)
+        for (const auto& info : compiledBackends<T>())
+            if (key == info.key) tunedRoutes<T>()[n] = info.id;
+    return true;
+}
+
+template <typename T>
+bool BasicDFT<T>::saveTuning(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(planMutex());
+    std::ofstream               out(path, std::ios::trunc);
+    out << "cicuetea-tuning 1 " << precisionTag<T>() << "\n";
+    for (const auto& [n, id] : tunedRoutes<T>()) out << n << " " << findBackend<T>(id)->key << "\n";
+    return bool(out);
+}
+
+template <typename T>
+void BasicDFT<T>::setMaxCodeletSize(size_t n)
+{
+    maxCodelet<T>().store(n);
+}
+
+template <typename T>
+size_t BasicDFT<T>::getMaxCodeletSize()
+{
+    return maxCodelet<T>().load();
 }
 
 //==========================================================================
 
-void DFT::dft(const ArrayXXcd& X, ArrayXXcd& Y)
+namespace {
+/// Runs one batch, planning its shape first (under the plan lock) if needed.
+/// A shape planned here always uses Estimate: the buffers hold the caller's
+/// data, which a measuring planner would overwrite.
+template <typename T>
+void runBatch(DFTImpl<T>& impl, const BatchShape& shape, const void* in, void* out)
+{
+    if (!impl.hasBatch(shape)) {
+        std::lock_guard<std::mutex> lock(planMutex());
+        impl.planBatch(shape, in, out, PlanRigor::Estimate);
+    }
+    impl.runBatch(shape, in, out);
+}
+} // namespace
+
+template <typename T>
+void BasicDFT<T>::prepareBatch(Index count, Index rows)
 {
+    ComplexMatrix a = ComplexMatrix::Zero(rows, count);
+    ComplexMatrix b = ComplexMatrix::Zero(rows, count);
+    RealMatrix    r = RealMatrix::Zero(rows, count);
+
+    PlanRigor rigor = planRigor<T>().load();
+
+    std::lock_guard<std::mutex> lock(planMutex());
+    auto plan = [&](const BatchShape& shape, const void* in, void* out) {
+        if (!pImpl->hasBatch(shape)) pImpl->planBatch(shape, in, out, rigor);
+    };
+    for (DFTKind kind : {DFTKind::Forward, DFTKind::Inverse}) {
+        plan({kind, count, rows, false}, a.data(), b.data());
+        plan({kind, count, rows, true}, a.data(), a.data());
+    }
+    plan({DFTKind::RealForward, count, rows, false}, r.data(), a.data());
+    plan({DFTKind::RealInverse, count, rows, false}, a.data(), r.data());
+}
+
+// Matrices with equal row counts have one column distance on both sides and
+// go to the backend as one batch; anything else keeps the column loop. Sizes
+// with a codelet always loop: one codelet per column beats a batched call.
+
+template <typename T>
+void BasicDFT<T>::dft(const ComplexMatrix& X, ComplexMatrix& Y)
+{
+    if (forwardCodelet) {
+        for (Index k = 0; k < X.cols(); k++) forwardCodelet(X.col(k).data(), Y.col(k).data());
+        return;
+    }
+    if (X.rows() == Y.rows()) {
+        runBatch(*pImpl, {DFTKind::Forward, X.cols(), X.rows(), X.data() == Y.data()}, X.data(), Y.data());
+        return;
+    }
     for (Index k = 0; k < X.cols(); k++) {
         pImpl->dft(X.col(k).data(), Y.col(k).data());
     }
 }
 
-void DFT::idft(const ArrayXXcd& X, ArrayXXcd& Y)
+template <typename T>
+void BasicDFT<T>::idft(const ComplexMatrix& X, ComplexMatrix& Y)
 {
+    if (inverseCodelet) {
+        for (Index k = 0; k < X.cols(); k++) inverseCodelet(X.col(k).data(), Y.col(k).data());
+        return;
+    }
+    if (X.rows() == Y.rows()) {
+        runBatch(*pImpl, {DFTKind::Inverse, X.cols(), X.rows(), X.data() == Y.data()}, X.data(), Y.data());
+        return;
+    }
     for (Index k = 0; k < X.cols(); k++) {
         pImpl->idft(X.col(k).data(), Y.col(k).data());
     }
 }
 
-void DFT::rdft(const ArrayXXd& x, ArrayXXcd& X)
+template <typename T>
+void BasicDFT<T>::rdft(const RealMatrix& x, ComplexMatrix& X)
 {
+    if (x.rows() == X.rows()) {
+        runBatch(*pImpl, {DFTKind::RealForward, x.cols(), x.rows(), false}, x.data(), X.data());
+        return;
+    }
     for (Index k = 0; k < x.cols(); k++) {
         pImpl->rdft(x.col(k).data(), X.col(k).data());
     }
 }
 
-void DFT::irdft(const ArrayXXcd& X, ArrayXXd& x)
+template <typename T>
+void BasicDFT<T>::irdft(const ComplexMatrix& X, RealMatrix& x)
 {
+    if (X.rows() == x.rows()) {
+        runBatch(*pImpl, {DFTKind::RealInverse, X.cols(), X.rows(), false}, X.data(), x.data());
+        return;
+    }
     for (Index k = 0; k < X.cols(); k++) {
         pImpl->irdft(X.col(k).data(), x.col(k).data());
     }
 }
+
+//==========================================================================
+
+template class jsa::cicuetea::BasicDFT<float>;
+template class jsa::cicuetea::BasicDFT<double>;
@@ -0,0 +1,177 @@
+//
+//  FFT_Backends.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/5/25.
+//
+
+/**
+ * @file FFT_Backends.h
+ * @brief The backends compiled into this build, behind one interface
+ * @author Juan Sierra
+ * @date 7/5/25
+ * @copyright MIT License
+ *
+ * Every FFT_<NAME> definition FFTSelection.cmake sets compiles one backend
+ * header in. Each backend class (FftwDFT, NativeDFT, ...) has the same
+ * members but no common base, so BackendImpl adapts it to the virtual
+ * DFTImpl that BasicDFT holds, and BackendInfo describes it to the plan
+ * registry and the autotuner in FFT.cpp.
+ */
+
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FFT.hpp"
+#include "FFT_Batch.h"
+
+#ifdef FFT_FFTW
+#    include "FFT_FFTW.h"
+#endif
+
+#ifdef FFT_PFFFT
+#    include "FFT_PFFFT.h"
+#endif
+
+#ifdef FFT_VDSP
+#    include "FFT_vDSP.h"
+#endif
+
+#ifdef FFT_MKL
+#    include "FFT_MKL.h"
+#endif
+
+#ifdef FFT_NATIVE
+#    include "FFT_Native.h"
+#endif
+
+namespace jsa::cicuetea {
+
+/**
+ * @class DFTImpl
+ * @brief One backend's DFT of one size, as BasicDFT sees it.
+ */
+template <typename T>
+class DFTImpl
+{
+  public:
+    using Complex = std::complex<T>;
+
+    virtual ~DFTImpl() = default;
+
+    virtual DFTBackend backend() const = 0;
+
+    virtual void dft(const Complex* inPtr, Complex* outPtr)  = 0;
+    virtual void idft(const Complex* inPtr, Complex* outPtr) = 0;
+    virtual void rdft(const T* inPtr, Complex* outPtr)       = 0;
+    virtual void irdft(const Complex* inPtr, T* outPtr)      = 0;
+
+    virtual bool hasBatch(const BatchShape& shape) const                                       = 0;
+    virtual void planBatch(const BatchShape& shape, const void* in, void* out, PlanRigor rigor) = 0;
+    virtual void runBatch(const BatchShape& shape, const void* in, void* out)                  = 0;
+};
+
+/**
+ * @class BackendImpl
+ * @brief DFTImpl over the backend class Backend, identified as id.
+ */
+template <typename T, typename Backend, DFTBackend id>
+class BackendImpl final : public DFTImpl<T>
+{
+    using Complex = std::complex<T>;
+
+  public:
+    explicit BackendImpl(std::shared_ptr<const typename Backend::Plans> plans) :
+        impl(std::move(plans))
+    {
+    }
+
+    DFTBackend backend() const override { return id; }
+
+    void dft(const Complex* inPtr, Complex* outPtr) override { impl.dft(inPtr, outPtr); }
+    void idft(const Complex* inPtr, Complex* outPtr) override { impl.idft(inPtr, outPtr); }
+    void rdft(const T* inPtr, Complex* outPtr) override { impl.rdft(inPtr, outPtr); }
+    void irdft(const Complex* inPtr, T* outPtr) override { impl.irdft(inPtr, outPtr); }
+
+    bool hasBatch(const BatchShape& shape) const override { return impl.hasBatch(shape); }
+    void planBatch(const BatchShape& shape, const void* in, void* out, PlanRigor rigor) override
+    {
+        impl.planBatch(shape, in, out, rigor);
+    }
+    void runBatch(const BatchShape& shape, const void* in, void* out) override { impl.runBatch(shape, in, out); }
+
+  private:
+    Backend impl;
+};
+
+/**
+ * @struct BackendInfo
+ * @brief A compiled-in backend: its identity and its static members, with
+ * the plan type erased so the registry can hold every backend's plans.
+ */
+template <typename T>
+struct BackendInfo {
+    DFTBackend  id;
+    const char* key; ///< Stable lower-case name, used in tuning files.
+
+    std::string (*getName)();
+    size_t (*nextFastSize)(size_t);
+    bool (*importWisdom)(const std::string&);
+    bool (*exportWisdom)(const std::string&);
+
+    /// Builds the shared plans of one size.
+    std::shared_ptr<const void> (*makePlans)(size_t, PlanRigor);
+
+    /// A DFT over plans made by makePlans.
+    std::unique_ptr<DFTImpl<T>> (*make)(std::shared_ptr<const void>);
+
+    /// True when the backend plans n (pow2-only backends reject the rest).
+    bool supports(size_t n) const { return nextFastSize(n) == n; }
+};
+
+template <typename T, typename Backend, DFTBackend id>
+BackendInfo<T> backendInfo(const char* key)
+{
+    using Plans = typename Backend::Plans;
+    return {id,
+            key,
+            [] { return std::string(Backend::getName()); },
+            &Backend::nextFastSize,
+            &Backend::importWisdom,
+            &Backend::exportWisdom,
+            [](size_t n, PlanRigor rigor) -> std::shared_ptr<const void> { return std::make_shared<Plans>(n, rigor); },
+            [](std::shared_ptr<const void> plans) -> std::unique_ptr<DFTImpl<T>> {
+                return std::make_unique<BackendImpl<T, Backend, id>>(std::static_pointer_cast<const Plans>(plans));
+            }};
+}
+
+/// The backends compiled in, in default-priority order: the first is the
+/// default backend, as when FFTSelection.cmake linked exactly one.
+template <typename T>
+const std::vector<BackendInfo<T>>& compiledBackends()
+{
+    static const std::vector<BackendInfo<T>> list = {
+#ifdef FFT_NATIVE
+        backendInfo<T, NativeDFT<T>, DFTBackend::Native>("native"),
+#endif
+#ifdef FFT_MKL
+        backendInfo<T, MklDFT<T>, DFTBackend::MKL>("mkl"),
+#endif
+#ifdef FFT_PFFFT
+        backendInfo<T, PffftDFT<T>, DFTBackend::PFFFT>("pffft"),
+#endif
+#ifdef FFT_VDSP
+        backendInfo<T, VdspDFT<T>, DFTBackend::VDSP>("vdsp"),
+#endif
+#ifdef FFT_FFTW
+        backendInfo<T, FftwDFT<T>, DFTBackend::FFTW>("fftw"),
+#endif
+    };
+    return list;
+}
+
+} // namespace jsa::cicuetea
@@ -0,0 +1,117 @@
+//
+//  FFT_Batch.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 6/29/25.
+//
+
+/**
+ * @file FFT_Batch.h
+ * @brief Shape key and plan cache shared by the backends' batched transforms
+ * @author Juan Sierra
+ * @date 6/29/25
+ * @copyright MIT License
+ *
+ * The matrix overloads of BasicDFT transform every column of a matrix at
+ * once. Backends with a native batched interface (FFTW's plan_many, MKL's
+ * DFTI_NUMBER_OF_TRANSFORMS) need one plan per batch shape; a DFT only ever
+ * sees a handful of shapes, so the cache is a short list scanned linearly.
+ */
+
+#pragma once
+
+#include <complex>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace jsa::cicuetea {
+
+/// Which transform a batch runs.
+enum class DFTKind {
+    Forward,     ///< Complex to complex, forward.
+    Inverse,     ///< Complex to complex, backward (scaled by 1/N).
+    RealForward, ///< Real to complex (N/2 + 1 bins written).
+    RealInverse  ///< Complex to real (scaled by 1/N).
+};
+
+/**
+ * @struct BatchShape
+ * @brief Everything a batched plan depends on besides the transform size.
+ */
+struct BatchShape {
+    DFTKind      kind    = DFTKind::Forward;
+    Eigen::Index count   = 0;     ///< Number of columns.
+    Eigen::Index dist    = 0;     ///< Elements between column starts (matrix rows), input and output alike.
+    bool         inPlace = false; ///< Input and output are the same buffer.
+
+    bool operator==(const BatchShape&) const = default;
+};
+
+/**
+ * @class BatchCache
+ * @brief Batched plans of one DFT, keyed by BatchShape.
+ *
+ * Not synchronized: BasicDFT plans under its global plan lock, and one DFT
+ * object is never run on two threads at once.
+ *
+ * @tparam Plan Backend plan handle (copyable, e.g. fftw_plan).
+ */
+template <typename Plan>
+class BatchCache
+{
+  public:
+    /// The plan for a shape, or nullptr when it has not been planned.
+    const Plan* find(const BatchShape& shape) const
+    {
+        for (const auto& entry : entries)
+            if (entry.first == shape) return &entry.second;
+        return nullptr;
+    }
+
+    void add(const BatchShape& shape, Plan plan) { entries.emplace_back(shape, plan); }
+
+    /// Calls destroy(plan) on every cached plan and empties the cache.
+    template <typename F>
+    void clear(F&& destroy)
+    {
+        for (auto& entry : entries) destroy(entry.second);
+        entries.clear();
+    }
+
+  private:
+    std::vector<std::pair<BatchShape, Plan>> entries; ///< Planned shapes, oldest first.
+};
+
+/**
+ * @brief Runs a batch as one single-column transform per column, for
+ * backends without a batched interface.
+ *
+ * @tparam T Real scalar type.
+ * @tparam Impl Backend with the single-column dft/idft/rdft/irdft.
+ */
+template <typename T, typename Impl>
+void runColumns(Impl& impl, const BatchShape& shape, const void* inPtr, void* outPtr)
+{
+    using Complex = std::complex<T>;
+    for (Eigen::Index c = 0; c < shape.count; c++) {
+        Eigen::Index offset = c * shape.dist;
+        switch (shape.kind) {
+            case DFTKind::Forward:
+                impl.dft(static_cast<const Complex*>(inPtr) + offset, static_cast<Complex*>(outPtr) + offset);
+                break;
+            case DFTKind::Inverse:
+                impl.idft(static_cast<const Complex*>(inPtr) + offset, static_cast<Complex*>(outPtr) + offset);
+                break;
+            case DFTKind::RealForward:
+                impl.rdft(static_cast<const T*>(inPtr) + offset, static_cast<Complex*>(outPtr) + offset);
+                break;
+            case DFTKind::RealInverse:
+                impl.irdft(static_cast<const Complex*>(inPtr) + offset, static_cast<T*>(outPtr) + offset);
+                break;
+        }
+    }
+}
+
+} // namespace jsa::cicuetea
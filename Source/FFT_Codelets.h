@@ -0,0 +1,151 @@
+//
+//  FFT_Codelets.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/4/25.
+//
+
+/**
+ * @file FFT_Codelets.h
+ * @brief Fully unrolled complex DFTs of small power-of-two sizes
+ * @author Juan Sierra
+ * @date 7/4/25
+ * @copyright MIT License
+ *
+ * Most bands of a sparse CQT have spans of a few dozen points, where the
+ * call into the backend (plan lookup, stride handling, SIMD setup) costs
+ * as much as the arithmetic. A codelet is the whole transform of one size
+ * expanded at compile time: a radix-2 decimation-in-time recursion whose
+ * twiddles are constexpr constants, with the trivial ones (1 and ∓i)
+ * reduced to adds and swaps. BasicDFT picks one at construction for sizes
+ * up to maxCodeletSize and bypasses the backend for the 1-D complex
+ * transforms.
+ */
+
+#pragma once
+
+#include <complex>
+#include <utility>
+
+#if defined(_MSC_VER)
+#    define CICUETEA_CODELET_INLINE __forceinline
+#else
+#    define CICUETEA_CODELET_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace jsa::cicuetea::codelets {
+
+/// Largest size with a codelet.
+inline constexpr size_t maxCodeletSize = 64;
+
+/// sin(π·x) for x in [-1/2, 1/2], by Taylor series (constexpr, unlike std::sin).
+constexpr long double sinPi(long double x)
+{
+    const long double t = 3.14159265358979323846264338327950288L * x;
+    long double       term = t, sum = t;
+    for (int k = 1; k < 16; k++) {
+        term *= -t * t / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+/// cos and sin of 2πk/n for 0 <= k < n/2 (first two quadrants, folded to
+/// the range where the series is accurate).
+constexpr long double cosTurn(int k, int n) { return 4 * k <= n ? sinPi(0.5L - 2.0L * k / n) : -sinPi(2.0L * k / n - 0.5L); }
+constexpr long double sinTurn(int k, int n) { return 4 * k <= n ? sinPi(2.0L * k / n) : sinPi(1.0L - 2.0L * k / n); }
+
+/**
+ * @brief DFT of n points read with stride s from (xr, xi), written
+ * contiguously to (yr, yi); sign -1 is forward, +1 inverse (unscaled).
+ */
+template <typename T, int n, int s, int sign>
+struct Radix2 {
+    static CICUETEA_CODELET_INLINE void run(const T* xr, const T* xi, T* yr, T* yi)
+    {
+        if constexpr (n == 1) {
+            yr[0] = xr[0];
+            yi[0] = xi[0];
+        } else {
+            Radix2<T, n / 2, 2 * s, sign>::run(xr, xi, yr, yi);
+            Radix2<T, n / 2, 2 * s, sign>::run(xr + s, xi + s, yr + n / 2, yi + n / 2);
+            combine(yr, yi, std::make_integer_sequence<int, n / 2>{});
+        }
+    }
+
+  private:
+    template <int... k>
+    static CICUETEA_CODELET_INLINE void combine(T* yr, T* yi, std::integer_sequence<int, k...>)
+    {
+        (butterfly<k>(yr, yi), ...);
+    }
+
+    /// y[k], y[k + n/2] = e ± w^k·o, with w = exp(sign·2πi/n).
+    template <int k>
+    static CICUETEA_CODELET_INLINE void butterfly(T* yr, T* yi)
+    {
+        constexpr int h = n / 2;
+
+        T br = yr[k + h], bi = yi[k + h], tr, ti;
+        if constexpr (k == 0) {
+            tr = br;
+            ti = bi;
+        } else if constexpr (4 * k == n) {
+            tr = -sign * bi;
+            ti = sign * br;
+        } else {
+            constexpr T wr = T(cosTurn(k, n));
+            constexpr T wi = T(sign * sinTurn(k, n));
+            tr             = br * wr - bi * wi;
+            ti             = br * wi + bi * wr;
+        }
+        T ar = yr[k], ai = yi[k];
+        yr[k]     = ar + tr;
+        yi[k]     = ai + ti;
+        yr[k + h] = ar - tr;
+        yi[k + h] = ai - ti;
+    }
+};
+
+/**
+ * @brief The n-point complex DFT of in into out (which may alias), scaled
+ * by 1/n when inverse, like the backends' idft.
+ */
+template <typename T, int n, bool inverse>
+void transform(const std::complex<T>* in, std::complex<T>* out)
+{
+    T xr[n], xi[n], yr[n], yi[n];
+    for (int i = 0; i < n; i++) {
+        xr[i] = in[i].real();
+        xi[i] = in[i].imag();
+    }
+    Radix2<T, n, 1, inverse ? 1 : -1>::run(xr, xi, yr, yi);
+
+    constexpr T scale = inverse ? T(1) / T(n) : T(1);
+    for (int i = 0; i < n; i++) out[i] = {yr[i] * scale, yi[i] * scale};
+}
+
+/// Forward or inverse codelet of size n.
+template <typename T>
+using Codelet = void (*)(const std::complex<T>*, std::complex<T>*);
+
+/**
+ * @brief The codelet for an n-point transform, or nullptr when n is not a
+ * power of two in [2, limit] (limit is capped at maxCodeletSize).
+ */
+template <typename T>
+Codelet<T> find(size_t n, size_t limit, bool inverse)
+{
+    if (n > limit || n > maxCodeletSize) return nullptr;
+    switch (n) {
+        case 2: return inverse ? &transform<T, 2, true> : &transform<T, 2, false>;
+        case 4: return inverse ? &transform<T, 4, true> : &transform<T, 4, false>;
+        case 8: return inverse ? &transform<T, 8, true> : &transform<T, 8, false>;
+        case 16: return inverse ? &transform<T, 16, true> : &transform<T, 16, false>;
+        case 32: return inverse ? &transform<T, 32, true> : &transform<T, 32, false>;
+        case 64: return inverse ? &transform<T, 64, true> : &transform<T, 64, false>;
+        default: return nullptr;
+    }
+}
+
+} // namespace jsa::cicuetea::codelets
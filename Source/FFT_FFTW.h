@@ -15,73 +15,250 @@
 
 #pragma once
 
+#include <complex>
+#include <memory>
+#include <string>
+
 #include <Eigen/Core>
 #include <fftw3.h>
 
+#include "FFT.hpp"
+#include "FFT_Batch.h"
+#include "MathUtils.h"
+
 using namespace Eigen;
 
 namespace jsa::cicuetea {
-class DFTImpl
+
+/**
+ * @brief Maps a scalar type onto FFTW's per-precision API (fftw_* for double,
+ * fftwf_* for float — the latter lives in libfftw3f).
+ */
+template <typename T>
+struct FftwApi;
+
+template <>
+struct FftwApi<double> {
+    using Plan    = fftw_plan;
+    using Complex = fftw_complex;
+
+    static constexpr auto planR2C      = &fftw_plan_dft_r2c_1d;
+    static constexpr auto planC2R      = &fftw_plan_dft_c2r_1d;
+    static constexpr auto planC2C      = &fftw_plan_dft_1d;
+    static constexpr auto planManyC2C  = &fftw_plan_many_dft;
+    static constexpr auto planManyR2C  = &fftw_plan_many_dft_r2c;
+    static constexpr auto planManyC2R  = &fftw_plan_many_dft_c2r;
+    static constexpr auto executeC2C   = &fftw_execute_dft;
+    static constexpr auto executeR2C   = &fftw_execute_dft_r2c;
+    static constexpr auto executeC2R   = &fftw_execute_dft_c2r;
+    static constexpr auto destroyPlan  = &fftw_destroy_plan;
+    static constexpr auto importWisdom = &fftw_import_wisdom_from_filename;
+    static constexpr auto exportWisdom = &fftw_export_wisdom_to_filename;
+};
+
+template <>
+struct FftwApi<float> {
+    using Plan    = fftwf_plan;
+    using Complex = fftwf_complex;
+
+    static constexpr auto planR2C      = &fftwf_plan_dft_r2c_1d;
+    static constexpr auto planC2R      = &fftwf_plan_dft_c2r_1d;
+    static constexpr auto planC2C      = &fftwf_plan_dft_1d;
+    static constexpr auto planManyC2C  = &fftwf_plan_many_dft;
+    static constexpr auto planManyR2C  = &fftwf_plan_many_dft_r2c;
+    static constexpr auto planManyC2R  = &fftwf_plan_many_dft_c2r;
+    static constexpr auto executeC2C   = &fftwf_execute_dft;
+    static constexpr auto executeR2C   = &fftwf_execute_dft_r2c;
+    static constexpr auto executeC2R   = &fftwf_execute_dft_c2r;
+    static constexpr auto destroyPlan  = &fftwf_destroy_plan;
+    static constexpr auto importWisdom = &fftwf_import_wisdom_from_filename;
+    static constexpr auto exportWisdom = &fftwf_export_wisdom_to_filename;
+};
+
+/// The FFTW backend (DFTBackend::FFTW); FFT_Backends.h adapts it to DFTImpl.
+template <typename T>
+class FftwDFT
 {
+    using Api      = FftwApi<T>;
+    using Plan     = typename Api::Plan;
+    using FComplex = typename Api::Complex;
+    using Complex  = std::complex<T>;
+
   public:
-    DFTImpl(size_t fftSize) :
-        fftSize(fftSize)
+    /**
+     * @brief The single-column plans of one size. Immutable once built and
+     * executed through the new-array API, which is thread-safe, so every DFT
+     * of the size shares one set (see the plan registry in FFT.cpp).
+     *
+     * Measuring planners run the candidate algorithms on the arrays they are
+     * given, so every plan is made on scratch arrays (allocated like the
+     * callers' Eigen arrays, hence with the same alignment).
+     */
+    struct Plans {
+        Plans(size_t fftSize, PlanRigor rigor) :
+            fftSize(fftSize)
+        {
+            unsigned int flags = planFlags(rigor) | FFTW_PRESERVE_INPUT;
+            int          n     = int(fftSize);
+
+            Array<T, Dynamic, 1>       r(n);
+            Array<Complex, Dynamic, 1> a(n), b(n);
+            auto*                      fa = reinterpret_cast<FComplex*>(a.data());
+            auto*                      fb = reinterpret_cast<FComplex*>(b.data());
+
+            // The new-array execute needs the in-place-ness the plan was
+            // made with, so the complex transforms get one plan of each.
+            r2c    = Api::planR2C(n, r.data(), fa, flags);
+            c2r    = Api::planC2R(n, fa, r.data(), flags);
+            c2c    = Api::planC2C(n, fa, fb, FFTW_FORWARD, flags);
+            ic2c   = Api::planC2C(n, fa, fb, FFTW_BACKWARD, flags);
+            c2cIn  = Api::planC2C(n, fa, fa, FFTW_FORWARD, flags & ~FFTW_PRESERVE_INPUT);
+            ic2cIn = Api::planC2C(n, fa, fa, FFTW_BACKWARD, flags & ~FFTW_PRESERVE_INPUT);
+        }
+
+        ~Plans()
+        {
+            if (r2c) Api::destroyPlan(r2c);
+            if (c2r) Api::destroyPlan(c2r);
+            if (c2c) Api::destroyPlan(c2c);
+            if (ic2c) Api::destroyPlan(ic2c);
+            if (c2cIn) Api::destroyPlan(c2cIn);
+            if (ic2cIn) Api::destroyPlan(ic2cIn);
+        }
+
+        Plans(const Plans&)            = delete;
+        Plans& operator=(const Plans&) = delete;
+
+        const size_t fftSize;
+        Plan         r2c    = nullptr;
+        Plan         c2r    = nullptr;
+        Plan         c2c    = nullptr; ///< Out of place.
+        Plan         ic2c   = nullptr; ///< Out of place.
+        Plan         c2cIn  = nullptr; ///< In place.
+        Plan         ic2cIn = nullptr; ///< In place.
+    };
+
+    explicit FftwDFT(std::shared_ptr<const Plans> sharedPlans) :
+        fftSize(sharedPlans->fftSize),
+        plans(std::move(sharedPlans))
+    {
+    }
+
+    ~FftwDFT()
     {
-        unsigned int flags = FFTW_ESTIMATE | FFTW_PRESERVE_INPUT;
+        batches.clear([](Plan p) { Api::destroyPlan(p); });
+    }
 
-        r2cPlan  = fftw_plan_dft_r2c_1d(int(fftSize), nullptr, nullptr, flags);
-        c2rPlan  = fftw_plan_dft_c2r_1d(int(fftSize), nullptr, nullptr, flags);
-        c2cPlan  = fftw_plan_dft_1d(int(fftSize), nullptr, nullptr, FFTW_FORWARD, flags);
-        ic2cPlan = fftw_plan_dft_1d(int(fftSize), nullptr, nullptr, FFTW_BACKWARD, flags);
+    void dft(const Complex* inPtr, Complex* outPtr)
+    {
+        FComplex* inPtr_  = reinterpret_cast<FComplex*>(const_cast<Complex*>(inPtr));
+        FComplex* outPtr_ = reinterpret_cast<FComplex*>(outPtr);
+        Api::executeC2C(inPtr == outPtr ? plans->c2cIn : plans->c2c, inPtr_, outPtr_);
     }
 
-    ~DFTImpl()
+    void idft(const Complex* inPtr, Complex* outPtr)
     {
-        if (r2cPlan) fftw_destroy_plan(r2cPlan);
-        if (c2rPlan) fftw_destroy_plan(c2rPlan);
-        if (c2cPlan) fftw_destroy_plan(c2cPlan);
-        if (ic2cPlan) fftw_destroy_plan(ic2cPlan);
+        FComplex* inPtr_  = reinterpret_cast<FComplex*>(const_cast<Complex*>(inPtr));
+        FComplex* outPtr_ = reinterpret_cast<FComplex*>(outPtr);
+        Api::executeC2C(inPtr == outPtr ? plans->ic2cIn : plans->ic2c, inPtr_, outPtr_);
+        Map<Array<Complex, Dynamic, 1>>(outPtr, fftSize) *= T(1) / T(fftSize);
     }
 
-    void dft(const dcomplex* inPtr, dcomplex* outPtr)
+    void rdft(const T* inPtr, Complex* outPtr)
     {
-        fftw_complex* inPtr_  = reinterpret_cast<fftw_complex*>(const_cast<dcomplex*>(inPtr));
-        fftw_complex* outPtr_ = reinterpret_cast<fftw_complex*>(outPtr);
-        fftw_execute_dft(c2cPlan, inPtr_, outPtr_);
+        T*        inPtr_  = const_cast<T*>(inPtr);
+        FComplex* outPtr_ = reinterpret_cast<FComplex*>(outPtr);
+        Api::executeR2C(plans->r2c, inPtr_, outPtr_);
     }
 
-    void idft(const dcomplex* inPtr, dcomplex* outPtr)
+    void irdft(const Complex* inPtr, T* outPtr)
     {
-        fftw_complex* inPtr_  = reinterpret_cast<fftw_complex*>(const_cast<dcomplex*>(inPtr));
-        fftw_complex* outPtr_ = reinterpret_cast<fftw_complex*>(outPtr);
-        fftw_execute_dft(ic2cPlan, inPtr_, outPtr_);
-        Map<ArrayXcd>(outPtr, fftSize) *= (1.0 / fftSize);
+        FComplex* inPtr_ = reinterpret_cast<FComplex*>(const_cast<Complex*>(inPtr));
+        Api::executeC2R(plans->c2r, inPtr_, outPtr);
+        Map<Array<T, Dynamic, 1>>(outPtr, fftSize) *= T(1) / T(fftSize);
     }
 
-    void rdft(const double* inPtr, dcomplex* outPtr)
+    bool hasBatch(const BatchShape& shape) const { return batches.find(shape) != nullptr; }
+
+    /// One plan_many per shape: howmany = count, contiguous columns dist apart.
+    /// Planned on the given buffers (which a rigor above Estimate overwrites)
+    /// with FFTW_UNALIGNED, so the plan runs on any later buffers of the shape.
+    void planBatch(const BatchShape& shape, const void* inPtr, void* outPtr, PlanRigor rigor)
     {
-        double*       inPtr_  = const_cast<double*>(inPtr);
-        fftw_complex* outPtr_ = reinterpret_cast<fftw_complex*>(outPtr);
-        fftw_execute_dft_r2c(r2cPlan, inPtr_, outPtr_);
+        unsigned flags = planFlags(rigor) | FFTW_UNALIGNED | FFTW_PRESERVE_INPUT;
+        int      n     = int(fftSize);
+        int      count = int(shape.count);
+        int      dist  = int(shape.dist);
+        auto*    cIn   = reinterpret_cast<FComplex*>(const_cast<void*>(inPtr));
+        auto*    cOut  = reinterpret_cast<FComplex*>(outPtr);
+        Plan     plan  = nullptr;
+        switch (shape.kind) {
+            case DFTKind::Forward:
+            case DFTKind::Inverse:
+                plan = Api::planManyC2C(1, &n, count, cIn, nullptr, 1, dist, cOut, nullptr, 1, dist,
+                                        shape.kind == DFTKind::Forward ? FFTW_FORWARD : FFTW_BACKWARD,
+                                        shape.inPlace ? flags & ~FFTW_PRESERVE_INPUT : flags);
+                break;
+            case DFTKind::RealForward:
+                plan = Api::planManyR2C(1, &n, count, static_cast<T*>(const_cast<void*>(inPtr)), nullptr, 1,
+                                        dist, cOut, nullptr, 1, dist, flags);
+                break;
+            case DFTKind::RealInverse:
+                plan = Api::planManyC2R(1, &n, count, cIn, nullptr, 1, dist, static_cast<T*>(outPtr),
+                                        nullptr, 1, dist, flags);
+                break;
+        }
+        batches.add(shape, plan);
     }
 
-    void irdft(const dcomplex* inPtr, double* outPtr)
+    void runBatch(const BatchShape& shape, const void* inPtr, void* outPtr)
     {
-        fftw_complex* inPtr_ = reinterpret_cast<fftw_complex*>(const_cast<dcomplex*>(inPtr));
-        fftw_execute_dft_c2r(c2rPlan, inPtr_, outPtr);
-        Map<ArrayXd>(outPtr, fftSize) *= (1.0 / fftSize);
+        Plan  plan = *batches.find(shape);
+        auto* cIn  = reinterpret_cast<FComplex*>(const_cast<void*>(inPtr));
+        auto* cOut = reinterpret_cast<FComplex*>(outPtr);
+        switch (shape.kind) {
+            case DFTKind::Forward:
+            case DFTKind::Inverse: Api::executeC2C(plan, cIn, cOut); break;
+            case DFTKind::RealForward: Api::executeR2C(plan, static_cast<T*>(const_cast<void*>(inPtr)), cOut); break;
+            case DFTKind::RealInverse: Api::executeC2R(plan, cIn, static_cast<T*>(outPtr)); break;
+        }
+
+        // Same 1/N convention as the single-column inverses.
+        Index n = Index(fftSize), count = shape.count, dist = shape.dist;
+        if (shape.kind == DFTKind::Inverse)
+            Map<Array<Complex, Dynamic, Dynamic>, 0, OuterStride<>>(static_cast<Complex*>(outPtr), n, count,
+                                                                    OuterStride<>(dist)) *= T(1) / T(fftSize);
+        if (shape.kind == DFTKind::RealInverse)
+            Map<Array<T, Dynamic, Dynamic>, 0, OuterStride<>>(static_cast<T*>(outPtr), n, count,
+                                                              OuterStride<>(dist)) *= T(1) / T(fftSize);
     }
 
+    static bool importWisdom(const std::string& path) { return Api::importWisdom(path.c_str()) != 0; }
+    static bool exportWisdom(const std::string& path) { return Api::exportWisdom(path.c_str()) != 0; }
+
     static const std::string getName()
     {
         return "FFTW";
     }
 
+    /// Any 2^a·3^b·5^c size gets a fast codelet-based plan.
+    static size_t nextFastSize(size_t n)
+    {
+        return nextSmooth(n);
+    }
+
   private:
-    const size_t fftSize;
-    fftw_plan    r2cPlan  = nullptr;
-    fftw_plan    c2rPlan  = nullptr;
-    fftw_plan    c2cPlan  = nullptr;
-    fftw_plan    ic2cPlan = nullptr;
+    static unsigned planFlags(PlanRigor rigor)
+    {
+        switch (rigor) {
+            case PlanRigor::Measure: return FFTW_MEASURE;
+            case PlanRigor::Patient: return FFTW_PATIENT;
+            default: return FFTW_ESTIMATE;
+        }
+    }
+
+    const size_t                 fftSize;
+    std::shared_ptr<const Plans> plans;   ///< Single-column plans, shared by size.
+    BatchCache<Plan>             batches; ///< Batched plans of the matrix overloads.
 };
 } // namespace jsa::cicuetea
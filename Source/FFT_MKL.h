@@ -15,65 +15,136 @@
 
 #pragma once
 
+#include <cassert>
+#include <complex>
+#include <memory>
+#include <type_traits>
+
 #include <Eigen/Core>
 #include <mkl.h>
 
+#include "FFT.hpp"
+#include "FFT_Batch.h"
+#include "MathUtils.h"
+
 using namespace Eigen;
 
 namespace jsa::cicuetea {
-class DFTImpl
+/// The MKL backend (DFTBackend::MKL); FFT_Backends.h adapts it to DFTImpl.
+template <typename T>
+class MklDFT
 {
+    using Complex = std::complex<T>;
+
+    /// DFTI precision matching T (DFTI_SINGLE / DFTI_DOUBLE).
+    static constexpr DFTI_CONFIG_VALUE precision =
+        std::is_same_v<T, float> ? DFTI_SINGLE : DFTI_DOUBLE;
+
   public:
-    DFTImpl(size_t fftSize) :
-        fftSize(fftSize)
+    /**
+     * @brief The committed descriptors of one size. A committed descriptor
+     * may be computed with from several threads at once, so every DFT of the
+     * size shares one set (see the plan registry in FFT.cpp).
+     */
+    struct Plans {
+        Plans(size_t fftSize, PlanRigor /*rigor*/) :
+            fftSize(fftSize)
+        {
+            DftiCreateDescriptor(&realSetup, precision, DFTI_REAL, 1, this->fftSize);
+            status += DftiSetValue(realSetup, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+            status += DftiSetValue(realSetup, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+            status += DftiSetValue(realSetup, DFTI_FORWARD_SCALE, 1.0);
+            status += DftiSetValue(realSetup, DFTI_BACKWARD_SCALE, 1.0 / fftSize);
+            status += DftiCommitDescriptor(realSetup);
+
+            DftiCreateDescriptor(&cplxSetup, precision, DFTI_COMPLEX, 1, this->fftSize);
+            status += DftiSetValue(realSetup, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+            status += DftiSetValue(realSetup, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+            status += DftiSetValue(realSetup, DFTI_FORWARD_SCALE, 1.0);
+            status += DftiSetValue(realSetup, DFTI_BACKWARD_SCALE, 1.0 / fftSize);
+            status += DftiCommitDescriptor(cplxSetup);
+            assert(status == DFTI_NO_ERROR);
+        }
+
+        ~Plans()
+        {
+            if (realSetup) DftiFreeDescriptor(&realSetup);
+            if (cplxSetup) DftiFreeDescriptor(&cplxSetup);
+        }
+
+        Plans(const Plans&)            = delete;
+        Plans& operator=(const Plans&) = delete;
+
+        const size_t           fftSize;
+        DFTI_DESCRIPTOR_HANDLE realSetup = nullptr;
+        DFTI_DESCRIPTOR_HANDLE cplxSetup = nullptr;
+        long                   status    = DFTI_NO_ERROR;
+    };
+
+    explicit MklDFT(std::shared_ptr<const Plans> sharedPlans) :
+        fftSize(sharedPlans->fftSize),
+        plans(std::move(sharedPlans))
     {
-        DftiCreateDescriptor(&realSetup, DFTI_DOUBLE, DFTI_REAL, 1, this->fftSize);
-        status += DftiSetValue(realSetup, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-        status += DftiSetValue(realSetup, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-        status += DftiSetValue(realSetup, DFTI_FORWARD_SCALE, 1.0);
-        status += DftiSetValue(realSetup, DFTI_BACKWARD_SCALE, 1.0 / fftSize);
-        status += DftiCommitDescriptor(realSetup);
-
-        DftiCreateDescriptor(&cplxSetup, DFTI_DOUBLE, DFTI_COMPLEX, 1, this->fftSize);
-        status += DftiSetValue(realSetup, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-        status += DftiSetValue(realSetup, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-        status += DftiSetValue(realSetup, DFTI_FORWARD_SCALE, 1.0);
-        status += DftiSetValue(realSetup, DFTI_BACKWARD_SCALE, 1.0 / fftSize);
-        status += DftiCommitDescriptor(cplxSetup);
-        assert(status == DFTI_NO_ERROR);
     }
 
-    ~DFTImpl()
+    ~MklDFT()
     {
-        if (realSetup) DftiFreeDescriptor(&realSetup);
-        if (cplxSetup) DftiFreeDescriptor(&cplxSetup);
+        batches.clear([](DFTI_DESCRIPTOR_HANDLE h) { DftiFreeDescriptor(&h); });
     }
 
-    void dft(const dcomplex* inPtr, dcomplex* outPtr)
+    void dft(const Complex* inPtr, Complex* outPtr)
     {
-        MKL_Complex16* inPtr_  = reinterpret_cast<MKL_Complex16*>(const_cast<dcomplex*>(inPtr));
-        MKL_Complex16* outPtr_ = reinterpret_cast<MKL_Complex16*>(outPtr);
-        DftiComputeForward(cplxSetup, inPtr_, outPtr_);
+        DftiComputeForward(plans->cplxSetup, const_cast<Complex*>(inPtr), outPtr);
     }
 
-    void idft(const dcomplex* inPtr, dcomplex* outPtr)
+    void idft(const Complex* inPtr, Complex* outPtr)
     {
-        MKL_Complex16* inPtr_  = reinterpret_cast<MKL_Complex16*>(const_cast<dcomplex*>(inPtr));
-        MKL_Complex16* outPtr_ = reinterpret_cast<MKL_Complex16*>(outPtr);
-        DftiComputeBackward(cplxSetup, inPtr_, outPtr_);
+        DftiComputeBackward(plans->cplxSetup, const_cast<Complex*>(inPtr), outPtr);
     }
 
-    void rdft(const double* inPtr, dcomplex* outPtr)
+    void rdft(const T* inPtr, Complex* outPtr)
     {
-        double*        inPtr_  = const_cast<double*>(inPtr);
-        MKL_Complex16* outPtr_ = reinterpret_cast<MKL_Complex16*>(outPtr);
-        DftiComputeForward(realSetup, inPtr_, outPtr_);
+        DftiComputeForward(plans->realSetup, const_cast<T*>(inPtr), outPtr);
     }
 
-    void irdft(const dcomplex* inPtr, double* outPtr)
+    void irdft(const Complex* inPtr, T* outPtr)
     {
-        MKL_Complex16* inPtr_ = reinterpret_cast<MKL_Complex16*>(const_cast<dcomplex*>(inPtr));
-        DftiComputeBackward(cplxSetup, inPtr_, outPtr);
+        DftiComputeBackward(plans->cplxSetup, const_cast<Complex*>(inPtr), outPtr);
+    }
+
+    bool hasBatch(const BatchShape& shape) const { return batches.find(shape) != nullptr; }
+
+    /// One descriptor per shape: DFTI_NUMBER_OF_TRANSFORMS columns, dist
+    /// apart on both sides. Forward and inverse of a domain share nothing,
+    /// so each kind gets its own descriptor (the scale is baked in).
+    void planBatch(const BatchShape& shape, const void*, void*, PlanRigor)
+    {
+        bool                   real   = shape.kind == DFTKind::RealForward || shape.kind == DFTKind::RealInverse;
+        DFTI_DESCRIPTOR_HANDLE handle = nullptr;
+        long                   st     = DftiCreateDescriptor(&handle, precision, real ? DFTI_REAL : DFTI_COMPLEX, 1, fftSize);
+        st += DftiSetValue(handle, DFTI_NUMBER_OF_TRANSFORMS, MKL_LONG(shape.count));
+        st += DftiSetValue(handle, DFTI_INPUT_DISTANCE, MKL_LONG(shape.dist));
+        st += DftiSetValue(handle, DFTI_OUTPUT_DISTANCE, MKL_LONG(shape.dist));
+        st += DftiSetValue(handle, DFTI_PLACEMENT, shape.inPlace ? DFTI_INPLACE : DFTI_NOT_INPLACE);
+        if (real) st += DftiSetValue(handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+        st += DftiSetValue(handle, DFTI_FORWARD_SCALE, 1.0);
+        st += DftiSetValue(handle, DFTI_BACKWARD_SCALE, 1.0 / fftSize);
+        st += DftiCommitDescriptor(handle);
+        assert(st == DFTI_NO_ERROR);
+        batches.add(shape, handle);
+    }
+
+    void runBatch(const BatchShape& shape, const void* inPtr, void* outPtr)
+    {
+        DFTI_DESCRIPTOR_HANDLE handle = *batches.find(shape);
+        void*                  in     = const_cast<void*>(inPtr);
+        if (shape.kind == DFTKind::Forward || shape.kind == DFTKind::RealForward) {
+            if (shape.inPlace) DftiComputeForward(handle, in);
+            else DftiComputeForward(handle, in, outPtr);
+        } else {
+            if (shape.inPlace) DftiComputeBackward(handle, in);
+            else DftiComputeBackward(handle, in, outPtr);
+        }
     }
 
     static const std::string getName()
@@ -81,10 +152,20 @@ class DFTImpl
         return "FFT_MKL";
     }
 
+    /// No planner state to persist.
+    static bool importWisdom(const std::string&) { return false; }
+    static bool exportWisdom(const std::string&) { return false; }
+
+    /// Any 2^a·3^b·5^c size gets a fast mixed-radix descriptor.
+    static size_t nextFastSize(size_t n)
+    {
+        return nextSmooth(n);
+    }
+
   private:
-    const size_t           fftSize;
-    DFTI_DESCRIPTOR_HANDLE realSetup;
-    DFTI_DESCRIPTOR_HANDLE cplxSetup;
-    long                   status = DFTI_NO_ERROR;
+    const size_t                 fftSize;
+    std::shared_ptr<const Plans> plans; ///< Single-column descriptors, shared by size.
+
+    BatchCache<DFTI_DESCRIPTOR_HANDLE> batches; ///< Batched descriptors of the matrix overloads.
 };
 } // namespace jsa::cicuetea
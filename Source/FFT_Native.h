@@ -0,0 +1,568 @@
+//
+//  FFT_Native.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/2/25.
+//
+
+/**
+ * @file FFT_Native.h
+ * @brief First-party, dependency-free FFT backend (powers of two)
+ * @author Juan Sierra
+ * @date 7/2/25
+ * @copyright MIT License
+ *
+ * A split-complex Stockham radix-4 FFT (see FFT_NativeKernels.h) with SIMD
+ * kernels for SSE2 and AVX2 on x86-64 and NEON on AArch64, plus a scalar
+ * fallback. The instruction set is chosen once per process at runtime (AVX2
+ * when the CPU has it); setting the environment variable
+ * CICUETEA_NATIVE_ISA to scalar, sse2, avx2 or neon forces a supported one.
+ * Real transforms of n points run as one n/2-point complex FFT plus an O(n)
+ * split pass. Scaling matches the other backends: forward transforms are
+ * unscaled, idft and irdft scale by 1/n.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <numbers>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    define CICUETEA_NATIVE_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+#    endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define CICUETEA_NATIVE_NEON 1
+#    include <arm_neon.h>
+#endif
+
+#include "FFT.hpp"
+#include "FFT_Batch.h"
+#include "MathUtils.h"
+
+using namespace Eigen;
+
+namespace jsa::cicuetea {
+namespace native {
+
+/// Instruction sets with a kernel build.
+enum class Isa { Scalar, SSE2, AVX2, NEON };
+
+//==========================================================================
+
+// Kernel functions carry CICUETEA_NATIVE_TARGET, the target attribute of
+// the instruction set they are included for (empty unless it is above the
+// build's baseline).
+#define CICUETEA_NATIVE_TARGET
+
+namespace scalar {
+template <typename T>
+struct Vec {
+    static constexpr Eigen::Index width = 1;
+    T                             v;
+
+    static Vec load(const T* p) { return {*p}; }
+    static Vec set1(T x) { return {x}; }
+    static void load2(const T* p, Vec& re, Vec& im) { re.v = p[0], im.v = p[1]; }
+    static void store2(T* p, Vec re, Vec im) { p[0] = re.v, p[1] = im.v; }
+    void        store(T* p) const { *p = v; }
+    Vec         reverse() const { return *this; }
+
+    friend Vec operator+(Vec a, Vec b) { return {a.v + b.v}; }
+    friend Vec operator-(Vec a, Vec b) { return {a.v - b.v}; }
+    friend Vec operator*(Vec a, Vec b) { return {a.v * b.v}; }
+};
+
+#include "FFT_NativeKernels.h"
+} // namespace scalar
+#undef CICUETEA_NATIVE_TARGET
+
+//==========================================================================
+
+#if CICUETEA_NATIVE_X86
+#    define CICUETEA_NATIVE_TARGET
+namespace sse2 {
+template <typename T>
+struct Vec;
+
+template <>
+struct Vec<double> {
+    static constexpr Eigen::Index width = 2;
+    __m128d                       v;
+
+    static Vec load(const double* p) { return {_mm_loadu_pd(p)}; }
+    static Vec set1(double x) { return {_mm_set1_pd(x)}; }
+    static void load2(const double* p, Vec& re, Vec& im)
+    {
+        __m128d a = _mm_loadu_pd(p), b = _mm_loadu_pd(p + 2);
+        re.v      = _mm_unpacklo_pd(a, b);
+        im.v      = _mm_unpackhi_pd(a, b);
+    }
+    static void store2(double* p, Vec re, Vec im)
+    {
+        _mm_storeu_pd(p, _mm_unpacklo_pd(re.v, im.v));
+        _mm_storeu_pd(p + 2, _mm_unpackhi_pd(re.v, im.v));
+    }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+    Vec  reverse() const { return {_mm_shuffle_pd(v, v, 1)}; }
+
+    friend Vec operator+(Vec a, Vec b) { return {_mm_add_pd(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) { return {_mm_sub_pd(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) { return {_mm_mul_pd(a.v, b.v)}; }
+};
+
+template <>
+struct Vec<float> {
+    static constexpr Eigen::Index width = 4;
+    __m128                        v;
+
+    static Vec load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Vec set1(float x) { return {_mm_set1_ps(x)}; }
+    static void load2(const float* p, Vec& re, Vec& im)
+    {
+        __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4);
+        re.v     = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        im.v     = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+    static void store2(float* p, Vec re, Vec im)
+    {
+        _mm_storeu_ps(p, _mm_unpacklo_ps(re.v, im.v));
+        _mm_storeu_ps(p + 4, _mm_unpackhi_ps(re.v, im.v));
+    }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    Vec  reverse() const { return {_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3))}; }
+
+    friend Vec operator+(Vec a, Vec b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) { return {_mm_mul_ps(a.v, b.v)}; }
+};
+
+#include "FFT_NativeKernels.h"
+} // namespace sse2
+#    undef CICUETEA_NATIVE_TARGET
+
+// Everything in avx2 is compiled for AVX2 regardless of the build flags;
+// it only runs after the runtime check in detectIsa(). MSVC compiles any
+// intrinsic without flags, so it needs no attribute.
+#    if defined(__GNUC__) || defined(__clang__)
+#        define CICUETEA_NATIVE_TARGET __attribute__((target("avx2")))
+#    else
+#        define CICUETEA_NATIVE_TARGET
+#    endif
+
+namespace avx2 {
+template <typename T>
+struct Vec;
+
+template <>
+struct Vec<double> {
+    static constexpr Eigen::Index width = 4;
+    __m256d                       v;
+
+    CICUETEA_NATIVE_TARGET static Vec load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    CICUETEA_NATIVE_TARGET static Vec set1(double x) { return {_mm256_set1_pd(x)}; }
+    CICUETEA_NATIVE_TARGET static void load2(const double* p, Vec& re, Vec& im)
+    {
+        __m256d a = _mm256_loadu_pd(p), b = _mm256_loadu_pd(p + 4);
+        re.v      = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        im.v      = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+    }
+    CICUETEA_NATIVE_TARGET static void store2(double* p, Vec re, Vec im)
+    {
+        __m256d r = _mm256_permute4x64_pd(re.v, _MM_SHUFFLE(3, 1, 2, 0));
+        __m256d i = _mm256_permute4x64_pd(im.v, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_pd(p, _mm256_unpacklo_pd(r, i));
+        _mm256_storeu_pd(p + 4, _mm256_unpackhi_pd(r, i));
+    }
+    CICUETEA_NATIVE_TARGET void store(double* p) const { _mm256_storeu_pd(p, v); }
+    CICUETEA_NATIVE_TARGET Vec reverse() const { return {_mm256_permute4x64_pd(v, _MM_SHUFFLE(0, 1, 2, 3))}; }
+
+    CICUETEA_NATIVE_TARGET friend Vec operator+(Vec a, Vec b) { return {_mm256_add_pd(a.v, b.v)}; }
+    CICUETEA_NATIVE_TARGET friend Vec operator-(Vec a, Vec b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    CICUETEA_NATIVE_TARGET friend Vec operator*(Vec a, Vec b) { return {_mm256_mul_pd(a.v, b.v)}; }
+};
+
+template <>
+struct Vec<float> {
+    static constexpr Eigen::Index width = 8;
+    __m256                        v;
+
+    CICUETEA_NATIVE_TARGET static Vec load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    CICUETEA_NATIVE_TARGET static Vec set1(float x) { return {_mm256_set1_ps(x)}; }
+    CICUETEA_NATIVE_TARGET static void load2(const float* p, Vec& re, Vec& im)
+    {
+        // In-lane shuffles leave 64-bit pairs in the order 0 2 1 3.
+        __m256 a = _mm256_loadu_ps(p), b = _mm256_loadu_ps(p + 8);
+        __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 i = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        re.v     = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0)));
+        im.v     = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(i), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    CICUETEA_NATIVE_TARGET static void store2(float* p, Vec re, Vec im)
+    {
+        __m256 r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re.v), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 i = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im.v), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(p, _mm256_unpacklo_ps(r, i));
+        _mm256_storeu_ps(p + 8, _mm256_unpackhi_ps(r, i));
+    }
+    CICUETEA_NATIVE_TARGET void store(float* p) const { _mm256_storeu_ps(p, v); }
+    CICUETEA_NATIVE_TARGET Vec reverse() const { return {_mm256_permutevar8x32_ps(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0))}; }
+
+    CICUETEA_NATIVE_TARGET friend Vec operator+(Vec a, Vec b) { return {_mm256_add_ps(a.v, b.v)}; }
+    CICUETEA_NATIVE_TARGET friend Vec operator-(Vec a, Vec b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    CICUETEA_NATIVE_TARGET friend Vec operator*(Vec a, Vec b) { return {_mm256_mul_ps(a.v, b.v)}; }
+};
+
+#include "FFT_NativeKernels.h"
+} // namespace avx2
+
+#    undef CICUETEA_NATIVE_TARGET
+#endif // CICUETEA_NATIVE_X86
+
+//==========================================================================
+
+#if CICUETEA_NATIVE_NEON
+#    define CICUETEA_NATIVE_TARGET
+namespace neon {
+template <typename T>
+struct Vec;
+
+template <>
+struct Vec<double> {
+    static constexpr Eigen::Index width = 2;
+    float64x2_t                   v;
+
+    static Vec load(const double* p) { return {vld1q_f64(p)}; }
+    static Vec set1(double x) { return {vdupq_n_f64(x)}; }
+    static void load2(const double* p, Vec& re, Vec& im)
+    {
+        float64x2x2_t a = vld2q_f64(p);
+        re.v            = a.val[0];
+        im.v            = a.val[1];
+    }
+    static void store2(double* p, Vec re, Vec im) { vst2q_f64(p, float64x2x2_t{{re.v, im.v}}); }
+    void        store(double* p) const { vst1q_f64(p, v); }
+    Vec         reverse() const { return {vextq_f64(v, v, 1)}; }
+
+    friend Vec operator+(Vec a, Vec b) { return {vaddq_f64(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) { return {vsubq_f64(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) { return {vmulq_f64(a.v, b.v)}; }
+};
+
+template <>
+struct Vec<float> {
+    static constexpr Eigen::Index width = 4;
+    float32x4_t                   v;
+
+    static Vec load(const float* p) { return {vld1q_f32(p)}; }
+    static Vec set1(float x) { return {vdupq_n_f32(x)}; }
+    static void load2(const float* p, Vec& re, Vec& im)
+    {
+        float32x4x2_t a = vld2q_f32(p);
+        re.v            = a.val[0];
+        im.v            = a.val[1];
+    }
+    static void store2(float* p, Vec re, Vec im) { vst2q_f32(p, float32x4x2_t{{re.v, im.v}}); }
+    void        store(float* p) const { vst1q_f32(p, v); }
+    Vec         reverse() const
+    {
+        float32x4_t r = vrev64q_f32(v);
+        return {vextq_f32(r, r, 2)};
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) { return {vmulq_f32(a.v, b.v)}; }
+};
+
+#include "FFT_NativeKernels.h"
+} // namespace neon
+#    undef CICUETEA_NATIVE_TARGET
+#endif // CICUETEA_NATIVE_NEON
+
+//==========================================================================
+
+/// One ISA's kernels for one precision, as plain function pointers.
+template <typename T>
+struct KernelTable {
+    Eigen::Index width;
+    void (*deinterleave)(const T*, T*, T*, Eigen::Index);
+    void (*interleave)(const T*, const T*, T*, Eigen::Index, T);
+    void (*radix4)(const T*, const T*, T*, T*, Eigen::Index, Eigen::Index, Eigen::Index, const T*);
+    void (*radix2)(const T*, const T*, T*, T*, Eigen::Index);
+    void (*realPost)(const T*, const T*, const T*, const T*, T*, Eigen::Index);
+    void (*realPre)(const T*, const T*, const T*, T*, T*, Eigen::Index, T);
+};
+
+template <typename T, typename K>
+constexpr KernelTable<T> tableOf()
+{
+    return {K::width, &K::deinterleave, &K::interleave, &K::radix4, &K::radix2, &K::realPost, &K::realPre};
+}
+
+inline Isa detectIsa()
+{
+    Isa best = Isa::Scalar;
+#if CICUETEA_NATIVE_X86
+    best = Isa::SSE2;
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0);
+    bool hasLeaf7 = r[0] >= 7;
+    __cpuid(r, 1);
+    bool osAvx = (r[2] & (1 << 27)) && (r[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    if (hasLeaf7 && osAvx) {
+        __cpuidex(r, 7, 0);
+        if (r[1] & (1 << 5)) best = Isa::AVX2;
+    }
+#    else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) best = Isa::AVX2;
+#    endif
+#elif CICUETEA_NATIVE_NEON
+    best = Isa::NEON;
+#endif
+
+    // Forcing only ever steps down to something the CPU runs.
+    if (const char* forced = std::getenv("CICUETEA_NATIVE_ISA")) {
+        std::string name(forced);
+        if (name == "scalar") return Isa::Scalar;
+        if (name == "sse2" && (best == Isa::SSE2 || best == Isa::AVX2)) return Isa::SSE2;
+        if (name == "avx2" && best == Isa::AVX2) return Isa::AVX2;
+        if (name == "neon" && best == Isa::NEON) return Isa::NEON;
+    }
+    return best;
+}
+
+/// The instruction set every native DFT of the process uses.
+inline Isa activeIsa()
+{
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+template <typename T>
+const KernelTable<T>& kernelsFor(Isa isa)
+{
+    static constexpr KernelTable<T> scalarTable = tableOf<T, scalar::Kernels<T>>();
+#if CICUETEA_NATIVE_X86
+    static constexpr KernelTable<T> sse2Table = tableOf<T, sse2::Kernels<T>>();
+    static constexpr KernelTable<T> avx2Table = tableOf<T, avx2::Kernels<T>>();
+    if (isa == Isa::AVX2) return avx2Table;
+    if (isa == Isa::SSE2) return sse2Table;
+#elif CICUETEA_NATIVE_NEON
+    static constexpr KernelTable<T> neonTable = tableOf<T, neon::Kernels<T>>();
+    if (isa == Isa::NEON) return neonTable;
+#endif
+    return scalarTable;
+}
+
+inline const char* isaName(Isa isa)
+{
+    switch (isa) {
+        case Isa::SSE2: return "SSE2";
+        case Isa::AVX2: return "AVX2";
+        case Isa::NEON: return "NEON";
+        default: return "scalar";
+    }
+}
+
+/**
+ * @brief Pass list and twiddles of one complex FFT size. Sizes below four
+ * vectors run the scalar kernels (a SIMD pass needs n/4 >= width).
+ */
+template <typename T>
+struct ComplexPlan {
+    struct Pass {
+        Eigen::Index l;      ///< Pass length (2 for the final radix-2 pass).
+        Eigen::Index s;      ///< Stride; l·s = n.
+        Eigen::Index offset; ///< Start of the pass's twiddles in tw.
+    };
+
+    ComplexPlan(Eigen::Index n, Isa isa) :
+        n(n)
+    {
+        kernels = &kernelsFor<T>(isa);
+        if (n < 4 * kernels->width) kernels = &kernelsFor<T>(Isa::Scalar);
+
+        const Eigen::Index width = kernels->width;
+        std::vector<T>     w;
+        Eigen::Index       l = n, s = 1;
+        for (; l >= 4; l /= 4, s *= 4) {
+            Eigen::Index len = s < width ? n / 4 : l / 4;
+            passes.push_back({l, s, Eigen::Index(w.size())});
+            w.resize(w.size() + 6 * len);
+            T* t = w.data() + passes.back().offset;
+            for (Eigen::Index j = 0; j < len; j++) {
+                Eigen::Index p = s < width ? j / s : j;
+                for (int k = 1; k <= 3; k++) {
+                    // Reduce k·p mod l first so the angle stays exact for large l.
+                    double a                 = -2 * std::numbers::pi * double((k * p) % l) / double(l);
+                    t[(2 * k - 2) * len + j] = T(std::cos(a));
+                    t[(2 * k - 1) * len + j] = T(std::sin(a));
+                }
+            }
+        }
+        if (l == 2) passes.push_back({2, s, 0});
+        tw = Map<const Array<T, Dynamic, 1>>(w.data(), Eigen::Index(w.size()));
+    }
+
+    /**
+     * @brief Forward FFT of the split data in (r0, i0), using (r1, i1) as
+     * the second buffer; returns the buffer pair holding the result. Swap
+     * the real and imaginary pointers on the way in and out for the
+     * (unscaled) inverse.
+     */
+    std::pair<T*, T*> run(T* r0, T* i0, T* r1, T* i1) const
+    {
+        for (const Pass& p : passes) {
+            if (p.l == 2) kernels->radix2(r0, i0, r1, i1, n);
+            else kernels->radix4(r0, i0, r1, i1, n, p.l, p.s, tw.data() + p.offset);
+            std::swap(r0, r1);
+            std::swap(i0, i1);
+        }
+        return {r0, i0};
+    }
+
+    Eigen::Index           n;
+    const KernelTable<T>*  kernels = nullptr;
+    std::vector<Pass>      passes;
+    Array<T, Dynamic, 1>   tw;
+};
+
+} // namespace native
+
+//==========================================================================
+
+/// The built-in backend (DFTBackend::Native); FFT_Backends.h adapts it to DFTImpl.
+template <typename T>
+class NativeDFT
+{
+    using Complex = std::complex<T>;
+
+  public:
+    /**
+     * @brief The pass lists and twiddles of one size: the n-point complex
+     * plan, the n/2-point plan and split twiddles of the real transforms.
+     * Read-only, so every DFT of the size shares one (see the plan registry
+     * in FFT.cpp) and keeps its own work buffers.
+     */
+    struct Plans {
+        Plans(size_t fftSize, PlanRigor /*rigor*/) :
+            fftSize(fftSize),
+            full(Eigen::Index(fftSize), native::activeIsa()),
+            half(Eigen::Index(fftSize / 2), native::activeIsa())
+        {
+            assert(fftSize >= 2 && nextPow2(fftSize) == fftSize && "Native FFT sizes are powers of two");
+            Eigen::Index h = Eigen::Index(fftSize / 2);
+            realWr.resize(h);
+            realWi.resize(h);
+            for (Eigen::Index k = 0; k < h; k++) {
+                double a  = -2 * std::numbers::pi * double(k) / double(fftSize);
+                realWr[k] = T(std::cos(a));
+                realWi[k] = T(std::sin(a));
+            }
+        }
+
+        const size_t           fftSize;
+        native::ComplexPlan<T> full;   ///< dft / idft.
+        native::ComplexPlan<T> half;   ///< rdft / irdft (n/2 points).
+        Array<T, Dynamic, 1>   realWr; ///< cos(2πk/n), k < n/2.
+        Array<T, Dynamic, 1>   realWi; ///< -sin(2πk/n), k < n/2.
+    };
+
+    explicit NativeDFT(std::shared_ptr<const Plans> sharedPlans) :
+        fftSize(sharedPlans->fftSize),
+        plans(std::move(sharedPlans)),
+        work(4 * Eigen::Index(fftSize))
+    {
+    }
+
+    void dft(const Complex* inPtr, Complex* outPtr)
+    {
+        const auto& f          = plans->full;
+        auto [r0, i0, r1, i1]  = buffers();
+        f.kernels->deinterleave(reinterpret_cast<const T*>(inPtr), r0, i0, f.n);
+        auto [re, im] = f.run(r0, i0, r1, i1);
+        f.kernels->interleave(re, im, reinterpret_cast<T*>(outPtr), f.n, T(1));
+    }
+
+    void idft(const Complex* inPtr, Complex* outPtr)
+    {
+        const auto& f          = plans->full;
+        auto [r0, i0, r1, i1]  = buffers();
+        f.kernels->deinterleave(reinterpret_cast<const T*>(inPtr), r0, i0, f.n);
+        auto [im, re] = f.run(i0, r0, i1, r1);
+        f.kernels->interleave(re, im, reinterpret_cast<T*>(outPtr), f.n, T(1) / T(fftSize));
+    }
+
+    void rdft(const T* inPtr, Complex* outPtr)
+    {
+        const auto& h          = plans->half;
+        auto [r0, i0, r1, i1]  = buffers();
+        h.kernels->deinterleave(inPtr, r0, i0, h.n);
+        auto [re, im] = h.run(r0, i0, r1, i1);
+        h.kernels->realPost(re, im, plans->realWr.data(), plans->realWi.data(), reinterpret_cast<T*>(outPtr),
+                            h.n);
+    }
+
+    void irdft(const Complex* inPtr, T* outPtr)
+    {
+        const auto& h          = plans->half;
+        auto [r0, i0, r1, i1]  = buffers();
+        h.kernels->realPre(reinterpret_cast<const T*>(inPtr), plans->realWr.data(), plans->realWi.data(), r0,
+                           i0, h.n, T(1) / T(fftSize));
+        auto [im, re] = h.run(i0, r0, i1, r1);
+        h.kernels->interleave(re, im, outPtr, h.n, T(1));
+    }
+
+    /// No batched interface: a batch is a column loop over the shared plan
+    /// and this DFT's work buffers, so nothing needs planning per shape.
+    bool hasBatch(const BatchShape&) const { return true; }
+    void planBatch(const BatchShape&, const void*, void*, PlanRigor) {}
+    void runBatch(const BatchShape& shape, const void* inPtr, void* outPtr)
+    {
+        runColumns<T>(*this, shape, inPtr, outPtr);
+    }
+
+    static std::string getName()
+    {
+        return std::string("Native (") + native::isaName(native::activeIsa()) + ")";
+    }
+
+    /// Nothing to plan beyond twiddles, so no planner state to persist.
+    static bool importWisdom(const std::string&) { return false; }
+    static bool exportWisdom(const std::string&) { return false; }
+
+    /// Radix-4/2 passes only take powers of two.
+    static size_t nextFastSize(size_t n)
+    {
+        return nextPow2(n);
+    }
+
+  private:
+    /// The two split-complex buffers (re, im each) the passes ping-pong between.
+    std::tuple<T*, T*, T*, T*> buffers()
+    {
+        T* w = work.data();
+        return {w, w + fftSize, w + 2 * fftSize, w + 3 * fftSize};
+    }
+
+    const size_t                 fftSize;
+    std::shared_ptr<const Plans> plans; ///< Passes and twiddles, shared by size.
+    Array<T, Dynamic, 1>         work;  ///< Four n-point arrays (two split buffers).
+};
+} // namespace jsa::cicuetea
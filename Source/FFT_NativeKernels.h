@@ -0,0 +1,232 @@
+//
+//  FFT_NativeKernels.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 7/2/25.
+//
+
+/**
+ * @file FFT_NativeKernels.h
+ * @brief ISA-independent kernels of the native FFT backend
+ * @author Juan Sierra
+ * @date 7/2/25
+ * @copyright MIT License
+ *
+ * Deliberately without include guard: FFT_Native.h includes this file once
+ * per instruction set, each time inside its own namespace that already
+ * declares Vec<T> (the SIMD register wrapper) and with
+ * CICUETEA_NATIVE_TARGET set to that instruction set's target attribute, so
+ * every copy of the kernels is compiled for its own ISA. Include nothing
+ * from here.
+ *
+ * Data is split-complex (separate real and imaginary arrays). The complex
+ * transform is a Stockham autosort FFT: radix-4 passes ping-ponging between
+ * two buffers, plus one radix-2 pass for odd powers of two, so there is no
+ * bit-reversal step. A pass of length l and stride s (l·s = n) reads
+ * x[q + s·(p + j·n/4)] and writes y[q + s·(4p + j)], p < l/4, q < s.
+ */
+
+template <typename T>
+struct Kernels {
+    using V = Vec<T>;
+
+    static constexpr Eigen::Index width = V::width;
+
+    /// Interleaved complex (or a real array read as pairs) to split.
+    CICUETEA_NATIVE_TARGET static void deinterleave(const T* in, T* re, T* im, Eigen::Index n)
+    {
+        Eigen::Index k = 0;
+        for (; k + width <= n; k += width) {
+            V r, i;
+            V::load2(in + 2 * k, r, i);
+            r.store(re + k);
+            i.store(im + k);
+        }
+        for (; k < n; k++) {
+            re[k] = in[2 * k];
+            im[k] = in[2 * k + 1];
+        }
+    }
+
+    /// Split to interleaved, multiplying by scale.
+    CICUETEA_NATIVE_TARGET static void interleave(const T* re, const T* im, T* out, Eigen::Index n, T scale)
+    {
+        V            g = V::set1(scale);
+        Eigen::Index k = 0;
+        for (; k + width <= n; k += width) V::store2(out + 2 * k, V::load(re + k) * g, V::load(im + k) * g);
+        for (; k < n; k++) {
+            out[2 * k]     = re[k] * scale;
+            out[2 * k + 1] = im[k] * scale;
+        }
+    }
+
+    /**
+     * @brief One forward radix-4 pass of length l, stride s, over n points.
+     *
+     * tw holds six arrays (w1 re/im, w2 re/im, w3 re/im) of len entries.
+     * With s >= width, len = l/4 and entry p is the twiddle of p; the loop
+     * over q is vectorized. With s < width, len = n/4 and entry s·p + q
+     * repeats the twiddle of p, so the loop runs over the flat input index
+     * and only the outputs need regrouping into blocks of s.
+     */
+    CICUETEA_NATIVE_TARGET static void radix4(const T* xr, const T* xi, T* yr, T* yi, Eigen::Index n, Eigen::Index l, Eigen::Index s, const T* tw)
+    {
+        const Eigen::Index m = n / 4;
+
+        if (s >= width) {
+            const Eigen::Index len = l / 4;
+            for (Eigen::Index p = 0; p < len; p++) {
+                const V      w1r = V::set1(tw[p]), w1i = V::set1(tw[len + p]);
+                const V      w2r = V::set1(tw[2 * len + p]), w2i = V::set1(tw[3 * len + p]);
+                const V      w3r = V::set1(tw[4 * len + p]), w3i = V::set1(tw[5 * len + p]);
+                Eigen::Index i0 = s * p, o0 = 4 * s * p;
+                for (Eigen::Index q = 0; q < s; q += width) {
+                    V out[8];
+                    butterfly(xr + i0 + q, xi + i0 + q, m, w1r, w1i, w2r, w2i, w3r, w3i, out);
+                    for (int j = 0; j < 4; j++) {
+                        out[2 * j].store(yr + o0 + j * s + q);
+                        out[2 * j + 1].store(yi + o0 + j * s + q);
+                    }
+                }
+            }
+            return;
+        }
+
+        for (Eigen::Index i = 0; i < m; i += width) {
+            V out[8];
+            butterfly(xr + i, xi + i, m, V::load(tw + i), V::load(tw + m + i), V::load(tw + 2 * m + i),
+                      V::load(tw + 3 * m + i), V::load(tw + 4 * m + i), V::load(tw + 5 * m + i), out);
+
+            T lanes[8][width];
+            for (int j = 0; j < 8; j++) out[j].store(lanes[j]);
+            for (Eigen::Index b = 0; b < width; b += s) {
+                Eigen::Index o0 = 4 * (i + b);
+                for (int j = 0; j < 4; j++)
+                    for (Eigen::Index q = 0; q < s; q++) {
+                        yr[o0 + j * s + q] = lanes[2 * j][b + q];
+                        yi[o0 + j * s + q] = lanes[2 * j + 1][b + q];
+                    }
+            }
+        }
+    }
+
+    /// The final radix-2 pass of odd powers of two (l = 2, s = n/2, no twiddles).
+    CICUETEA_NATIVE_TARGET static void radix2(const T* xr, const T* xi, T* yr, T* yi, Eigen::Index n)
+    {
+        const Eigen::Index s = n / 2;
+        Eigen::Index       q = 0;
+        for (; q + width <= s; q += width) {
+            V ar = V::load(xr + q), ai = V::load(xi + q);
+            V br = V::load(xr + s + q), bi = V::load(xi + s + q);
+            (ar + br).store(yr + q);
+            (ai + bi).store(yi + q);
+            (ar - br).store(yr + s + q);
+            (ai - bi).store(yi + s + q);
+        }
+        for (; q < s; q++) {
+            T ar = xr[q], ai = xi[q], br = xr[s + q], bi = xi[s + q];
+            yr[q]     = ar + br;
+            yi[q]     = ai + bi;
+            yr[s + q] = ar - br;
+            yi[s + q] = ai - bi;
+        }
+    }
+
+    /**
+     * @brief Spectrum of a real signal of 2h points from the h-point complex
+     * FFT z of its even/odd samples: X[k] = E[k] + W^k·O[k], with
+     * E = (Z[k] + Z*[h-k])/2, O = (Z[k] - Z*[h-k])/2i and W = (wr, wi).
+     * Writes X[0..h] interleaved.
+     */
+    CICUETEA_NATIVE_TARGET static void realPost(const T* zr, const T* zi, const T* wr, const T* wi, T* out, Eigen::Index h)
+    {
+        out[0]         = zr[0] + zi[0];
+        out[1]         = 0;
+        out[2 * h]     = zr[0] - zi[0];
+        out[2 * h + 1] = 0;
+
+        const V      half = V::set1(T(0.5));
+        Eigen::Index k    = 1;
+        for (; k + width <= h; k += width) {
+            V ar = V::load(zr + k), ai = V::load(zi + k);
+            V br = V::load(zr + h - k - width + 1).reverse();
+            V bi = V::load(zi + h - k - width + 1).reverse();
+            V er = (ar + br) * half, ei = (ai - bi) * half;
+            V dr = (ar - br) * half, di = (ai + bi) * half;
+            V c = V::load(wr + k), sn = V::load(wi + k);
+            V::store2(out + 2 * k, er + c * di + sn * dr, ei + sn * di - c * dr);
+        }
+        for (; k < h; k++) {
+            T ar = zr[k], ai = zi[k], br = zr[h - k], bi = zi[h - k];
+            T er = (ar + br) * T(0.5), ei = (ai - bi) * T(0.5);
+            T dr = (ar - br) * T(0.5), di = (ai + bi) * T(0.5);
+            out[2 * k]     = er + wr[k] * di + wi[k] * dr;
+            out[2 * k + 1] = ei + wi[k] * di - wr[k] * dr;
+        }
+    }
+
+    /**
+     * @brief Inverse of realPost: the h-point complex spectrum whose
+     * unnormalized inverse FFT holds the even/odd samples of the real
+     * signal with spectrum X[0..h] (interleaved in in), times scale. The
+     * imaginary parts of X[0] and X[h] are ignored.
+     */
+    CICUETEA_NATIVE_TARGET static void realPre(const T* in, const T* wr, const T* wi, T* zr, T* zi, Eigen::Index h, T scale)
+    {
+        zr[0] = (in[0] + in[2 * h]) * scale;
+        zi[0] = (in[0] - in[2 * h]) * scale;
+
+        const V      g = V::set1(scale);
+        Eigen::Index k = 1;
+        for (; k + width <= h; k += width) {
+            V ar, ai, br, bi;
+            V::load2(in + 2 * k, ar, ai);
+            V::load2(in + 2 * (h - k - width + 1), br, bi);
+            br = br.reverse();
+            bi = bi.reverse();
+            V sr = ar + br, si = ai - bi;
+            V dr = ar - br, di = ai + bi;
+            V c = V::load(wr + k), sn = V::load(wi + k);
+            V tr = c * dr + sn * di, ti = c * di - sn * dr;
+            ((sr - ti) * g).store(zr + k);
+            ((si + tr) * g).store(zi + k);
+        }
+        for (; k < h; k++) {
+            T ar = in[2 * k], ai = in[2 * k + 1], br = in[2 * (h - k)], bi = in[2 * (h - k) + 1];
+            T sr = ar + br, si = ai - bi;
+            T dr = ar - br, di = ai + bi;
+            T tr = wr[k] * dr + wi[k] * di, ti = wr[k] * di - wi[k] * dr;
+            zr[k] = (sr - ti) * scale;
+            zi[k] = (si + tr) * scale;
+        }
+    }
+
+  private:
+    /// Radix-4 butterfly on a, b, c, d = x[0], x[m], x[2m], x[3m]; writes
+    /// y0..y3 (re, im pairs) into out, twiddled by w1..w3.
+    CICUETEA_NATIVE_TARGET static void butterfly(const T* xr, const T* xi, Eigen::Index m, V w1r, V w1i, V w2r, V w2i, V w3r, V w3i, V* out)
+    {
+        V ar = V::load(xr), ai = V::load(xi);
+        V br = V::load(xr + m), bi = V::load(xi + m);
+        V cr = V::load(xr + 2 * m), ci = V::load(xi + 2 * m);
+        V dr = V::load(xr + 3 * m), di = V::load(xi + 3 * m);
+
+        V apcr = ar + cr, apci = ai + ci, amcr = ar - cr, amci = ai - ci;
+        V bpdr = br + dr, bpdi = bi + di, bmdr = br - dr, bmdi = bi - di;
+
+        out[0] = apcr + bpdr;
+        out[1] = apci + bpdi;
+
+        V t1r = amcr + bmdi, t1i = amci - bmdr; // (a - c) - i(b - d)
+        out[2] = t1r * w1r - t1i * w1i;
+        out[3] = t1r * w1i + t1i * w1r;
+
+        V t2r = apcr - bpdr, t2i = apci - bpdi;
+        out[4] = t2r * w2r - t2i * w2i;
+        out[5] = t2r * w2i + t2i * w2r;
+
+        V t3r = amcr - bmdi, t3i = amci + bmdr; // (a - c) + i(b - d)
+        out[6] = t3r * w3r - t3i * w3i;
+        out[7] = t3r * w3i + t3i * w3r;
+    }
+};
@@ -16,60 +16,128 @@
 #pragma once
 
 #include <cassert>
+#include <complex>
+#include <memory>
 
 #include <Eigen/Core>
+#include <pffft.h>
 #include <pffft_double.h>
 
+#include "FFT.hpp"
+#include "FFT_Batch.h"
+#include "MathUtils.h"
+
 using namespace Eigen;
 
 namespace jsa::cicuetea {
-class DFTImpl
+
+/**
+ * @brief Maps a scalar type onto PFFFT's per-precision API (pffftd_* for
+ * double, pffft_* for float; both are built into libpffft).
+ */
+template <typename T>
+struct PffftApi;
+
+template <>
+struct PffftApi<double> {
+    using Setup = PFFFTD_Setup;
+
+    static constexpr auto newSetup         = &pffftd_new_setup;
+    static constexpr auto destroySetup     = &pffftd_destroy_setup;
+    static constexpr auto transformOrdered = &pffftd_transform_ordered;
+};
+
+template <>
+struct PffftApi<float> {
+    using Setup = PFFFT_Setup;
+
+    static constexpr auto newSetup         = &pffft_new_setup;
+    static constexpr auto destroySetup     = &pffft_destroy_setup;
+    static constexpr auto transformOrdered = &pffft_transform_ordered;
+};
+
+/// The PFFFT backend (DFTBackend::PFFFT); FFT_Backends.h adapts it to DFTImpl.
+template <typename T>
+class PffftDFT
 {
+    using Api     = PffftApi<T>;
+    using Setup   = typename Api::Setup;
+    using Complex = std::complex<T>;
+
   public:
-    DFTImpl(size_t fftSize) :
-        fftSize(fftSize)
+    /**
+     * @brief The setups of one size. pffft_transform only reads a setup (all
+     * scratch is the work buffer), so every DFT of the size shares one set
+     * (see the plan registry in FFT.cpp) and keeps its own work buffer.
+     */
+    struct Plans {
+        Plans(size_t fftSize, PlanRigor /*rigor*/) :
+            fftSize(fftSize)
+        {
+            complexSetup = Api::newSetup(int(fftSize), PFFFT_COMPLEX);
+            realSetup    = Api::newSetup(int(fftSize), PFFFT_REAL);
+            assert(complexSetup && "Complex setup not initialized properly");
+            assert(realSetup && "Real setup not initialized properly");
+        }
+
+        ~Plans()
+        {
+            if (complexSetup) Api::destroySetup(complexSetup);
+            if (realSetup) Api::destroySetup(realSetup);
+        }
+
+        Plans(const Plans&)            = delete;
+        Plans& operator=(const Plans&) = delete;
+
+        const size_t fftSize;
+        Setup*       complexSetup = nullptr;
+        Setup*       realSetup    = nullptr;
+    };
+
+    explicit PffftDFT(std::shared_ptr<const Plans> sharedPlans) :
+        fftSize(sharedPlans->fftSize),
+        plans(std::move(sharedPlans))
     {
         workData.resize(2 * fftSize);
-        complexSetup = pffftd_new_setup(int(fftSize), PFFFT_COMPLEX);
-        realSetup    = pffftd_new_setup(int(fftSize), PFFFT_REAL);
-        assert(complexSetup && "Complex setup not initialized properly");
-        assert(realSetup && "Real setup not initialized properly");
     }
 
-    ~DFTImpl()
+    void dft(const Complex* inPtr, Complex* outPtr)
     {
-        if (complexSetup) pffftd_destroy_setup(complexSetup);
-        if (realSetup) pffftd_destroy_setup(realSetup);
+        T* inPtr_  = reinterpret_cast<T*>(const_cast<Complex*>(inPtr));
+        T* outPtr_ = reinterpret_cast<T*>(outPtr);
+        Api::transformOrdered(plans->complexSetup, inPtr_, outPtr_, workData.data(), PFFFT_FORWARD);
     }
 
-    void dft(const dcomplex* inPtr, dcomplex* outPtr)
+    void idft(const Complex* inPtr, Complex* outPtr)
     {
-        double* inPtr_  = reinterpret_cast<double*>(const_cast<dcomplex*>(inPtr));
-        double* outPtr_ = reinterpret_cast<double*>(outPtr);
-        pffftd_transform_ordered(complexSetup, inPtr_, outPtr_, workData.data(), PFFFT_FORWARD);
+        T* inPtr_  = reinterpret_cast<T*>(const_cast<Complex*>(inPtr));
+        T* outPtr_ = reinterpret_cast<T*>(outPtr);
+        Api::transformOrdered(plans->complexSetup, inPtr_, outPtr_, workData.data(), PFFFT_BACKWARD);
+        Map<Array<Complex, Dynamic, 1>>(outPtr, fftSize) *= T(1) / T(fftSize);
     }
 
-    void idft(const dcomplex* inPtr, dcomplex* outPtr)
+    void rdft(const T* inPtr, Complex* outPtr)
     {
-        double* inPtr_  = reinterpret_cast<double*>(const_cast<dcomplex*>(inPtr));
-        double* outPtr_ = reinterpret_cast<double*>(outPtr);
-        pffftd_transform_ordered(complexSetup, inPtr_, outPtr_, workData.data(), PFFFT_BACKWARD);
-        Map<ArrayXcd>(outPtr, fftSize) *= (1.0 / fftSize);
+        T* inPtr_  = const_cast<T*>(inPtr);
+        T* outPtr_ = reinterpret_cast<T*>(outPtr);
+        Api::transformOrdered(plans->realSetup, inPtr_, outPtr_, workData.data(), PFFFT_FORWARD);
     }
 
-    void rdft(const double* inPtr, dcomplex* outPtr)
+    void irdft(const Complex* inPtr, T* outPtr)
     {
-        double* inPtr_  = reinterpret_cast<double*>(const_cast<double*>(inPtr));
-        double* outPtr_ = reinterpret_cast<double*>(outPtr);
-        pffftd_transform_ordered(realSetup, inPtr_, outPtr_, workData.data(), PFFFT_FORWARD);
+        T* inPtr_  = reinterpret_cast<T*>(const_cast<Complex*>(inPtr));
+        T* outPtr_ = reinterpret_cast<T*>(outPtr);
+        Api::transformOrdered(plans->realSetup, inPtr_, outPtr_, workData.data(), PFFFT_BACKWARD);
+        Map<Array<T, Dynamic, 1>>(outPtr, fftSize) *= T(1) / T(fftSize);
     }
 
-    void irdft(const dcomplex* inPtr, double* outPtr)
+    /// No batched interface: a batch is a column loop over the one setup
+    /// and work buffer, so nothing needs planning per shape.
+    bool hasBatch(const BatchShape&) const { return true; }
+    void planBatch(const BatchShape&, const void*, void*, PlanRigor) {}
+    void runBatch(const BatchShape& shape, const void* inPtr, void* outPtr)
     {
-        double* inPtr_  = reinterpret_cast<double*>(const_cast<dcomplex*>(inPtr));
-        double* outPtr_ = reinterpret_cast<double*>(outPtr);
-        pffftd_transform_ordered(realSetup, inPtr_, outPtr_, workData.data(), PFFFT_BACKWARD);
-        Map<ArrayXd>(outPtr, fftSize) *= (1.0 / fftSize);
+        runColumns<T>(*this, shape, inPtr, outPtr);
     }
 
     static std::string getName()
@@ -77,10 +145,19 @@ class DFTImpl
         return "PFFFT";
     }
 
+    /// No planner state to persist.
+    static bool importWisdom(const std::string&) { return false; }
+    static bool exportWisdom(const std::string&) { return false; }
+
+    /// Complex setups need 2^a·3^b·5^c sizes that are multiples of 16.
+    static size_t nextFastSize(size_t n)
+    {
+        return nextSmooth(n, 16);
+    }
+
   private:
-    const size_t   fftSize;
-    Eigen::ArrayXd workData;
-    PFFFTD_Setup*  complexSetup = nullptr;
-    PFFFTD_Setup*  realSetup    = nullptr;
+    const size_t                 fftSize;
+    std::shared_ptr<const Plans> plans; ///< Setups, shared by size.
+    Array<T, Dynamic, 1>         workData;
 };
 } // namespace jsa::cicuetea
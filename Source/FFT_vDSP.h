@@ -16,80 +16,160 @@
 #pragma once
 
 #include <cassert>
+#include <cmath>
+#include <complex>
+#include <memory>
 
 #include <Accelerate/Accelerate.h>
 #include <Eigen/Core>
 
+#include "FFT.hpp"
+#include "FFT_Batch.h"
+#include "MathUtils.h"
+
 using namespace Eigen;
 
 namespace jsa::cicuetea {
-class DFTImpl
+
+/**
+ * @brief Maps a scalar type onto vDSP's per-precision API (the D-suffixed
+ * routines for double, the plain ones for float).
+ */
+template <typename T>
+struct VdspApi;
+
+template <>
+struct VdspApi<double> {
+    using Setup        = FFTSetupD;
+    using Interleaved  = DSPDoubleComplex;
+    using SplitComplex = DSPDoubleSplitComplex;
+
+    static constexpr auto createSetup  = &vDSP_create_fftsetupD;
+    static constexpr auto destroySetup = &vDSP_destroy_fftsetupD;
+    static constexpr auto ctoz         = &vDSP_ctozD;
+    static constexpr auto ztoc         = &vDSP_ztocD;
+    static constexpr auto fftZip       = &vDSP_fft_zipD;
+    static constexpr auto fftZrip      = &vDSP_fft_zripD;
+    static constexpr auto vsmul        = &vDSP_vsmulD;
+};
+
+template <>
+struct VdspApi<float> {
+    using Setup        = FFTSetup;
+    using Interleaved  = DSPComplex;
+    using SplitComplex = DSPSplitComplex;
+
+    static constexpr auto createSetup  = &vDSP_create_fftsetup;
+    static constexpr auto destroySetup = &vDSP_destroy_fftsetup;
+    static constexpr auto ctoz         = &vDSP_ctoz;
+    static constexpr auto ztoc         = &vDSP_ztoc;
+    static constexpr auto fftZip       = &vDSP_fft_zip;
+    static constexpr auto fftZrip      = &vDSP_fft_zrip;
+    static constexpr auto vsmul        = &vDSP_vsmul;
+};
+
+/// The vDSP backend (DFTBackend::VDSP); FFT_Backends.h adapts it to DFTImpl.
+template <typename T>
+class VdspDFT
 {
+    using Api          = VdspApi<T>;
+    using Interleaved  = typename Api::Interleaved;
+    using SplitComplex = typename Api::SplitComplex;
+    using Complex      = std::complex<T>;
+
   public:
-    DFTImpl(size_t fftSize) :
-        workData(fftSize / 2, 4),
-        fftOrder(log2(fftSize)),
-        fftSize(fftSize),
-        inverseFactor(1.0 / double(fftSize))
+    /**
+     * @brief The setup of one size. A setup is read-only once created and
+     * may be used from several threads, so every DFT of the size shares it
+     * (see the plan registry in FFT.cpp) and keeps its own split buffers.
+     */
+    struct Plans {
+        Plans(size_t fftSize, PlanRigor /*rigor*/) :
+            fftSize(fftSize)
+        {
+            setup = Api::createSetup(log2(fftSize), kFFTRadix2);
+            assert(setup != nullptr);
+        }
+
+        ~Plans()
+        {
+            if (setup) Api::destroySetup(setup);
+        }
+
+        Plans(const Plans&)            = delete;
+        Plans& operator=(const Plans&) = delete;
+
+        const size_t        fftSize;
+        typename Api::Setup setup = nullptr;
+    };
+
+    explicit VdspDFT(std::shared_ptr<const Plans> sharedPlans) :
+        plans(std::move(sharedPlans)),
+        workData(plans->fftSize / 2, 4),
+        fftOrder(log2(plans->fftSize)),
+        fftSize(plans->fftSize),
+        inverseFactor(T(1) / T(fftSize))
     {
         assert(exp2(fftOrder) == fftSize);
-        setup = vDSP_create_fftsetupD(log2(fftSize), kFFTRadix2);
         workData.setZero();
-        assert(setup != nullptr);
     }
 
-    ~DFTImpl()
+    void dft(const Complex* inPtr, Complex* outPtr)
     {
-        if (setup) vDSP_destroy_fftsetupD(setup);
+        Interleaved* inPtr_       = reinterpret_cast<Interleaved*>(const_cast<Complex*>(inPtr));
+        Interleaved* outPtr_      = reinterpret_cast<Interleaved*>(outPtr);
+        SplitComplex splitComplex = {workData.col(0).data(), workData.col(2).data()};
+        Api::ctoz(inPtr_, doubleStride, &splitComplex, singleStride, fftSize);
+        Api::fftZip(plans->setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Forward);
+        Api::ztoc(&splitComplex, singleStride, outPtr_, doubleStride, fftSize);
     }
 
-    void dft(const dcomplex* inPtr, dcomplex* outPtr)
+    void idft(const Complex* inPtr, Complex* outPtr)
     {
-        DSPDoubleComplex*     inPtr_       = reinterpret_cast<DSPDoubleComplex*>(const_cast<dcomplex*>(inPtr));
-        DSPDoubleComplex*     outPtr_      = reinterpret_cast<DSPDoubleComplex*>(outPtr);
-        DSPDoubleSplitComplex splitComplex = {workData.col(0).data(), workData.col(2).data()};
-        vDSP_ctozD(inPtr_, doubleStride, &splitComplex, singleStride, fftSize);
-        vDSP_fft_zipD(setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Forward);
-        vDSP_ztocD(&splitComplex, singleStride, outPtr_, doubleStride, fftSize);
+        Interleaved* inPtr_       = reinterpret_cast<Interleaved*>(const_cast<Complex*>(inPtr));
+        Interleaved* outPtr_      = reinterpret_cast<Interleaved*>(outPtr);
+        T*           mulPtr       = reinterpret_cast<T*>(outPtr);
+        SplitComplex splitComplex = {workData.col(0).data(), workData.col(2).data()};
+        Api::ctoz(inPtr_, doubleStride, &splitComplex, singleStride, fftSize);
+        Api::fftZip(plans->setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Inverse);
+        Api::ztoc(&splitComplex, singleStride, outPtr_, doubleStride, fftSize);
+        Api::vsmul(mulPtr, singleStride, &inverseFactor, mulPtr, singleStride, 2 * fftSize);
     }
 
-    void idft(const dcomplex* inPtr, dcomplex* outPtr)
+    void rdft(const T* inPtr, Complex* outPtr)
     {
-        DSPDoubleComplex*     inPtr_       = reinterpret_cast<DSPDoubleComplex*>(const_cast<dcomplex*>(inPtr));
-        DSPDoubleComplex*     outPtr_      = reinterpret_cast<DSPDoubleComplex*>(outPtr);
-        double*               mulPtr       = reinterpret_cast<double*>(outPtr);
-        DSPDoubleSplitComplex splitComplex = {workData.col(0).data(), workData.col(2).data()};
-        vDSP_ctozD(inPtr_, doubleStride, &splitComplex, singleStride, fftSize);
-        vDSP_fft_zipD(setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Inverse);
-        vDSP_ztocD(&splitComplex, singleStride, outPtr_, doubleStride, fftSize);
-        vDSP_vsmulD(mulPtr, singleStride, &inverseFactor, mulPtr, singleStride, 2 * fftSize);
-    }
-
-    void rdft(const double* inPtr, dcomplex* outPtr)
-    {
-        DSPDoubleComplex*     inPtr_       = reinterpret_cast<DSPDoubleComplex*>(const_cast<double*>(inPtr));
-        DSPDoubleComplex*     outPtr_      = reinterpret_cast<DSPDoubleComplex*>(outPtr);
-        double*               mulPtr       = reinterpret_cast<double*>(outPtr);
-        DSPDoubleSplitComplex splitComplex = {workData.col(0).data(), workData.col(1).data()};
-        vDSP_ctozD(inPtr_, doubleStride, &splitComplex, singleStride, fftSize / 2);
-        vDSP_fft_zripD(setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Forward);
-        vDSP_ztocD(&splitComplex, singleStride, outPtr_, doubleStride, fftSize / 2);
-        vDSP_vsmulD(mulPtr, singleStride, &forwardFactor, mulPtr, singleStride, fftSize);
+        Interleaved* inPtr_       = reinterpret_cast<Interleaved*>(const_cast<T*>(inPtr));
+        Interleaved* outPtr_      = reinterpret_cast<Interleaved*>(outPtr);
+        T*           mulPtr       = reinterpret_cast<T*>(outPtr);
+        SplitComplex splitComplex = {workData.col(0).data(), workData.col(1).data()};
+        Api::ctoz(inPtr_, doubleStride, &splitComplex, singleStride, fftSize / 2);
+        Api::fftZrip(plans->setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Forward);
+        Api::ztoc(&splitComplex, singleStride, outPtr_, doubleStride, fftSize / 2);
+        Api::vsmul(mulPtr, singleStride, &forwardFactor, mulPtr, singleStride, fftSize);
         outPtr_[fftSize / 2].real = outPtr_[0].imag;
         outPtr_[0].imag           = 0.0;
     }
 
-    void irdft(const dcomplex* inPtr, double* outPtr)
+    void irdft(const Complex* inPtr, T* outPtr)
     {
-        DSPDoubleComplex*     inPtr_       = reinterpret_cast<DSPDoubleComplex*>(const_cast<dcomplex*>(inPtr));
-        DSPDoubleComplex*     outPtr_      = reinterpret_cast<DSPDoubleComplex*>(outPtr);
-        double*               mulPtr       = reinterpret_cast<double*>(outPtr);
-        DSPDoubleSplitComplex splitComplex = {workData.col(0).data(), workData.col(1).data()};
-        vDSP_ctozD(inPtr_, doubleStride, &splitComplex, singleStride, fftSize / 2);
+        Interleaved* inPtr_       = reinterpret_cast<Interleaved*>(const_cast<Complex*>(inPtr));
+        Interleaved* outPtr_      = reinterpret_cast<Interleaved*>(outPtr);
+        T*           mulPtr       = reinterpret_cast<T*>(outPtr);
+        SplitComplex splitComplex = {workData.col(0).data(), workData.col(1).data()};
+        Api::ctoz(inPtr_, doubleStride, &splitComplex, singleStride, fftSize / 2);
         splitComplex.imagp[0] = inPtr_[fftSize / 2].real;
-        vDSP_fft_zripD(setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Inverse);
-        vDSP_ztocD(&splitComplex, singleStride, outPtr_, doubleStride, fftSize / 2);
-        vDSP_vsmulD(mulPtr, singleStride, &inverseFactor, mulPtr, singleStride, fftSize);
+        Api::fftZrip(plans->setup, &splitComplex, singleStride, fftOrder, kFFTDirection_Inverse);
+        Api::ztoc(&splitComplex, singleStride, outPtr_, doubleStride, fftSize / 2);
+        Api::vsmul(mulPtr, singleStride, &inverseFactor, mulPtr, singleStride, fftSize);
+    }
+
+    /// No batched interface: a batch is a column loop over the one setup
+    /// and work buffer, so nothing needs planning per shape.
+    bool hasBatch(const BatchShape&) const { return true; }
+    void planBatch(const BatchShape&, const void*, void*, PlanRigor) {}
+    void runBatch(const BatchShape& shape, const void* inPtr, void* outPtr)
+    {
+        runColumns<T>(*this, shape, inPtr, outPtr);
     }
 
     static const std::string getName()
@@ -97,14 +177,24 @@ class DFTImpl
         return "vDSP";
     }
 
+    /// No planner state to persist.
+    static bool importWisdom(const std::string&) { return false; }
+    static bool exportWisdom(const std::string&) { return false; }
+
+    /// The radix-2 setups only take powers of two.
+    static size_t nextFastSize(size_t n)
+    {
+        return nextPow2(n);
+    }
+
   private:
-    FFTSetupD         setup = nullptr;
-    Eigen::ArrayX4d   workData;
-    const vDSP_Length fftOrder;
-    const size_t      fftSize;
-    double            forwardFactor = 0.5;
-    double            inverseFactor = NAN;
-    const vDSP_Stride singleStride  = 1;
-    const vDSP_Stride doubleStride  = 2;
+    std::shared_ptr<const Plans> plans; ///< Setup, shared by size.
+    Eigen::Array<T, Dynamic, 4>  workData;
+    const vDSP_Length            fftOrder;
+    const size_t                 fftSize;
+    T                            forwardFactor = 0.5;
+    T                            inverseFactor = NAN;
+    const vDSP_Stride            singleStride  = 1;
+    const vDSP_Stride            doubleStride  = 2;
 };
 } // namespace jsa::cicuetea
@@ -0,0 +1,138 @@
+//
+//  FrameCache.cpp
+//  CQTDSP
+//
+//  Created by Juan Sierra on 6/26/25.
+//
+
+#include "FrameCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using namespace jsa::cicuetea;
+
+namespace {
+std::mutex& directoryMutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+std::string& directoryName()
+{
+    static std::string dir;
+    return dir;
+}
+
+template <typename V>
+void hashCombine(std::size_t& seed, const V& v)
+{
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &v, sizeof(V));
+    seed ^= std::hash<std::uint64_t>{}(bits) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+} // namespace
+
+void FrameCache::setDirectory(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(directoryMutex());
+    directoryName() = directory;
+}
+
+std::string FrameCache::getDirectory()
+{
+    std::lock_guard<std::mutex> lock(directoryMutex());
+    return directoryName();
+}
+
+std::string FrameCache::pathFor(const FrameKey& key, const std::string& kind)
+{
+    std::string dir = getDirectory();
+    if (dir.empty()) return "";
+
+    // The key itself is stored in the file and compared on load; the hash
+    // only has to spread configurations over file names.
+    std::size_t seed = version;
+    hashCombine(seed, key.fs);
+    hashCombine(seed, key.nSamps);
+    hashCombine(seed, key.frac);
+    hashCombine(seed, key.fMin);
+    hashCombine(seed, key.fMax);
+    hashCombine(seed, key.fRef);
+    hashCombine(seed, key.spans);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s-%016llx.cqtframe", kind.c_str(), (unsigned long long)seed);
+    return (std::filesystem::path(dir) / name).string();
+}
+
+bool FrameCache::writeFile(const std::string& path, const std::vector<unsigned char>& bytes)
+{
+    std::error_code ec;
+    std::filesystem::path target(path);
+    std::filesystem::create_directories(target.parent_path(), ec);
+
+    std::filesystem::path tmp = target;
+    tmp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, target, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
+}
+
+//==========================================================================
+
+FrameCache::MappedFile::MappedFile(const std::string& path)
+{
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ptr    = static_cast<const unsigned char*>(p);
+            len    = std::size_t(st.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return;
+    buffer.resize(std::size_t(in.tellg()));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(buffer.data()), std::streamsize(buffer.size()))) return;
+    ptr = buffer.data();
+    len = buffer.size();
+#endif
+}
+
+FrameCache::MappedFile::~MappedFile()
+{
+#if !defined(_WIN32)
+    if (mapped) ::munmap(const_cast<unsigned char*>(ptr), len);
+#endif
+}
@@ -8,6 +8,7 @@
 #include "Slicer.hpp"
 
 #include <algorithm>
+#include <cassert>
 
 #include "MathUtils.h"
 #include "RTChecker.h"
@@ -15,7 +16,8 @@
 using namespace jsa::cicuetea;
 using namespace Eigen;
 
-Slicer::Slicer(Index newBlockSize, Index newHopSize)
+template <typename T>
+BasicSlicer<T>::BasicSlicer(Index newBlockSize, Index newHopSize)
 {
     blockSize   = std::max<Index>(newBlockSize, 1);
     hopSize     = std::clamp<Index>(newHopSize, 1, blockSize);
@@ -27,7 +29,8 @@ Slicer::Slicer(Index newBlockSize, Index newHopSize)
     rp = constrain(bufferSize - overlapSize, bufferSize);
 }
 
-void Slicer::pushSample(double sample)
+template <typename T>
+void BasicSlicer<T>::pushSample(T sample)
 {
     RealTimeChecker rt;
     wp         = constrain(wp, bufferSize);
@@ -35,17 +38,42 @@ void Slicer::pushSample(double sample)
     wp++;
 }
 
-bool Slicer::hasBlock()
+template <typename T>
+void BasicSlicer<T>::pushSamples(const T* samples, Index n)
+{
+    RealTimeChecker rt;
+    assert(n <= getSamplesToBlock());
+    while (n > 0) {
+        wp        = constrain(wp, bufferSize);
+        Index run = std::min<Index>(n, bufferSize - Index(wp));
+
+        Map<const RealArray> src(samples, run);
+        buffer.segment(wp, run)              = src;
+        buffer.segment(wp + bufferSize, run) = src;
+        wp += run;
+        samples += run;
+        n -= run;
+    }
+}
+
+template <typename T>
+bool BasicSlicer<T>::hasBlock()
 {
     RealTimeChecker rt;
     return (wp % hopSize) == 0;
 }
 
-Map<const ArrayXd> Slicer::getBlock()
+template <typename T>
+Map<const typename BasicSlicer<T>::RealArray> BasicSlicer<T>::getBlock()
 {
     RealTimeChecker rt;
     rp           = constrain(rp, bufferSize);
     auto segment = buffer.segment(rp, blockSize);
     rp += hopSize;
-    return Map<const ArrayXd>(segment.data(), segment.size());
+    return Map<const RealArray>(segment.data(), segment.size());
 }
+
+//==========================================================================
+
+template class jsa::cicuetea::BasicSlicer<float>;
+template class jsa::cicuetea::BasicSlicer<double>;
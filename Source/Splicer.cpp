@@ -15,7 +15,8 @@
 using namespace jsa::cicuetea;
 using namespace Eigen;
 
-Splicer::Splicer(Index newBlockSize, Index newHopSize)
+template <typename T>
+BasicSplicer<T>::BasicSplicer(Index newBlockSize, Index newHopSize)
 {
     blockSize   = std::max<Index>(newBlockSize, 1);
     hopSize     = std::clamp<Index>(newHopSize, 1, blockSize);
@@ -27,7 +28,8 @@ Splicer::Splicer(Index newBlockSize, Index newHopSize)
     rp = constrain(bufferSize - hopSize, bufferSize);
 }
 
-void Splicer::pushBlock(const ArrayXd& block)
+template <typename T>
+void BasicSplicer<T>::pushBlock(const Ref<const RealArray>& block)
 {
     RealTimeChecker rt;
     for (Index n = 0, m = wp; n < block.size(); n++, m++) {
@@ -41,11 +43,30 @@ void Splicer::pushBlock(const ArrayXd& block)
     wp = constrain(wp, bufferSize);
 }
 
-double Splicer::getSample()
+template <typename T>
+T BasicSplicer<T>::getSample()
 {
     RealTimeChecker rt;
-    double          sample = buffer(rp);
+    T               sample = buffer(rp);
     rp++;
     rp = constrain(rp, bufferSize);
     return sample;
 }
+
+template <typename T>
+void BasicSplicer<T>::getSamples(T* samples, Index n)
+{
+    RealTimeChecker rt;
+    while (n > 0) {
+        Index run                    = std::min<Index>(n, bufferSize - Index(rp));
+        Map<RealArray>(samples, run) = buffer.segment(rp, run);
+        rp                           = constrain(rp + run, bufferSize);
+        samples += run;
+        n -= run;
+    }
+}
+
+//==========================================================================
+
+template class jsa::cicuetea::BasicSplicer<float>;
+template class jsa::cicuetea::BasicSplicer<double>;
@@ -0,0 +1,144 @@
+//
+//  ThreadPool.h
+//  CQTDSP
+//
+//  Created by Juan Sierra on 6/22/25.
+//
+
+/**
+ * @file ThreadPool.h
+ * @brief Minimal fork-join pool used by the opt-in parallel band loops
+ * @author Juan Sierra
+ * @date 6/22/25
+ * @copyright MIT License
+ *
+ * One call shape only: parallelFor(n, body) runs body(i) for every i in
+ * [0, n) across the workers *and* the calling thread, and returns once all of
+ * them are done. Indices are claimed one at a time from an atomic counter, so
+ * the uneven cost of CQT bands (span length grows with frequency) balances
+ * itself. Which thread runs which index is therefore not deterministic —
+ * callers must make each index write only to memory no other index touches.
+ *
+ * Dispatch is allocation-free (the body is passed by reference through a
+ * function pointer, not a std::function), so it can run under
+ * RealTimeChecker; it still blocks on a condition variable and is meant for
+ * offline work, not the audio callback.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace jsa::cicuetea {
+
+class ThreadPool
+{
+  public:
+    /**
+     * @brief Starts numThreads - 1 workers; the caller of parallelFor() is
+     * the remaining participant.
+     */
+    explicit ThreadPool(unsigned numThreads)
+    {
+        for (unsigned w = 1; w < numThreads; w++)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Number of threads taking part in parallelFor(), caller included.
+    unsigned size() const { return unsigned(workers.size()) + 1; }
+
+    /**
+     * @brief Runs body(i) for i in [0, n) on all participants; blocks until
+     * every index has completed.
+     */
+    template <typename F>
+    void parallelFor(Eigen::Index n, F& body)
+    {
+        if (workers.empty() || n <= 1) {
+            for (Eigen::Index i = 0; i < n; i++) body(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job    = {&invoke<F>, &body, n};
+            next   = 0;
+            active = unsigned(workers.size());
+            generation++;
+        }
+        wake.notify_all();
+
+        drain();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return active == 0; });
+    }
+
+  private:
+    struct Job {
+        void (*call)(void*, Eigen::Index) = nullptr; ///< Type-erased body.
+        void*        body                 = nullptr; ///< The caller's functor.
+        Eigen::Index n                    = 0;       ///< Number of indices.
+    };
+
+    template <typename F>
+    static void invoke(void* body, Eigen::Index i)
+    {
+        (*static_cast<F*>(body))(i);
+    }
+
+    /// Claims and runs indices until none are left.
+    void drain()
+    {
+        for (Eigen::Index i = next++; i < job.n; i = next++) job.call(job.body, i);
+    }
+
+    void workerLoop()
+    {
+        unsigned long seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+
+            drain();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--active == 0) done.notify_one();
+        }
+    }
+
+    std::vector<std::thread>  workers;        ///< Helper threads (size() - 1).
+    std::mutex                mutex;          ///< Guards job, generation, active, quit.
+    std::condition_variable   wake;           ///< Signals a new job (or quit) to workers.
+    std::condition_variable   done;           ///< Signals the caller that workers finished.
+    Job                       job;            ///< Current job; fixed while it runs.
+    std::atomic<Eigen::Index> next{0};        ///< Next unclaimed index.
+    unsigned long             generation = 0; ///< Bumped once per job.
+    unsigned                  active     = 0; ///< Workers still inside the current job.
+    bool                      quit       = false;
+};
+
+} // namespace jsa::cicuetea
@@ -4,7 +4,12 @@ set(IncludeFiles
     Include/FFT.hpp
     Include/CQT.hpp
     Include/CQTProcessor.hpp
+    Include/FrameRegistry.hpp
+    Include/FrameCache.hpp
     Include/DoubleBuffer.h
+    Include/HistoryBuffer.h
+    Include/StageScheduler.h
+    Include/SnapshotTap.h
     Include/MathUtils.h
     Include/SignalUtils.h
 )
@@ -14,8 +19,16 @@ set(SourceFiles
     Source/FFT_vDSP.h
     Source/FFT_PFFFT.h
     Source/FFT_MKL.h
+    Source/FFT_Native.h
+    Source/FFT_NativeKernels.h
+    Source/FFT_Batch.h
+    Source/FFT_Backends.h
+    Source/FFT_Codelets.h
+    Source/ThreadPool.h
+    Source/AsyncWorker.h
     Source/Splicer.cpp
     Source/Slicer.cpp
+    Source/FrameCache.cpp
     Source/FFT.cpp
     Source/CQT.cpp
     Source/CQTProcessor.cpp
@@ -11,13 +11,21 @@
 //       numerical precision, for the dense, sparse, and block-streamed cases.
 //
 
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 #include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <numbers>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <Eigen/Core>
 
 #include <CQT.hpp>
+#include <FrameCache.hpp>
 #include <MathUtils.h>
 #include <SignalUtils.h>
 
@@ -128,6 +136,510 @@ BOOST_AUTO_TEST_CASE(CQTTestSparse2)
     }
 }
 
+// Parallel band loops (setNumThreads): every band writes its own scratch and
+// the inverse accumulates by disjoint bin tiles in band order, so the output
+// must be bit-identical to the serial path for any thread count — including
+// counts that do not divide the number of bands.
+BOOST_AUTO_TEST_CASE(CQTTestSparseParallel)
+{
+    double fs     = 48000;
+    int    nSamps = 1 << 16;
+
+    NsgfCqtSparse cqt(fs, nSamps, 1.0 / 12.0, 100, 10000, 1500);
+    ArrayXd       x = ArrayXd::Random(nSamps);
+    ArrayXd       yRef(nSamps);
+    auto          XRef = cqt.getCoefs();
+
+    BOOST_CHECK(cqt.getNumThreads() == 1);
+    cqt.forward(x, XRef);
+    cqt.inverse(XRef, yRef);
+
+    for (unsigned nThreads : {2u, 3u, 8u}) {
+        cqt.setNumThreads(nThreads);
+        BOOST_CHECK(cqt.getNumThreads() == nThreads);
+
+        ArrayXd y(nSamps);
+        auto    Xcq = cqt.getCoefs();
+        cqt.forward(x, Xcq);
+        cqt.inverse(XRef, y);
+
+        bool same = true;
+        for (Index k = 0; k < cqt.getNumBands(); k++) same &= (Xcq[k] == XRef[k]).all();
+        BOOST_CHECK_MESSAGE(same, "forward differs at " << nThreads << " threads");
+        BOOST_CHECK_MESSAGE((y == yRef).all(), "inverse differs at " << nThreads << " threads");
+    }
+
+    cqt.setNumThreads(1);
+    BOOST_CHECK(cqt.getNumThreads() == 1);
+}
+
+// Multi-channel overloads: one frame, samples × channels in, per-channel
+// coefficients out. Each channel must match the single-channel transform
+// and round-trip at numerical precision, serial and parallel alike.
+BOOST_AUTO_TEST_CASE(CQTTestMultiChannel)
+{
+    double fs  = 48000;
+    Index  nCh = 3;
+
+    {
+        Index        N = 1 << 10;
+        NsgfCqtDense cqt(fs, N, 1, 100, 10000, 1500);
+        ArrayXXd     x = ArrayXXd::Random(N, nCh);
+        ArrayXXd     y(N, nCh);
+        NsgfCqtDense::MultiCoefs Xcq(nCh, ArrayXXcd(N, cqt.getNumBands()));
+
+        cqt.forward(x, Xcq);
+        cqt.inverse(Xcq, y);
+
+        for (Index c = 0; c < nCh; c++) {
+            ArrayXd   xc = x.col(c);
+            ArrayXXcd Xc(N, cqt.getNumBands());
+            cqt.forward(xc, Xc);
+            BOOST_CHECK((Xc - Xcq[c]).abs().maxCoeff() < 1e-12);
+            ArrayXd dif = xc - y.col(c);
+            BOOST_CHECK_MESSAGE(rms(dif) < 1e-10, "dense ch " << c << ", rms = " << rms(dif));
+        }
+    }
+
+    for (unsigned nThreads : {1u, 3u}) {
+        Index         N = 1 << 14;
+        NsgfCqtSparse cqt(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+        cqt.setNumThreads(nThreads);
+        ArrayXXd x   = ArrayXXd::Random(N, nCh);
+        ArrayXXd y(N, nCh);
+        auto     Xcq = cqt.getCoefs(nCh);
+
+        cqt.forward(x, Xcq);
+        cqt.inverse(Xcq, y);
+
+        for (Index c = 0; c < nCh; c++) {
+            ArrayXd xc = x.col(c);
+            auto    Xc = cqt.getCoefs();
+            cqt.forward(xc, Xc);
+            double maxDif = 0;
+            for (Index k = 0; k < cqt.getNumBands(); k++)
+                maxDif = std::max(maxDif, (Xc[k] - Xcq[c][k]).abs().maxCoeff());
+            BOOST_CHECK(maxDif < 1e-12);
+            ArrayXd dif = xc - y.col(c);
+            BOOST_CHECK_MESSAGE(rms(dif) < 1e-10, "sparse ch " << c << ", threads " << nThreads
+                                                               << ", rms = " << rms(dif));
+        }
+    }
+}
+
+// Const overloads on caller-owned workspaces: several threads share one
+// object (one frame), each with its own Workspace, and every result must be
+// bit-identical to the object's own non-const path on the same input.
+BOOST_AUTO_TEST_CASE(CQTTestWorkspace)
+{
+    double fs  = 48000;
+    int    nTh = 4;
+
+    {
+        Index        N = 1 << 10;
+        NsgfCqtDense cqt(fs, N, 1, 100, 10000, 1500);
+        ArrayXd      x = ArrayXd::Random(N);
+        ArrayXd      y(N), yRef(N);
+        ArrayXXcd    Xcq(N, cqt.getNumBands()), XRef(N, cqt.getNumBands());
+
+        cqt.forward(x, XRef);
+        cqt.inverse(XRef, yRef);
+        auto ws = cqt.makeWorkspace();
+        std::as_const(cqt).forward(x, Xcq, ws);
+        std::as_const(cqt).inverse(Xcq, y, ws);
+        BOOST_CHECK((Xcq == XRef).all());
+        BOOST_CHECK((y == yRef).all());
+    }
+
+    Index               N = 1 << 14;
+    const NsgfCqtSparse cqt(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+    ArrayXXd            x = ArrayXXd::Random(N, nTh);
+    ArrayXXd            y(N, nTh);
+    std::vector<NsgfCqtSparse::Coefs> Xcq(nTh, cqt.getCoefs());
+
+    // Workspaces and signals are allocated up front: Eigen's no-malloc flag
+    // behind RealTimeChecker is process-wide, so a thread allocating while
+    // another is inside a transform would trip it in checked builds.
+    std::vector<NsgfCqtSparse::Workspace> ws;
+    std::vector<ArrayXd>                  xt, yt(nTh, ArrayXd(N));
+    for (int t = 0; t < nTh; t++) {
+        ws.push_back(cqt.makeWorkspace());
+        xt.push_back(x.col(t));
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nTh; t++) {
+        threads.emplace_back([&, t] {
+            for (int rep = 0; rep < 4; rep++) {
+                cqt.forward(xt[t], Xcq[t], ws[t]);
+                cqt.inverse(Xcq[t], yt[t], ws[t]);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int t = 0; t < nTh; t++) y.col(t) = yt[t];
+
+    NsgfCqtSparse ref(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+    for (int t = 0; t < nTh; t++) {
+        ArrayXd xt = x.col(t), yt(N);
+        auto    XRef = ref.getCoefs();
+        ref.forward(xt, XRef);
+        ref.inverse(XRef, yt);
+
+        bool same = true;
+        for (Index k = 0; k < ref.getNumBands(); k++) same &= (Xcq[t][k] == XRef[k]).all();
+        BOOST_CHECK_MESSAGE(same, "forward differs on thread " << t);
+        BOOST_CHECK_MESSAGE((y.col(t) == yt).all(), "inverse differs on thread " << t);
+    }
+}
+
+// Band energies from the spectrum (Parseval) must match the energy of the
+// coefficients forward() computes, band by band, for both transforms and
+// spans.
+BOOST_AUTO_TEST_CASE(CQTTestBandEnergies)
+{
+    double  fs = 48000;
+    Index   N  = 1 << 14;
+    ArrayXd x  = ArrayXd::Random(N);
+
+    auto relErr = [](const ArrayXd& e, const ArrayXd& ref) { return ((e - ref).abs() / ref).maxCoeff(); };
+
+    {
+        NsgfCqtDense cqt(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+        ArrayXXcd    Xcq(N, cqt.getNumBands());
+        ArrayXd      e(cqt.getNumBands());
+        BOOST_REQUIRE(cqt.isValid());
+        cqt.forward(x, Xcq);
+        ArrayXd ref = Xcq.abs2().colwise().sum().transpose();
+        cqt.bandEnergies(x, e);
+        BOOST_CHECK_SMALL(relErr(e, ref), 1e-9);
+
+        auto ws = cqt.makeWorkspace();
+        std::as_const(cqt).bandEnergies(x, e, ws);
+        BOOST_CHECK_SMALL(relErr(e, ref), 1e-9);
+    }
+
+    for (SpanPolicy spans : {SpanPolicy::PowerOfTwo, SpanPolicy::MixedRadix}) {
+        NsgfCqtSparse cqt(fs, N, 1.0 / 12.0, 100, 10000, 1500, spans);
+        auto          Xcq = cqt.getCoefs();
+        ArrayXd       e(cqt.getNumBands()), ref(cqt.getNumBands());
+        if (!cqt.isValid() && spans == SpanPolicy::MixedRadix) {
+            BOOST_CHECK(!DFT::isSupported(12)); // only power-of-two backends: inert by design
+            continue;
+        }
+        BOOST_REQUIRE(cqt.isValid());
+        cqt.forward(x, Xcq);
+        for (Index k = 0; k < cqt.getNumBands(); k++) ref(k) = Xcq[k].abs2().sum();
+        cqt.bandEnergies(x, e);
+        BOOST_CHECK_SMALL(relErr(e, ref), 1e-9);
+    }
+
+    // Invalid configurations are inert.
+    NsgfCqtSparse bad(fs, 64, 1.0 / 12.0, 20, 10000, 1500);
+    ArrayXd       e = ArrayXd::Ones(bad.getNumBands()), x64 = ArrayXd::Random(64);
+    bad.bandEnergies(x64, e);
+    BOOST_CHECK(!bad.isValid() && (e == 0).all());
+}
+
+// forwardMagnitude() writes |forward()| of every band back to back, in
+// either precision and in decibels, serial, on a pool or on a workspace.
+BOOST_AUTO_TEST_CASE(CQTTestMagnitude)
+{
+    double  fs = 48000;
+    Index   N  = 1 << 14;
+    ArrayXd x  = ArrayXd::Random(N);
+
+    NsgfCqtSparse cqt(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+    BOOST_REQUIRE(cqt.isValid());
+    auto Xcq = cqt.getCoefs();
+    cqt.forward(x, Xcq);
+
+    ArrayXd ref(cqt.getNumCoefs());
+    for (Index k = 0; k < cqt.getNumBands(); k++) {
+        BOOST_CHECK_EQUAL(cqt.getCoefOffset(k), k == 0 ? 0 : cqt.getCoefOffset(k - 1) + cqt.getLength(k - 1));
+        ref.segment(cqt.getCoefOffset(k), cqt.getLength(k)) = Xcq[k].abs();
+    }
+    double peak = ref.maxCoeff();
+
+    for (unsigned threads : {1u, 4u}) {
+        cqt.setNumThreads(threads);
+        ArrayXd mag(cqt.getNumCoefs()), dB(cqt.getNumCoefs());
+        ArrayXf magF(cqt.getNumCoefs());
+        cqt.forwardMagnitude(x, mag);
+        cqt.forwardMagnitude(x, magF);
+        cqt.forwardMagnitude(x, dB, MagnitudeScale::Decibels);
+        BOOST_CHECK_SMALL((mag - ref).abs().maxCoeff() / peak, 1e-12);
+        BOOST_CHECK_SMALL((magF.cast<double>() - ref).abs().maxCoeff() / peak, 1e-6);
+        BOOST_CHECK_SMALL((dB - 20 * ref.max(1e-10).log10()).abs().maxCoeff(), 1e-9);
+    }
+
+    const NsgfCqtSparse& shared = cqt;
+    auto                 ws     = shared.makeWorkspace();
+    ArrayXd              mag(cqt.getNumCoefs());
+    ArrayXf              magF(cqt.getNumCoefs());
+    shared.forwardMagnitude(x, mag, MagnitudeScale::Linear, ws);
+    shared.forwardMagnitude(x, magF, MagnitudeScale::Linear, ws);
+    BOOST_CHECK_SMALL((mag - ref).abs().maxCoeff() / peak, 1e-12);
+    BOOST_CHECK_SMALL((magF.cast<double>() - ref).abs().maxCoeff() / peak, 1e-6);
+}
+
+// Shared plans: bands of equal span length, and instances of one
+// configuration, plan each FFT size once (the workspace test above also runs
+// those shared plans from several threads).
+BOOST_AUTO_TEST_CASE(CQTTestSharedPlans)
+{
+    double fs   = 48000;
+    Index  N    = 1 << 14;
+    size_t base = DFT::getNumSharedPlans();
+
+    {
+        NsgfCqtSparse cqt(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+        std::vector<Index> lengths{N};
+        for (const auto& band : cqt.getCoefs()) lengths.push_back(band.size());
+        std::sort(lengths.begin(), lengths.end());
+        size_t nSizes = std::unique(lengths.begin(), lengths.end()) - lengths.begin();
+
+        BOOST_CHECK_EQUAL(DFT::getNumSharedPlans() - base, nSizes);
+        BOOST_CHECK_LT(nSizes, size_t(cqt.getNumBands()));
+
+        NsgfCqtSparse other(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+        BOOST_CHECK_EQUAL(DFT::getNumSharedPlans() - base, nSizes);
+    }
+    BOOST_CHECK_EQUAL(DFT::getNumSharedPlans(), base);
+}
+
+// Shared frames: instances with an identical configuration get the same
+// immutable frame from the process-wide registry, which additionally
+// retains the most recently used frames up to its capacity.
+BOOST_AUTO_TEST_CASE(CQTTestFrameRegistry)
+{
+    double fs = 48000;
+    Index  N  = 1 << 12;
+
+    auto& registry = NsgfCqtSparse::Registry::instance();
+    auto  capacity = registry.getCapacity();
+    registry.clear();
+    registry.setCapacity(1);
+
+    NsgfCqtSparse a(fs, N, 1.0 / 3.0, 100, 10000, 1500);
+    NsgfCqtSparse b(fs, N, 1.0 / 3.0, 100, 10000, 1500);
+    NsgfCqtSparse c(fs, N, 1.0 / 3.0, 200, 10000, 1500);
+    BOOST_CHECK(a.getSharedFrame() == b.getSharedFrame());
+    BOOST_CHECK(a.getSharedFrame() != c.getSharedFrame());
+    BOOST_CHECK(&a.getDiagonalization() == &b.getDiagonalization());
+    BOOST_CHECK(registry.size() == 1);
+
+    // Eviction only drops the registry's reference: a frame still held by
+    // a live instance keeps being shared.
+    NsgfCqtSparse e(fs, N, 1.0 / 3.0, 100, 10000, 1500);
+    BOOST_CHECK(e.getSharedFrame() == a.getSharedFrame());
+
+    // Instances sharing a frame still transform independently.
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y(N);
+    auto    Xa = a.getCoefs();
+    a.forward(x, Xa);
+    b.inverse(Xa, y);
+    BOOST_CHECK_MESSAGE(rms(x - y) < 1e-10, "rms = " << rms(x - y));
+
+    // Retention: the most recent frame outlives its last instance...
+    std::weak_ptr<const NsgfCqtSparse::SharedFrame> retained, dropped;
+    {
+        NsgfCqtSparse tmp(fs, N, 1.0 / 3.0, 400, 10000, 1500);
+        retained = tmp.getSharedFrame();
+    }
+    BOOST_CHECK(!retained.expired());
+
+    // ...and capacity 0 retains nothing.
+    registry.setCapacity(0);
+    BOOST_CHECK(retained.expired());
+    {
+        NsgfCqtSparse tmp(fs, N, 1.0 / 3.0, 400, 10000, 1500);
+        dropped = tmp.getSharedFrame();
+    }
+    BOOST_CHECK(dropped.expired());
+    registry.setCapacity(capacity);
+
+    // Dense frames have their own registry.
+    NsgfCqtDense h1(fs, 1 << 10, 1, 100, 10000, 1500);
+    NsgfCqtDense h2(fs, 1 << 10, 1, 100, 10000, 1500);
+    BOOST_CHECK(h1.getSharedFrame() == h2.getSharedFrame());
+    BOOST_CHECK(&h1.getFrame() == &h2.getFrame());
+}
+
+namespace {
+/// Sparse atoms as the dense design computes them: the full nFreqs x nBands
+/// Gaussian matrix, thresholded, with rows above Nyquist cleared afterwards.
+/// Returns d and fills g (full columns) for comparison with the analytic,
+/// support-only construction.
+ArrayXd denseSparseDesign(const NsgfCqtSparse& cqt, ArrayXXd& g)
+{
+    Index   N   = cqt.getNumFreqs();
+    ArrayXd fax = ArrayXd::LinSpaced(N, 0, N - 1) * cqt.getSampleRate() / double(N);
+    ArrayXd bax = cqt.getBandAxis();
+
+    ArrayXXd outerDif = fax.log2().rowwise().replicate(bax.size()) -
+                        bax.log2().transpose().colwise().replicate(fax.size());
+
+    double c   = log(4) / (square(cqt.getFraction()));
+    Index  end = bax.size() - 1;
+    g          = (-c * outerDif.square()).exp();
+    g.col(0)   = (fax < bax(0)).select(1, g.col(0));
+    g.col(end) = (fax > bax(end)).select(1, g.col(end));
+    g          = (g <= 1e-6).select(0.0, g);
+
+    ArrayXd d = g.square().rowwise().sum();
+    g.bottomRows(N / 2 - 1).fill(0);
+    return d;
+}
+} // namespace
+
+// The sparse frame is designed band by band on each atom's analytic support,
+// never as a dense matrix, and must match the dense design bit for bit (d,
+// spans, atoms, duals) — frames, cache files and results stay unchanged.
+BOOST_AUTO_TEST_CASE(CQTTestSparseDesign)
+{
+    struct Config {
+        double fs;
+        Index  N;
+        double frac, fMin, fMax, fRef;
+    };
+    for (Config p : {Config{48000, 1 << 12, 1.0 / 3.0, 100, 10000, 1500},
+                     Config{44100, 1 << 14, 1.0 / 12.0, 50, 20000, 440},
+                     Config{48000, 1 << 16, 1.0 / 48.0, 30, 16000, 1000},
+                     Config{48000, 1 << 10, 1, 100, 10000, 1500},
+                     Config{48000, 1 << 10, 1, 300, 400, 350}}) {
+        NsgfCqtSparse cqt(p.fs, p.N, p.frac, p.fMin, p.fMax, p.fRef);
+        ArrayXXd      g;
+        ArrayXd       d = denseSparseDesign(cqt, g);
+        auto          f = cqt.getSharedFrame();
+
+        BOOST_REQUIRE(cqt.isValid() && f->ok);
+        bool same = (f->d == d).all();
+        for (Index k = 0; k < cqt.getNumBands(); k++) {
+            auto    s = f->idx[k];
+            ArrayXd gk = g.col(k).segment(s.i0, s.len);
+            same &= (f->g[k] == gk).all();
+            same &= (f->gDual[k] == gk / d.segment(s.i0, s.len)).all();
+            same &= s.i0 == 0 || g(s.i0 - 1, k) == 0;
+        }
+        BOOST_CHECK_MESSAGE(same, "fs = " << p.fs << ", N = " << p.N << ", frac = " << p.frac);
+    }
+}
+
+// Mixed-radix spans: each band's FFT length is the smallest even 5-smooth
+// size, whatever the backends, never longer than the power-of-two span, and
+// the round trip stays at numerical precision.
+BOOST_AUTO_TEST_CASE(CQTTestMixedRadix)
+{
+    double fs = 48000;
+    Index  N  = 1 << 16;
+
+    NsgfCqtSparse pow2(fs, N, 1.0 / 12.0, 100, 10000, 1500);
+    NsgfCqtSparse mixed(fs, N, 1.0 / 12.0, 100, 10000, 1500, SpanPolicy::MixedRadix);
+    BOOST_REQUIRE(pow2.isValid() && mixed.getSharedFrame()->ok);
+    BOOST_CHECK(!(pow2.getFrameKey() == mixed.getFrameKey())); // distinct frames
+
+    Index total2 = 0, totalM = 0;
+    bool  plannable = true;
+    for (Index k = 0; k < mixed.getNumBands(); k++) {
+        auto   s = mixed.getBandSpan(k);
+        size_t n = size_t(s.len);
+        BOOST_CHECK(s.i0 == pow2.getBandSpan(k).i0);
+        BOOST_CHECK(s.len <= pow2.getLength(k) && n % 2 == 0);
+        BOOST_CHECK(nextSmooth(n, 2) == n);
+        plannable &= DFT::isSupported(n);
+        total2 += pow2.getLength(k);
+        totalM += s.len;
+    }
+    BOOST_CHECK(totalM < total2);
+    // Builds with only power-of-two backends (vDSP, native) plan none of the
+    // mixed lengths, and the transform is inert rather than misrouted.
+    BOOST_CHECK_EQUAL(mixed.isValid(), plannable);
+    if (!plannable) return;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y(N);
+    auto    X = mixed.getCoefs();
+    mixed.forward(x, X);
+    mixed.inverse(X, y);
+    BOOST_CHECK_MESSAGE(rms(x - y) < 1e-10, "rms = " << rms(x - y));
+}
+
+// On-disk frame cache: with a cache directory set, the first construction
+// writes the frame file and later ones (on a registry miss) load it. A file
+// is only trusted when it matches the configuration exactly.
+BOOST_AUTO_TEST_CASE(CQTTestFrameCache)
+{
+    namespace fs = std::filesystem;
+
+    double sr = 48000;
+    Index  N  = 1 << 12;
+    auto   make = [&] { return NsgfCqtSparse(sr, N, 1.0 / 3.0, 100, 10000, 1500); };
+
+    auto& registry = NsgfCqtSparse::Registry::instance();
+    auto  capacity = registry.getCapacity();
+    registry.clear();
+    registry.setCapacity(0); // every construction below misses the registry
+
+    fs::path dir = fs::temp_directory_path() / ("cicuetea-cache-" + std::to_string(std::rand()));
+    FrameCache::setDirectory(dir.string());
+    std::string path = FrameCache::pathFor(make().getFrameKey(), "sparse64");
+
+    { make(); } // cold: designs the frame and writes the file
+    BOOST_REQUIRE(fs::exists(path));
+
+    FrameCache::setDirectory("");
+    auto ref = std::make_shared<NsgfCqtSparse::SharedFrame>(*make().getSharedFrame()); // untracked copy
+    FrameCache::setDirectory(dir.string());
+
+    // Cached: identical frame, identical round trip.
+    {
+        auto cached = make();
+        auto f      = cached.getSharedFrame();
+        BOOST_CHECK(f->ok && (f->d == ref->d).all());
+        bool same = (f->scale == ref->scale).all();
+        for (Index k = 0; k < cached.getNumBands(); k++) {
+            same &= f->idx[k].i0 == ref->idx[k].i0 && f->idx[k].len == ref->idx[k].len;
+            same &= (f->g[k] == ref->g[k]).all() && (f->gDual[k] == ref->gDual[k]).all();
+            same &= (f->phase[k] == ref->phase[k]).all();
+        }
+        BOOST_CHECK(same);
+
+        ArrayXd x = ArrayXd::Random(N);
+        ArrayXd y(N);
+        auto    X = cached.getCoefs();
+        cached.forward(x, X);
+        cached.inverse(X, y);
+        BOOST_CHECK_MESSAGE(rms(x - y) < 1e-10, "rms = " << rms(x - y));
+    }
+
+    // The loader really reads the file: a patched value (the last phase
+    // coefficient, the file's final 16 bytes) shows up in the frame.
+    std::complex<double> marker(0.25, -0.5);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-std::streamoff(sizeof(marker)), std::ios::end);
+        file.write(reinterpret_cast<const char*>(&marker), sizeof(marker));
+    }
+    {
+        auto patched = make();
+        BOOST_CHECK(patched.getPhaseCoefs().back().tail(1)(0) == marker);
+    }
+
+    // A file for another configuration, or a truncated one, is ignored and
+    // rewritten with the right frame.
+    NsgfCqtSparse(sr, N, 1.0 / 3.0, 200, 10000, 1500).saveFrame(path);
+    BOOST_CHECK((make().getSharedFrame()->d == ref->d).all());
+    fs::resize_file(path, fs::file_size(path) / 2);
+    BOOST_CHECK((make().getSharedFrame()->phase.back() == ref->phase.back()).all());
+    BOOST_CHECK((make().getSharedFrame()->phase.back() == ref->phase.back()).all()); // rewritten file
+
+    FrameCache::setDirectory("");
+    registry.setCapacity(capacity);
+    fs::remove_all(dir);
+}
+
 // Construction contract: an invalid configuration must never crash or throw —
 // it constructs an inert object that reports !isValid() and outputs silence.
 // This supports host lifecycles (DAWs) that construct with a placeholder
@@ -187,6 +699,7 @@ BOOST_AUTO_TEST_CASE(CQTTestValidity)
     BOOST_CHECK(Xcq.abs().maxCoeff() == 0);
     bad.inverse(Xcq, y);
     BOOST_CHECK(y.abs().maxCoeff() == 0);
+    bad.reserveChannels(2); // no frame to size scratch for
 
     // Inert sparse transform.
     NsgfCqtSparse badSparse(0, N, 1, 100, 10000, 1500);
@@ -195,6 +708,7 @@ BOOST_AUTO_TEST_CASE(CQTTestValidity)
     badSparse.forward(x, coefs);
     badSparse.inverse(coefs, y);
     BOOST_CHECK(y.abs().maxCoeff() == 0);
+    badSparse.reserveChannels(2);
 
     // Inert processors: silence out, no crash, for all four variants.
     CqtDense     p1(0, N, 1, 100, 10000, 1500);
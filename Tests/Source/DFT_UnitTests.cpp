@@ -10,8 +10,12 @@
 //  every layer above depends on.
 //
 
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 #include <complex>
+#include <filesystem>
+#include <numbers>
+#include <random>
 
 #include <Eigen/Core>
 
@@ -73,3 +77,248 @@ BOOST_AUTO_TEST_CASE(DFTTest4)
 
     BOOST_CHECK(Y[0] == complex<double>(1));
 }
+
+BOOST_AUTO_TEST_CASE(DFTTest5)
+{
+    // The matrix overloads (batched where the backend allows) must match the
+    // single-column transforms, in place and out of place.
+    size_t                      fftSize = FFT_SIZE;
+    Index                       n = Index(fftSize), cols = 5;
+    DFT                         dft(fftSize);
+    mt19937                     gen(3);
+    normal_distribution<double> dist;
+
+    ArrayXXd  x = ArrayXXd::NullaryExpr(n, cols, [&]() { return dist(gen); });
+    ArrayXXcd X = ArrayXXcd::NullaryExpr(n, cols, [&]() { return complex<double>(dist(gen), dist(gen)); });
+    ArrayXXcd Y(n, cols), Z(n, cols), R(n, cols);
+    ArrayXXd  y(n, cols);
+    ArrayXcd  col(n), ref(n);
+    ArrayXd   rcol(n);
+
+    auto checkColumns = [&](const auto& M, auto single) {
+        double err = 0;
+        for (Index c = 0; c < cols; c++) err = max(err, single(c, M.col(c)));
+        BOOST_CHECK_SMALL(err, 1e-12);
+    };
+
+    dft.dft(X, Y);
+    checkColumns(Y, [&](Index c, const auto& m) { col = X.col(c); dft.dft(col, ref); return (m - ref).abs().maxCoeff(); });
+
+    dft.idft(X, Z);
+    checkColumns(Z, [&](Index c, const auto& m) { col = X.col(c); dft.idft(col, ref); return (m - ref).abs().maxCoeff(); });
+
+    Y = X;
+    dft.dft(Y, Y);
+    dft.idft(Y, Y);
+    BOOST_CHECK_SMALL((Y - X).abs().maxCoeff(), 1e-12);
+
+    dft.rdft(x, R);
+    Index h = n / 2 + 1;
+    checkColumns(R, [&](Index c, const auto& m) {
+        rcol = x.col(c);
+        dft.rdft(rcol, ref);
+        return (m.head(h) - ref.head(h)).abs().maxCoeff();
+    });
+
+    dft.irdft(R, y);
+    BOOST_CHECK_SMALL((y - x).abs().maxCoeff(), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(DFTTest6)
+{
+    // Measured planning picks a different algorithm, not a different result;
+    // wisdom round-trips through a file where the backend keeps any.
+    size_t   fftSize = FFT_SIZE;
+    ArrayXcd X = ArrayXcd::LinSpaced(fftSize, 0, 1);
+    ArrayXcd Y(fftSize), Z(fftSize);
+
+    DFT estimated(fftSize);
+    DFT::setPlanRigor(PlanRigor::Measure);
+    BOOST_CHECK(DFT::getPlanRigor() == PlanRigor::Measure);
+    BOOST_CHECK(DFTF::getPlanRigor() == PlanRigor::Estimate);
+    DFT measured(fftSize);
+    DFT::setPlanRigor(PlanRigor::Estimate);
+
+    estimated.dft(X, Y);
+    measured.dft(X, Z);
+    BOOST_CHECK_SMALL((Y - Z).abs().maxCoeff(), 1e-12);
+
+    auto path      = (filesystem::temp_directory_path() / "cicuetea-dfttest6.wisdom").string();
+    auto backends  = DFT::getBackends();
+    bool hasWisdom = find(backends.begin(), backends.end(), DFTBackend::FFTW) != backends.end();
+    BOOST_CHECK(DFT::saveWisdom(path) == hasWisdom);
+    BOOST_CHECK(DFT::loadWisdom(path) == hasWisdom);
+    filesystem::remove(path);
+    BOOST_CHECK(!DFT::loadWisdom(path));
+}
+
+namespace {
+/// Largest error of all four transforms of a size against a direct O(n²)
+/// DFT, relative to the spectrum's peak (the round trip for large sizes).
+template <typename T>
+double directError(Index n)
+{
+    using C = complex<T>;
+    using A = Array<C, Dynamic, 1>;
+    using R = Array<T, Dynamic, 1>;
+
+    BasicDFT<T>            dft{size_t(n)};
+    mt19937                gen{unsigned(n)};
+    normal_distribution<T> dist;
+
+    A x = A::NullaryExpr(n, [&]() { return C(dist(gen), dist(gen)); });
+    R r = x.real();
+    A X(n), Xr(n), xc(n);
+    R y(n);
+
+    dft.dft(x, X);
+    dft.idft(X, xc);
+    dft.rdft(r, Xr);
+    dft.irdft(Xr, y);
+    double err = max((xc - x).abs().maxCoeff(), (y - r).abs().maxCoeff());
+
+    if (n <= 1024) {
+        A ref = A::Zero(n), refR = A::Zero(n);
+        for (Index k = 0; k < n; k++)
+            for (Index t = 0; t < n; t++) {
+                complex<double> w = polar(1.0, -2 * numbers::pi * double((k * t) % n) / double(n));
+                ref[k] += C(w) * x[t];
+                refR[k] += C(w) * r[t];
+            }
+        double peak = ref.abs().maxCoeff();
+        err         = max(err, (X - ref).abs().maxCoeff() / peak);
+        err         = max(err, (Xr.head(n / 2 + 1) - refR.head(n / 2 + 1)).abs().maxCoeff() / peak);
+    }
+    return err;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(DFTTest7)
+{
+    // Every power of two the library uses (band spans up to full blocks),
+    // both precisions, against a direct DFT.
+    for (Index n = 2; n <= (1 << 16); n *= 2) {
+        BOOST_CHECK_MESSAGE(directError<double>(n) < 1e-12, "double, n = " << n);
+        BOOST_CHECK_MESSAGE(directError<float>(n) < 1e-4, "float, n = " << n);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DFTTest8)
+{
+    // The codelets against the backend they bypass, 1-D and in place on
+    // matrices (as the sparse band loops call them).
+    size_t limit = DFT::getMaxCodeletSize();
+    BOOST_CHECK_EQUAL(limit, 64);
+
+    for (Index n = 2; n <= 128; n *= 2) {
+        DFT::setMaxCodeletSize(0);
+        DFT backend{size_t(n)};
+        DFT::setMaxCodeletSize(limit);
+        DFT codelet{size_t(n)};
+
+        ArrayXcd  x = ArrayXcd::Random(n);
+        ArrayXcd  X(n), Y(n), xb(n), xc(n);
+        ArrayXXcd M = ArrayXXcd::Random(n, 3), B = M;
+
+        backend.dft(x, X);
+        codelet.dft(x, Y);
+        BOOST_CHECK_MESSAGE((X - Y).abs().maxCoeff() < 1e-12, "dft, n = " << n);
+        backend.idft(X, xb);
+        codelet.idft(X, xc);
+        BOOST_CHECK_MESSAGE((xb - xc).abs().maxCoeff() < 1e-14, "idft, n = " << n);
+
+        backend.dft(M, M);
+        codelet.dft(B, B);
+        BOOST_CHECK_MESSAGE((M - B).abs().maxCoeff() < 1e-12, "matrix dft, n = " << n);
+        backend.idft(M, M);
+        codelet.idft(B, B);
+        BOOST_CHECK_MESSAGE((M - B).abs().maxCoeff() < 1e-14, "matrix idft, n = " << n);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DFTTest9)
+{
+    // Every compiled-in backend agrees with the default one, and tuned
+    // routes survive a save/load round trip.
+    auto backends = DFT::getBackends();
+    BOOST_REQUIRE(!backends.empty());
+    BOOST_CHECK(DFT::getDefaultBackend() == backends.front());
+    BOOST_CHECK(DFT::getName() == DFT::getName(backends.front()));
+
+    // 32 runs through the codelets by default, so the pinned DFTs check
+    // each backend against them.
+    for (Index n : {32, 128, 1024}) {
+        DFT      reference{size_t(n)};
+        ArrayXcd x = ArrayXcd::Random(n), X(n), Y(n);
+        ArrayXd  r = ArrayXd::Random(n), y(n);
+        reference.dft(x, X);
+        for (DFTBackend backend : backends) {
+            DFT dft{size_t(n), backend};
+            BOOST_CHECK(dft.getBackend() == backend);
+            BOOST_CHECK(!DFT::getName(backend).empty());
+            dft.dft(x, Y);
+            BOOST_CHECK_MESSAGE((X - Y).abs().maxCoeff() < 1e-10, DFT::getName(backend) << ", n = " << n);
+            dft.rdft(r, Y);
+            dft.irdft(Y, y);
+            BOOST_CHECK_SMALL((y - r).abs().maxCoeff(), 1e-12);
+        }
+    }
+
+    auto path = (filesystem::temp_directory_path() / "cicuetea-dfttest9.tuning").string();
+    DFT::tune({256});
+    DFTBackend tuned = DFT{256}.getBackend();
+    BOOST_CHECK(find(backends.begin(), backends.end(), tuned) != backends.end());
+    BOOST_CHECK(DFT::saveTuning(path));
+    BOOST_CHECK(!DFTF::loadTuning(path)); // written for double
+
+    DFT::clearTuning();
+    BOOST_CHECK(DFT::loadTuning(path));
+    BOOST_CHECK(DFT{256}.getBackend() == tuned);
+    DFT::clearTuning();
+    filesystem::remove(path);
+    BOOST_CHECK(!DFT::loadTuning(path));
+
+    BOOST_CHECK(DFT::getAutoTune() == false);
+
+    // A backend is never pinned to a size it cannot plan: the DFT is routed
+    // to one that can (e.g. 80 points with a power-of-two-only backend).
+    BOOST_CHECK(DFT::isSupported(256));
+    BOOST_CHECK(!DFT::isSupported(257)); // prime: no backend plans it
+    if (DFT::isSupported(80)) {
+        ArrayXcd x = ArrayXcd::Random(80), X(80), Y(80);
+        DFT{80}.dft(x, X);
+        for (DFTBackend backend : backends) {
+            DFT dft{80, backend};
+            dft.dft(x, Y);
+            BOOST_CHECK_MESSAGE((X - Y).abs().maxCoeff() < 1e-10, DFT::getName(backend) << " pinned, n = 80");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DFTTest10)
+{
+    // In-place dft/idft (the sparse band transforms run that way) match
+    // the out-of-place ones on every compiled-in backend, above the codelet
+    // sizes so the backend itself runs.
+    for (Index n : {128, 256, 2048}) {
+        ArrayXcd x = ArrayXcd::Random(n), X(n), Y(n);
+        ArrayXcf xf = x.cast<complex<float>>(), Xf(n), Yf(n);
+        for (DFTBackend backend : DFT::getBackends()) {
+            DFT dft{size_t(n), backend};
+            dft.dft(x, X);
+            Y = x;
+            dft.dft(Y, Y);
+            BOOST_CHECK_MESSAGE((X - Y).abs().maxCoeff() < 1e-10, DFT::getName(backend) << " dft, n = " << n);
+            dft.idft(Y, Y);
+            BOOST_CHECK_MESSAGE((x - Y).abs().maxCoeff() < 1e-12, DFT::getName(backend) << " idft, n = " << n);
+
+            DFTF dftf{size_t(n), backend};
+            dftf.dft(xf, Xf);
+            Yf = xf;
+            dftf.dft(Yf, Yf);
+            BOOST_CHECK_MESSAGE((Xf - Yf).abs().maxCoeff() < 1e-3f, DFT::getName(backend) << " dft (float), n = " << n);
+            dftf.idft(Yf, Yf);
+            BOOST_CHECK_MESSAGE((xf - Yf).abs().maxCoeff() < 1e-5f, DFT::getName(backend) << " idft (float), n = " << n);
+        }
+    }
+}
@@ -43,3 +43,70 @@ class SliCqtSparse : public jsa::cicuetea::SlidingCqtSparseProcessor
     using jsa::cicuetea::SlidingCqtSparseProcessor::SlidingCqtSparseProcessor;
     void processBlock(jsa::cicuetea::NsgfCqtSparse::Coefs& /*block*/) override {};
 };
+
+// Single-precision counterparts of the identity doubles above.
+
+class CqtDenseF : public jsa::cicuetea::CqtDenseProcessorF
+{
+  public:
+    using jsa::cicuetea::CqtDenseProcessorF::CqtDenseProcessorF;
+    void processBlock(Eigen::ArrayXXcf& /*block*/) override {}
+};
+
+class SliCqtDenseF : public jsa::cicuetea::SlidingCqtDenseProcessorF
+{
+  public:
+    using jsa::cicuetea::SlidingCqtDenseProcessorF::SlidingCqtDenseProcessorF;
+    void processBlock(Eigen::ArrayXXcf& /*block*/) override {};
+};
+
+class CqtSparseF : public jsa::cicuetea::CqtSparseProcessorF
+{
+  public:
+    using jsa::cicuetea::CqtSparseProcessorF::CqtSparseProcessorF;
+    void processBlock(jsa::cicuetea::NsgfCqtSparseF::Coefs& /*block*/) override {}
+};
+
+class SliCqtSparseF : public jsa::cicuetea::SlidingCqtSparseProcessorF
+{
+  public:
+    using jsa::cicuetea::SlidingCqtSparseProcessorF::SlidingCqtSparseProcessorF;
+    void processBlock(jsa::cicuetea::NsgfCqtSparseF::Coefs& /*block*/) override {};
+};
+
+class MultirateCqt : public jsa::cicuetea::MultirateCqtProcessor
+{
+  public:
+    using jsa::cicuetea::MultirateCqtProcessor::MultirateCqtProcessor;
+    void processBlock(Eigen::Index /*octave*/, jsa::cicuetea::NsgfCqtSparse::Coefs& /*block*/) override {}
+};
+
+// Multi-channel identity doubles (double precision).
+
+class MultiCqtDense : public jsa::cicuetea::MultiChannelCqtDenseProcessor
+{
+  public:
+    using jsa::cicuetea::MultiChannelCqtDenseProcessor::MultiChannelCqtDenseProcessor;
+    void processBlock(MultiCoefs& /*block*/) override {}
+};
+
+class MultiSliCqtDense : public jsa::cicuetea::MultiChannelSlidingCqtDenseProcessor
+{
+  public:
+    using jsa::cicuetea::MultiChannelSlidingCqtDenseProcessor::MultiChannelSlidingCqtDenseProcessor;
+    void processBlock(MultiCoefs& /*block*/) override {}
+};
+
+class MultiCqtSparse : public jsa::cicuetea::MultiChannelCqtSparseProcessor
+{
+  public:
+    using jsa::cicuetea::MultiChannelCqtSparseProcessor::MultiChannelCqtSparseProcessor;
+    void processBlock(MultiCoefs& /*block*/) override {}
+};
+
+class MultiSliCqtSparse : public jsa::cicuetea::MultiChannelSlidingCqtSparseProcessor
+{
+  public:
+    using jsa::cicuetea::MultiChannelSlidingCqtSparseProcessor::MultiChannelSlidingCqtSparseProcessor;
+    void processBlock(MultiCoefs& /*block*/) override {}
+};
@@ -5,16 +5,20 @@
 //  Created by Juan Sierra on 8/28/25.
 //
 //  Benchmarks (CTest label "bench", no correctness assertions): raw timing
-//  of the selected FFT backend — rdft across sizes 2^2..2^17, then all four
-//  transform directions at 2^16. Correctness of the wrapper is covered by
+//  of the default FFT backend — rdft across sizes 2^2..2^17, then all four
+//  transform directions at 2^16 — and, in FFTLibTest3, every compiled-in
+//  backend side by side with the route the autotuner picks per size.
+//  Correctness of the wrapper is covered by
 //  DFT_UnitTests.cpp; this file exists to compare backends and spot
 //  performance regressions by eye.
 //
 
 #include <FFT.hpp>
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 
 #include <Eigen/Core>
+#include <iostream>
 
 #include "Benchtools.h"
 
@@ -88,3 +92,35 @@ BOOST_AUTO_TEST_CASE(FFTLibTest2)
 
     BOOST_CHECK(true);
 }
+
+BOOST_AUTO_TEST_CASE(FFTLibTest3)
+{
+    // One dft + idft + rdft + irdft set per backend and size, then the tuner.
+    auto backends = DFT::getBackends();
+    for (int j = 4; j < 18; j += 2) {
+        Index N = 1 << j;
+        std::cout << "FFT Size: " << N;
+
+        ArrayXcd X     = ArrayXcd::Random(N), Y(N);
+        ArrayXd  x     = ArrayXd::Random(N);
+        int      nReps = std::max(4, int((1 << 20) / N));
+        for (DFTBackend backend : backends) {
+            DFT dft{size_t(N), backend};
+            if (dft.getBackend() != backend) continue; // backend does not plan N
+            Timer t(false);
+            for (int i = 0; i < nReps; i++) {
+                dft.dft(X, Y);
+                dft.idft(Y, X);
+                dft.rdft(x, Y);
+                dft.irdft(Y, x);
+            }
+            std::cout << ", " << DFT::getName(backend) << " " << 1000 * t.get() / nReps << " us";
+        }
+
+        DFT::tune({size_t(N)});
+        std::cout << " -> " << DFT::getName(DFT{size_t(N)}.getBackend()) << std::endl;
+    }
+    DFT::clearTuning();
+
+    BOOST_CHECK(true);
+}
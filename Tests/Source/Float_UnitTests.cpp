@@ -0,0 +1,161 @@
+//
+//  Float_UnitTests.cpp
+//  CQTDSP_UnitTest
+//
+//  Created by Juan Sierra on 6/20/25.
+//
+//  Single-precision instantiation of the whole stack (DFTF, NsgfCqt*F,
+//  *ProcessorF). The frame is designed in double and cast once, so the only
+//  error source is float arithmetic on the processing path: round trips land
+//  near float epsilon instead of double's 1e-16. Each test states the error
+//  it measured; the bounds leave roughly an order of magnitude of headroom.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <complex>
+#include <numbers>
+
+#include <Eigen/Core>
+
+#include <CQT.hpp>
+#include <FFT.hpp>
+#include <MathUtils.h>
+
+#include "EmptyCQTProc.h"
+#include "TestSignals.h"
+
+using namespace Eigen;
+using namespace std;
+using namespace jsa::cicuetea;
+using namespace jsa::cicuetea::test;
+
+namespace {
+/// rms() over a float signal, accumulated in double.
+double rmsF(const ArrayXf& x)
+{
+    return rms(x.cast<double>());
+}
+} // namespace
+
+// DFTF scaling conventions match DFT: DC bin = N on ones, irdft scales by 1/N.
+BOOST_AUTO_TEST_CASE(DFTTestFloat1)
+{
+    size_t   fftSize = 32;
+    DFTF     dft(fftSize);
+    ArrayXf  x = ArrayXf::Ones(fftSize);
+    ArrayXcf X(fftSize / 2 + 1);
+    ArrayXf  y = ArrayXf::Zero(fftSize);
+    dft.rdft(x, X);
+    dft.irdft(X, y);
+
+    BOOST_CHECK(X[0] == complex<float>(float(fftSize)));
+    BOOST_CHECK(y[0] == 1.0f);
+}
+
+// DFTF complex round trip on noise (measured ≈ 1.4e-7).
+BOOST_AUTO_TEST_CASE(DFTTestFloat2)
+{
+    size_t   fftSize = 1 << 10;
+    DFTF     dft(fftSize);
+    ArrayXcf x = ArrayXcf::Random(fftSize);
+    ArrayXcf X(fftSize);
+    ArrayXcf y(fftSize);
+    dft.dft(x, X);
+    dft.idft(X, y);
+
+    double err = std::sqrt((x - y).abs2().cast<double>().mean());
+    BOOST_CHECK_MESSAGE(err < 1e-6, "rms = " << err);
+}
+
+// Dense float round trip (measured ≈ 4e-8; the double path gives ≈ 3e-16).
+BOOST_AUTO_TEST_CASE(CQTTestFloatDense)
+{
+    double fs     = 48000;
+    size_t nSamps = 1 << 10;
+    double fRef   = 1500;
+
+    NsgfCqtDenseF cqt(fs, nSamps, 1, 100, 10000, fRef);
+    ArrayXd       t = regspace(int(nSamps)) / fs;
+    ArrayXf       x = (2 * std::numbers::pi * fRef * t).sin().cast<float>();
+    ArrayXf       y(nSamps);
+    ArrayXXcf     Xcq(cqt.getNumSamps(), cqt.getNumBands());
+
+    BOOST_REQUIRE(cqt.isValid());
+    cqt.forward(x, Xcq);
+    cqt.inverse(Xcq, y);
+
+    BOOST_CHECK_MESSAGE(rmsF(x - y) < 1e-6, "rms = " << rmsF(x - y));
+}
+
+// Sparse float round trip at coarse and fine resolution (measured ≈ 1e-7).
+BOOST_AUTO_TEST_CASE(CQTTestFloatSparse)
+{
+    double fs     = 48000;
+    int    nSamps = 1 << 16;
+    double fRef   = 1500;
+
+    for (double frac : {1.0, 1.0 / 12.0}) {
+        NsgfCqtSparseF cqt(fs, nSamps, frac, 100, 10000, fRef);
+
+        ArrayXd t = regspace(int(nSamps)) / fs;
+        ArrayXf x = (2 * std::numbers::pi * fRef * t + std::numbers::pi / 8)
+                        .sin()
+                        .cast<float>();
+        ArrayXf y(nSamps);
+        auto    Xcq = cqt.getCoefs();
+
+        BOOST_REQUIRE(cqt.isValid());
+        cqt.forward(x, Xcq);
+        cqt.inverse(Xcq, y);
+
+        BOOST_CHECK_MESSAGE(rmsF(x - y) < 1e-6,
+                            "frac = " << frac << ", rms = " << rmsF(x - y));
+    }
+}
+
+// Float block processors reconstruct their input delayed by getLatency()
+// (measured ≈ 1.1e-7 for both).
+BOOST_AUTO_TEST_CASE(OlaProcFloat1)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 16;
+    Index  blockSize = 1 << 10;
+
+    ArrayXf    x  = ArrayXf::Random(N);
+    ArrayXf    yd = ArrayXf::Zero(N);
+    ArrayXf    ys = ArrayXf::Zero(N);
+    CqtDenseF  dense(fs, blockSize, 1, 1e2, 1e4, 1e3);
+    CqtSparseF sparse(fs, blockSize, 1, 1e2, 1e4, 1e3);
+
+    for (Index n = 0; n < N; n++) {
+        yd(n) = dense.processSample(x(n));
+        ys(n) = sparse.processSample(x(n));
+    }
+
+    Index   latency = dense.getLatency();
+    ArrayXf dd      = x.head(N - latency) - yd.tail(N - latency);
+    ArrayXf ds      = x.head(N - latency) - ys.tail(N - latency);
+    BOOST_CHECK_MESSAGE(rmsF(dd) < 1e-6, "dense rms = " << rmsF(dd));
+    BOOST_CHECK_MESSAGE(rmsF(ds) < 1e-6, "sparse rms = " << rmsF(ds));
+}
+
+// Float sliding processor: dominated by the sliCQ overlap error, not by
+// precision (measured ≈ 5e-4), so it keeps the double tests' 1e-3 bound.
+BOOST_AUTO_TEST_CASE(OlaProcFloat2)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 18;
+    Index  blockSize = 1 << 16;
+
+    ArrayXf       x  = ArrayXf::Random(N);
+    ArrayXf       y  = ArrayXf::Zero(N);
+    SliCqtSparseF ola(fs, blockSize, 1.0 / 3.0, 1e2, 1e4, 1e3);
+
+    for (Index n = 0; n < N; n++) {
+        y(n) = ola.processSample(x(n));
+    }
+
+    Index   latency = ola.getLatency();
+    ArrayXf d       = x.head(N - latency) - y.tail(N - latency);
+    BOOST_CHECK_MESSAGE(rmsF(d) < 1e-3, "rms = " << rmsF(d));
+}
@@ -100,6 +100,37 @@ BOOST_AUTO_TEST_CASE(Slicing2)
     BOOST_CHECK(rms(d) < 1e-6);
 }
 
+// Slicing2 at overlap factors 2, 4 and 8 with wolaWindow(): the squared
+// window's shifts by the hop sum to one, so the chain is still a delay of
+// one block.
+BOOST_AUTO_TEST_CASE(Slicing3)
+{
+    Index   blockSize = 1 << 10;
+    Index   N         = 1 << 14;
+    ArrayXd x         = ArrayXd::Random(N);
+
+    for (Index R : {2, 4, 8}) {
+        Index   hopSize = blockSize / R;
+        Slicer  slicer(blockSize, hopSize);
+        Splicer splicer(blockSize, hopSize);
+        ArrayXd window = wolaWindow(blockSize, R);
+        ArrayXd y(N);
+
+        for (Index n = 0; n < N; n++) {
+            slicer.pushSample(x(n));
+            y(n) = splicer.getSample();
+            if (slicer.hasBlock()) {
+                ArrayXd block = slicer.getBlock();
+                block *= window.square();
+                splicer.pushBlock(block);
+            }
+        }
+
+        ArrayXd d = x.head(N - blockSize) - y.tail(N - blockSize);
+        BOOST_CHECK_MESSAGE(rms(d) < 1e-12, "R = " << R << ": rms = " << rms(d));
+    }
+}
+
 // Full sliced chain: Slicer → CQT forward → inverse → Splicer, with a Hann
 // analysis window absorbed into the slice. The identity manipulation must
 // reconstruct the stream (delayed by one block).
@@ -11,10 +11,18 @@
 //  round trip and the latency report at the same time.
 //
 
+#include <algorithm>
+#include <atomic>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <thread>
 
 #include <Eigen/Core>
 
+#include <MathUtils.h>
+
 #include "EmptyCQTProc.h"
 #include "TestSignals.h"
 
@@ -23,6 +31,94 @@ using namespace std;
 using namespace jsa::cicuetea;
 using namespace jsa::cicuetea::test;
 
+namespace {
+/// Accumulates each octave's coefficient energy per band.
+class MultirateEnergy : public MultirateCqtProcessor
+{
+  public:
+    using MultirateCqtProcessor::MultirateCqtProcessor;
+
+    void processBlock(Index octave, NsgfCqtSparse::Coefs& block) override
+    {
+        if (energy.size() == 0) energy = ArrayXXd::Zero(getNumOctaves(), getCqt().getNumBands());
+        if (blocks.empty()) blocks.resize(size_t(getNumOctaves()));
+        for (size_t k = 0; k < block.size(); k++) energy(octave, Index(k)) += block[k].abs2().sum();
+        blocks[size_t(octave)]++;
+    }
+
+    ArrayXXd         energy; ///< Octaves x bands.
+    vector<uint64_t> blocks; ///< Blocks received per octave.
+};
+
+/// Swaps channels 0 and 1 in the coefficient domain.
+class SwapChannels : public MultiChannelCqtSparseProcessor
+{
+  public:
+    using MultiChannelCqtSparseProcessor::MultiChannelCqtSparseProcessor;
+
+    void processBlock(MultiCoefs& block) override { std::swap(block[0], block[1]); }
+};
+
+/// Halves bands 2 and 5 (dense).
+class TwoBandsDense : public CqtDenseProcessor
+{
+  public:
+    using CqtDenseProcessor::CqtDenseProcessor;
+
+    void processBlock(ArrayXXcd& block) override
+    {
+        block.col(2) *= 0.5;
+        block.col(5) *= 0.5;
+    }
+};
+
+/// Halves bands 2 and 5 (sparse).
+class TwoBandsSparse : public CqtSparseProcessor
+{
+  public:
+    using CqtSparseProcessor::CqtSparseProcessor;
+
+    void processBlock(NsgfCqtSparse::Coefs& block) override
+    {
+        block[2] *= 0.5;
+        block[5] *= 0.5;
+    }
+};
+
+/// Keeps a copy of every block processBlock() receives (Block is the
+/// parameter type: a reference for processors, a const one for analyzers).
+template <typename Base, typename Block>
+class Recorder : public Base
+{
+  public:
+    using Base::Base;
+
+    void processBlock(Block block) override { blocks.push_back(block); }
+
+    vector<std::decay_t<Block>> blocks;
+};
+
+/// Identity sparse processor whose worker, at its 8th hop, sleeps until the
+/// host has streamed `stall` more samples (counted in `*host`), so the stall
+/// overruns the extra latency however fast the machine is.
+class Stalling : public CqtSparseProcessor
+{
+  public:
+    using CqtSparseProcessor::CqtSparseProcessor;
+
+    void processBlock(NsgfCqtSparse::Coefs& /*block*/) override
+    {
+        if (++hops != 8 || host == nullptr) return;
+        Index until = host->load() + stall;
+        while (host->load() < until) std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    const std::atomic<Index>* host  = nullptr; ///< Samples the host has streamed.
+    Index                     stall = 0;       ///< Host samples to sleep for.
+    int                       hops  = 0;
+};
+} // namespace
+
 // Block-processor, dense: exact reconstruction (painless frame, no sliding).
 // (blockSize must be large enough for the atoms to be resolved — a 32-sample
 // block at fMin = 100 Hz is rejected by the frame-health check by design.)
@@ -113,3 +209,662 @@ BOOST_AUTO_TEST_CASE(OlaProc4)
     ArrayXd d       = x.head(N - latency) - y.tail(N - latency);
     BOOST_CHECK_MESSAGE(rms(d) < 1e-3, "rms = " << rms(d));
 }
+
+// OlaProc4 with mixed-radix spans: the half-span overlap still holds on
+// every band, so the sliding error stays at the power-of-two level.
+BOOST_AUTO_TEST_CASE(OlaProc5)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 18;
+    Index  blockSize = 1 << 16;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y = ArrayXd::Zero(N);
+
+    SliCqtSparse ola(fs, blockSize, 1.0 / 3.0, 1e2, 1e4, 1e3, SpanPolicy::MixedRadix);
+    if (!ola.isValid()) {
+        BOOST_CHECK(!DFT::isSupported(12)); // only power-of-two backends: inert by design
+        return;
+    }
+
+    for (Index n = 0; n < N; n++) {
+        y(n) = ola.processSample(x(n));
+    }
+
+    Index   latency = ola.getLatency();
+    ArrayXd d       = x.head(N - latency) - y.tail(N - latency);
+    BOOST_CHECK_MESSAGE(rms(d) < 1e-3, "rms = " << rms(d));
+}
+
+// Bulk processing: process() over irregular host buffers (1 sample up to
+// several hops, straddling block boundaries) must produce exactly what the
+// per-sample path does, in place or not.
+BOOST_AUTO_TEST_CASE(OlaProcBlocks)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 14;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    auto check = [&](auto& perSample, auto& bulk, const char* name) {
+        BOOST_REQUIRE_MESSAGE(perSample.isValid(), name);
+        ArrayXd y(N), z = x;
+        for (Index n = 0; n < N; n++) y(n) = perSample.processSample(x(n));
+
+        Index sizes[] = {1, 7, 32, 100, 513, 2048};
+        for (Index n = 0, i = 0; n < N; i++) {
+            Index len = std::min(sizes[i % 6], N - n);
+            bulk.process(z.data() + n, z.data() + n, len);
+            n += len;
+        }
+        BOOST_CHECK_MESSAGE((y - z).abs().maxCoeff() == 0, name << ": " << (y - z).abs().maxCoeff());
+    };
+
+    CqtDense a(fs, blockSize, 1, 4e2, 1e4, 1e3), b(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    check(a, b, "dense");
+    CqtSparse c(fs, blockSize, 1, 4e2, 1e4, 1e3), d(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    check(c, d, "sparse");
+    SliCqtDense e(fs, blockSize, 1, 4e2, 1e4, 1e3), f(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    check(e, f, "sliding dense");
+    SliCqtSparse g(fs, blockSize, 1, 4e2, 1e4, 1e3), h(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    check(g, h, "sliding sparse");
+    MultirateCqt m1(fs, 1 << 8, 1.0 / 12.0, 2e2, 1e4, 440), m2(fs, 1 << 8, 1.0 / 12.0, 2e2, 1e4, 440);
+    check(m1, m2, "multirate");
+}
+
+// Overlap factor R: blocks advance by N/R under WOLA-normalized sqrt-Hann
+// windows. Every processor must reconstruct its input delayed by exactly
+// getLatency() (N for the block processors, 2N - N/R for the sliding ones)
+// at every R; a wrong latency would leave an O(1) error.
+BOOST_AUTO_TEST_CASE(OlaProcOverlap)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 15;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    auto check = [&](auto& proc, Index R, Index latency, double tol, const char* name) {
+        BOOST_REQUIRE_MESSAGE(proc.isValid(), name << " R = " << R);
+        BOOST_CHECK_EQUAL(proc.getHopSize(), blockSize / R);
+        BOOST_CHECK_EQUAL(proc.getLatency(), latency);
+        ArrayXd y(N);
+        proc.process(x.data(), y.data(), N);
+        ArrayXd d = x.head(N - latency) - y.tail(N - latency);
+        BOOST_CHECK_MESSAGE(rms(d) < tol, name << " R = " << R << ": rms = " << rms(d));
+    };
+
+    for (Index R : {2, 4, 8}) {
+        Index hop = blockSize / R;
+        CqtDense a(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        check(a, R, blockSize, 1e-10, "dense");
+        CqtSparse b(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        check(b, R, blockSize, 1e-10, "sparse");
+        SliCqtDense c(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        check(c, R, 2 * blockSize - hop, 1e-2, "sliding dense");
+        SliCqtSparse d(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        check(d, R, 2 * blockSize - hop, 1e-2, "sliding sparse");
+    }
+
+    // R must be a whole divisor >= 2 of the block size; otherwise inert.
+    for (Index R : {0, 1, 3}) {
+        CqtSparse    bad(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        SliCqtSparse slidingBad(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        BOOST_CHECK(!bad.isValid() && !slidingBad.isValid());
+        BOOST_CHECK_EQUAL(bad.processSample(1.0), 0.0);
+    }
+}
+
+// Amortized mode runs the same hop job in stages spread over the next hop:
+// the output must be the immediate mode's, one hop later, whatever the
+// host buffer sizes (including single samples and buffers spanning hops).
+BOOST_AUTO_TEST_CASE(OlaProcAmortized)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 14;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    auto check = [&](auto& proc, auto& ref, const char* name) {
+        BOOST_REQUIRE_MESSAGE(proc.isValid(), name);
+        Index latency = ref.getLatency();
+        proc.setAmortized(true);
+        BOOST_CHECK(proc.isAmortized());
+        BOOST_CHECK_EQUAL(proc.getLatency(), latency + proc.getHopSize());
+
+        ArrayXd y(N), z(N);
+        ref.process(x.data(), y.data(), N);
+        Index sizes[] = {1, 7, 32, 100, 513, 2048};
+        for (Index n = 0, i = 0; n < N; i++) {
+            Index len = std::min(sizes[i % 6], N - n);
+            if (len == 1) z[n] = proc.processSample(x[n]);
+            else proc.process(x.data() + n, z.data() + n, len);
+            n += len;
+        }
+        Index  hop = proc.getHopSize();
+        double err = (z.tail(N - hop) - y.head(N - hop)).abs().maxCoeff();
+        BOOST_CHECK_MESSAGE(err < 1e-12, name << ": " << err);
+        BOOST_CHECK_MESSAGE(z.head(hop).abs().maxCoeff() == 0, name << ": output before the first job");
+    };
+
+    for (Index R : {2, 4}) {
+        CqtDense a(fs, blockSize, 1, 4e2, 1e4, 1e3, R), aRef(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        check(a, aRef, "dense");
+        CqtSparse b(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        CqtSparse bRef(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        check(b, bRef, "sparse");
+        SliCqtDense c(fs, blockSize, 1, 4e2, 1e4, 1e3, R), cRef(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        check(c, cRef, "sliding dense");
+        SliCqtSparse d(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        SliCqtSparse dRef(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        check(d, dRef, "sliding sparse");
+    }
+}
+
+// Delta inverse: only the bands processBlock() changed are resynthesized,
+// on top of the dry block. The output must match full resynthesis, in
+// immediate and amortized mode, and an identity processBlock() must leave
+// nothing to resynthesize and the input delayed exactly.
+BOOST_AUTO_TEST_CASE(OlaProcDeltaInverse)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 14;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    auto check = [&](auto& proc, auto& ref, Index changed, bool amortized, const char* name) {
+        BOOST_REQUIRE_MESSAGE(proc.isValid(), name);
+        proc.setAmortized(amortized);
+        ref.setAmortized(amortized);
+        proc.setDeltaInverse(true);
+        BOOST_CHECK(proc.isDeltaInverse() && !ref.isDeltaInverse());
+        BOOST_CHECK_EQUAL(ref.getNumDirtyBands(), ref.getCqt().getNumBands());
+
+        ArrayXd y(N), z(N);
+        ref.process(x.data(), y.data(), N);
+        proc.process(x.data(), z.data(), N);
+        double err = (y - z).abs().maxCoeff();
+        BOOST_CHECK_MESSAGE(err < 1e-12, name << (amortized ? " amortized" : "") << ": " << err);
+        BOOST_CHECK_EQUAL(proc.getNumDirtyBands(), changed);
+    };
+
+    for (bool amortized : {false, true}) {
+        TwoBandsDense  a(fs, blockSize, 1, 4e2, 1e4, 1e3), aRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+        TwoBandsSparse b(fs, blockSize, 1, 4e2, 1e4, 1e3), bRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+        CqtDense       c(fs, blockSize, 1, 4e2, 1e4, 1e3), cRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+        CqtSparse      d(fs, blockSize, 1, 4e2, 1e4, 1e3), dRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+        check(a, aRef, 2, amortized, "dense");
+        check(b, bRef, 2, amortized, "sparse");
+        check(c, cRef, 0, amortized, "dense identity");
+        check(d, dRef, 0, amortized, "sparse identity");
+
+        CqtSparse e(fs, blockSize, 1, 4e2, 1e4, 1e3);
+        e.setAmortized(amortized);
+        e.setDeltaInverse(true);
+        ArrayXd z(N);
+        e.process(x.data(), z.data(), N);
+        Index latency = e.getLatency();
+        BOOST_CHECK((z.tail(N - latency) - x.head(N - latency)).abs().maxCoeff() < 1e-15);
+    }
+}
+
+// Analyzers are the processors without synthesis: for the same input they
+// must hand processBlock() the same coefficients, hop for hop.
+BOOST_AUTO_TEST_CASE(OlaProcAnalyzer)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 13;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y(N);
+
+    auto distance = [](const auto& a, const auto& b) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(a)>, ArrayXXcd>) return (a - b).abs().maxCoeff();
+        else {
+            double d = 0;
+            for (size_t k = 0; k < a.size(); k++) d = std::max(d, (a[k] - b[k]).abs().maxCoeff());
+            return d;
+        }
+    };
+    auto check = [&](auto& proc, auto& analyzer, const char* name) {
+        BOOST_REQUIRE_MESSAGE(proc.isValid() && analyzer.isValid(), name);
+        BOOST_CHECK_EQUAL(analyzer.getHopSize(), proc.getHopSize());
+        proc.process(x.data(), y.data(), N);
+        for (Index n = 0; n < N; n += 100) analyzer.process(x.data() + n, std::min<Index>(100, N - n));
+        BOOST_REQUIRE_EQUAL(analyzer.blocks.size(), proc.blocks.size());
+        BOOST_CHECK(proc.blocks.size() == size_t(N / proc.getHopSize()));
+        double d = 0;
+        for (size_t i = 0; i < proc.blocks.size(); i++) d = std::max(d, distance(proc.blocks[i], analyzer.blocks[i]));
+        BOOST_CHECK_MESSAGE(d == 0, name << ": " << d);
+    };
+
+    using Coefs = NsgfCqtSparse::Coefs;
+    for (Index R : {2, 4}) {
+        Recorder<CqtDenseProcessor, ArrayXXcd&>             a(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        Recorder<CqtDenseAnalyzer, const ArrayXXcd&>        aa(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        Recorder<CqtSparseProcessor, Coefs&>                b(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        Recorder<CqtSparseAnalyzer, const Coefs&>           ba(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        Recorder<SlidingCqtDenseProcessor, ArrayXXcd&>      c(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        Recorder<SlidingCqtDenseAnalyzer, const ArrayXXcd&> ca(fs, blockSize, 1, 4e2, 1e4, 1e3, R);
+        Recorder<SlidingCqtSparseProcessor, Coefs&>         d(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        Recorder<SlidingCqtSparseAnalyzer, const Coefs&>    da(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, R);
+        check(a, aa, "dense");
+        check(b, ba, "sparse");
+        check(c, ca, "sliding dense");
+        check(d, da, "sliding sparse");
+    }
+
+    // Invalid configurations are inert: processBlock() is never called.
+    Recorder<CqtSparseAnalyzer, const Coefs&> bad(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, 3);
+    bad.process(x.data(), N);
+    BOOST_CHECK(!bad.isValid() && bad.blocks.empty());
+}
+
+/// Keeps every hop's band energies, in energy-only mode.
+template <typename Base, typename Block>
+class EnergyRecorder : public Recorder<Base, Block>
+{
+  public:
+    using Recorder<Base, Block>::Recorder;
+
+    void processEnergies(const ArrayXd& e) override { energies.push_back(e); }
+
+    vector<ArrayXd> energies;
+};
+
+// Energy-only analyzers must report, hop for hop, the energy of the
+// coefficients the ordinary mode hands processBlock().
+BOOST_AUTO_TEST_CASE(OlaProcAnalyzerEnergies)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 13;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    using Coefs = NsgfCqtSparse::Coefs;
+    EnergyRecorder<CqtDenseAnalyzer, const ArrayXXcd&> dense(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    EnergyRecorder<CqtDenseAnalyzer, const ArrayXXcd&> denseE(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    EnergyRecorder<CqtSparseAnalyzer, const Coefs&>    sparse(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    EnergyRecorder<CqtSparseAnalyzer, const Coefs&>    sparseE(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    BOOST_REQUIRE(dense.isValid() && sparse.isValid());
+    denseE.setEnergyOnly(true);
+    sparseE.setEnergyOnly(true);
+    BOOST_CHECK(sparseE.isEnergyOnly() && !sparse.isEnergyOnly());
+    for (auto* a : {&dense, &denseE}) a->process(x.data(), N);
+    for (auto* a : {&sparse, &sparseE}) a->process(x.data(), N);
+    BOOST_CHECK(denseE.blocks.empty() && sparseE.blocks.empty());
+    BOOST_REQUIRE_EQUAL(denseE.energies.size(), dense.blocks.size());
+    BOOST_REQUIRE_EQUAL(sparseE.energies.size(), sparse.blocks.size());
+
+    double err = 0;
+    for (size_t i = 0; i < dense.blocks.size(); i++) {
+        ArrayXd ref = dense.blocks[i].abs2().colwise().sum().transpose();
+        err         = std::max(err, ((denseE.energies[i] - ref).abs() / ref.maxCoeff()).maxCoeff());
+    }
+    for (size_t i = 0; i < sparse.blocks.size(); i++) {
+        ArrayXd ref(sparse.blocks[i].size());
+        for (size_t k = 0; k < sparse.blocks[i].size(); k++) ref(Index(k)) = sparse.blocks[i][k].abs2().sum();
+        err = std::max(err, ((sparseE.energies[i] - ref).abs() / ref.maxCoeff()).maxCoeff());
+    }
+    BOOST_CHECK_SMALL(err, 1e-9);
+}
+
+// A snapshot tap hands the reader the last hop's coefficients as
+// processBlock() saw them, resampled to the tap's grid, and never a torn frame.
+BOOST_AUTO_TEST_CASE(OlaProcSnapshotTap)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 13;
+    Index  blockSize = 1 << 10;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y(N);
+
+    using Coefs = NsgfCqtSparse::Coefs;
+
+    // Magnitudes on the longest band's grid: peak of each group, and short
+    // bands stretched.
+    SnapshotTap                          magTap;
+    Recorder<CqtSparseProcessor, Coefs&> sparse(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo);
+    sparse.setSnapshotTap(&magTap);
+    BOOST_CHECK(!magTap.pull());
+    sparse.process(x.data(), y.data(), N);
+    BOOST_REQUIRE(magTap.pull());
+    BOOST_CHECK(!magTap.pull());
+
+    const auto&  snap   = magTap.latest();
+    const Coefs& last   = sparse.blocks.back();
+    Index        frames = magTap.getNumFrames();
+    BOOST_CHECK_EQUAL(snap.index, sparse.blocks.size());
+    BOOST_CHECK_EQUAL(snap.magnitude.cols(), Index(last.size()));
+    BOOST_CHECK(snap.coefs.size() == 0);
+    double err = 0;
+    for (size_t k = 0; k < last.size(); k++) {
+        Index L = last[k].size();
+        BOOST_CHECK(L <= frames);
+        for (Index r = 0; r < frames; r++)
+            err = std::max(err, std::abs(snap.magnitude(r, Index(k)) - std::abs(last[k](r * L / frames))));
+    }
+    BOOST_CHECK_SMALL(err, 1e-5);
+
+    // Complex, decimated: frame r is sample r·L/frames of each band.
+    SnapshotTap                                    cTap;
+    Recorder<SlidingCqtDenseProcessor, ArrayXXcd&> sliding(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    sliding.setSnapshotTap(&cTap, {false, 8});
+    sliding.process(x.data(), y.data(), N);
+    BOOST_REQUIRE(cTap.pull());
+    const ArrayXXcd& Z = sliding.blocks.back();
+    BOOST_REQUIRE_EQUAL(cTap.latest().coefs.rows(), 8);
+    BOOST_REQUIRE_EQUAL(cTap.latest().coefs.cols(), Z.cols());
+    err = 0;
+    for (Index r = 0; r < 8; r++)
+        err = std::max(err, (cTap.latest().coefs.row(r).cast<std::complex<double>>() - Z.row(r * Z.rows() / 8)).abs().maxCoeff());
+    BOOST_CHECK_SMALL(err, 1e-5);
+
+    // Detaching stops publishing.
+    sliding.setSnapshotTap(nullptr);
+    sliding.process(x.data(), y.data(), N);
+    BOOST_CHECK(!cTap.pull());
+
+    // A reader polling while a writer publishes only ever sees whole frames,
+    // in order.
+    SnapshotTap tap;
+    ArrayXXcd   X = ArrayXXcd::Zero(64, 16);
+    tap.configure(X, {});
+    std::atomic<bool> done{false};
+    bool              whole = true, ordered = true;
+    std::thread       reader([&] {
+        uint64_t seen = 0;
+        while (!done.load()) {
+            if (!tap.pull()) continue;
+            const auto& s = tap.latest();
+            whole &= (s.magnitude == float(s.index)).all();
+            ordered &= s.index > seen;
+            seen = s.index;
+        }
+    });
+    for (int v = 1; v <= 20000; v++) {
+        X.setConstant(double(v));
+        tap.publish(X);
+    }
+    done = true;
+    reader.join();
+    BOOST_CHECK(whole);
+    BOOST_CHECK(ordered);
+}
+
+// A multi-channel processor taps one channel and publishes what the
+// single-channel processor would; the multirate one taps one octave, at that
+// octave's rate.
+BOOST_AUTO_TEST_CASE(OlaProcSnapshotTapMulti)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 13;
+    Index  blockSize = 1 << 10;
+
+    ArrayXXd      x     = ArrayXXd::Random(N, 2);
+    ArrayXXd      z(N, 2);
+    ArrayXd       y(N);
+    const double* in[]  = {x.col(0).data(), x.col(1).data()};
+    double*       out[] = {z.col(0).data(), z.col(1).data()};
+
+    auto same = [&](auto& multi, auto&& single, const char* name) {
+        SnapshotTap multiTap, singleTap;
+        multi.setSnapshotTap(1, &multiTap, {false, 0});
+        single.setSnapshotTap(&singleTap, {false, 0});
+        multi.process(in, out, N);
+        single.process(x.col(1).data(), y.data(), N);
+        BOOST_REQUIRE_MESSAGE(multiTap.pull() && singleTap.pull(), name);
+        BOOST_CHECK_EQUAL(multiTap.latest().index, singleTap.latest().index);
+        double err = (multiTap.latest().coefs - singleTap.latest().coefs).abs().maxCoeff();
+        BOOST_CHECK_MESSAGE(err < 1e-6, name << ": " << err);
+    };
+
+    MultiCqtDense a(2, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    same(a, CqtDense(fs, blockSize, 1, 4e2, 1e4, 1e3), "dense");
+    MultiCqtSparse b(2, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    same(b, CqtSparse(fs, blockSize, 1, 4e2, 1e4, 1e3), "sparse");
+    MultiSliCqtDense c(2, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    same(c, SliCqtDense(fs, blockSize, 1, 4e2, 1e4, 1e3), "sliding dense");
+    MultiSliCqtSparse d(2, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    same(d, SliCqtSparse(fs, blockSize, 1, 4e2, 1e4, 1e3), "sliding sparse");
+
+    // Octave 0 (12–24 kHz) lies above maxFrequency and never publishes.
+    MultirateEnergy proc(fs, 1 << 8, 1.0 / 12.0, 2e2, 1e4, 440);
+    SnapshotTap     skipped, high, low;
+    proc.setSnapshotTap(0, &skipped);
+    proc.setSnapshotTap(1, &high);
+    proc.setSnapshotTap(3, &low);
+    for (Index n = 0; n < N; n++) proc.processSample(x(n, 0));
+    BOOST_CHECK(!skipped.pull());
+    BOOST_REQUIRE(high.pull() && low.pull());
+    BOOST_CHECK_EQUAL(high.getNumBands(), proc.getCqt().getNumBands());
+    BOOST_CHECK_EQUAL(high.latest().index, proc.blocks[1]);
+    BOOST_CHECK_EQUAL(low.latest().index, proc.blocks[3]);
+    BOOST_CHECK(proc.blocks[1] > proc.blocks[3]);
+}
+
+// Worker-thread mode: the host thread only exchanges samples through rings.
+// Timing decides which outputs arrive in time, so every output sample must
+// be either the synchronous output delayed by the extra latency or silence,
+// and silence where there should be signal must have been counted as a
+// deadline miss. A worker stalled past the extra latency must be caught as
+// misses, play silence for the late hops and realign once it catches up.
+BOOST_AUTO_TEST_CASE(OlaProcAsync)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 15;
+    Index  blockSize = 1 << 10;
+    Index  hostSize  = 64;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    // Streams x in host buffers, pacing them a little so the worker keeps up.
+    auto stream = [&](auto& proc, ArrayXd& z) {
+        for (Index n = 0; n < N; n += hostSize) {
+            proc.process(x.data() + n, z.data() + n, hostSize);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+    // Samples that are neither the delayed reference nor silence, and
+    // samples silenced where the reference has signal.
+    auto compare = [&](const ArrayXd& z, const ArrayXd& y, Index extra, Index& wrong, Index& silenced) {
+        wrong = silenced = 0;
+        for (Index t = 0; t < N; t++) {
+            double ref = t >= extra ? y[t - extra] : 0.0;
+            if (std::abs(z[t] - ref) < 1e-12) continue;
+            if (z[t] == 0) silenced++;
+            else wrong++;
+        }
+    };
+
+    auto check = [&](auto& proc, auto& ref, const char* name) {
+        BOOST_REQUIRE_MESSAGE(proc.isValid(), name);
+        Index latency = ref.getLatency();
+        Index extra   = 4 * proc.getHopSize();
+        ArrayXd y(N), z(N);
+        ref.process(x.data(), y.data(), N);
+
+        proc.setAsync(true, {extra});
+        BOOST_CHECK(proc.isAsync());
+        BOOST_CHECK_EQUAL(proc.getLatency(), latency + extra);
+        stream(proc, z);
+        Index misses = proc.getDeadlineMisses();
+        proc.setAsync(false);
+        BOOST_CHECK(!proc.isAsync() && proc.getLatency() == latency);
+
+        Index wrong, silenced;
+        compare(z, y, extra, wrong, silenced);
+        BOOST_CHECK_MESSAGE(wrong == 0, name << ": " << wrong << " misaligned samples");
+        BOOST_CHECK_MESSAGE(silenced == 0 || misses > 0, name << ": " << silenced << " samples silenced uncounted");
+    };
+
+    Async<CqtDense>     a(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    Async<CqtSparse>    b(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    Async<SliCqtDense>  c(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    Async<SliCqtSparse> d(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    Async<Stalling>     e(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    CqtDense            aRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    CqtSparse           bRef(fs, blockSize, 1, 4e2, 1e4, 1e3), eRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    SliCqtDense         cRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    SliCqtSparse        dRef(fs, blockSize, 1, 4e2, 1e4, 1e3);
+    check(a, aRef, "dense");
+    check(b, bRef, "sparse");
+    check(c, cRef, "sliding dense");
+    check(d, dRef, "sliding sparse");
+
+    // The worker sleeps for four hops of host time at its 8th hop, three hops
+    // past the extra latency. The host then slows down in the second half so
+    // the worker catches up and the output realigns.
+    Index              extra = e.getHopSize();
+    std::atomic<Index> streamed{0};
+    e.host  = &streamed;
+    e.stall = 4 * e.getHopSize();
+    ArrayXd y(N), z(N);
+    eRef.process(x.data(), y.data(), N);
+    e.setAsync(true, {extra});
+    Index stalled = 0;
+    for (Index n = 0; n < N; n += hostSize) {
+        if (n == N / 2) stalled = e.getDeadlineMisses();
+        e.process(x.data() + n, z.data() + n, hostSize);
+        streamed = n + hostSize;
+        std::this_thread::sleep_for(std::chrono::microseconds(n < N / 2 ? 100 : 500));
+    }
+    Index misses = e.getDeadlineMisses();
+    e.setAsync(false);
+
+    // Every sample the stall made late is silence, never a shifted output.
+    Index wrong, silenced;
+    compare(z, y, extra, wrong, silenced);
+    BOOST_CHECK_MESSAGE(stalled > 0, "stall: no deadline miss counted");
+    BOOST_CHECK_MESSAGE(silenced >= e.stall - extra, "stall: only " << silenced << " samples silenced");
+    BOOST_CHECK_MESSAGE(wrong == 0, "stall: " << wrong << " misaligned samples");
+
+    // Once caught up the output is back in place: the second half is the
+    // delayed reference, short of any (counted) miss a loaded machine adds.
+    Index late = 0;
+    for (Index t = N / 2; t < N; t++) late += std::abs(z[t] - y[t - extra]) >= 1e-12;
+    BOOST_CHECK_MESSAGE(late == 0 || misses > stalled, "stall: " << late << " samples silenced uncounted");
+    BOOST_CHECK_MESSAGE(late < N / 8, "stall: " << late << " of " << N / 2 << " samples late after catching up");
+}
+
+// Multi-channel processors: one shared transform, channels batched per hop.
+// Every channel must come out as the single-channel processor's output for
+// the same input (up to the rounding of the batched FFTs), and
+// processBlock() sees all channels at once: swapping two of them in the
+// coefficient domain swaps the outputs.
+BOOST_AUTO_TEST_CASE(OlaProcMultiChannel)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 14;
+    Index  blockSize = 1 << 10;
+    Index  nCh       = 3;
+
+    ArrayXXd x = ArrayXXd::Random(N, nCh);
+
+    auto run = [&](auto& multi, auto makeSingle, const char* name) {
+        BOOST_REQUIRE_MESSAGE(multi.isValid(), name);
+        BOOST_CHECK_EQUAL(multi.getNumChannels(), nCh);
+        ArrayXXd z = x;
+        vector<const double*> in;
+        vector<double*>       out;
+        for (Index c = 0; c < nCh; c++) {
+            in.push_back(z.col(c).data());
+            out.push_back(z.col(c).data());
+        }
+        Index sizes[] = {1, 7, 32, 100, 513, 2048};
+        for (Index n = 0, i = 0; n < N; i++) {
+            Index len = std::min(sizes[i % 6], N - n);
+            multi.process(in.data(), out.data(), len);
+            for (Index c = 0; c < nCh; c++) in[c] += len, out[c] += len;
+            n += len;
+        }
+        for (Index c = 0; c < nCh; c++) {
+            auto    single = makeSingle();
+            ArrayXd y(N);
+            single.process(x.col(c).data(), y.data(), N);
+            BOOST_CHECK_EQUAL(multi.getLatency(), single.getLatency());
+            double err = (y - z.col(c)).abs().maxCoeff();
+            BOOST_CHECK_MESSAGE(err < 1e-12, name << " channel " << c << ": " << err);
+        }
+    };
+
+    MultiCqtDense a(nCh, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    run(a, [&] { return CqtDense(fs, blockSize, 1, 4e2, 1e4, 1e3); }, "dense");
+    MultiCqtSparse b(nCh, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    run(b, [&] { return CqtSparse(fs, blockSize, 1, 4e2, 1e4, 1e3); }, "sparse");
+    MultiSliCqtDense c(nCh, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    run(c, [&] { return SliCqtDense(fs, blockSize, 1, 4e2, 1e4, 1e3); }, "sliding dense");
+    MultiSliCqtSparse d(nCh, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    run(d, [&] { return SliCqtSparse(fs, blockSize, 1, 4e2, 1e4, 1e3); }, "sliding sparse");
+    MultiSliCqtDense e(nCh, fs, blockSize, 1, 4e2, 1e4, 1e3, 4);
+    run(e, [&] { return SliCqtDense(fs, blockSize, 1, 4e2, 1e4, 1e3, 4); }, "sliding dense, R = 4");
+    MultiSliCqtSparse f(nCh, fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, 4);
+    run(f, [&] { return SliCqtSparse(fs, blockSize, 1, 4e2, 1e4, 1e3, SpanPolicy::PowerOfTwo, 4); }, "sliding sparse, R = 4");
+
+    SwapChannels swap(2, fs, blockSize, 1, 4e2, 1e4, 1e3);
+    ArrayXXd     y(N, 2);
+    const double* in[]  = {x.col(0).data(), x.col(1).data()};
+    double*       out[] = {y.col(0).data(), y.col(1).data()};
+    swap.process(in, out, N);
+    Index   latency = swap.getLatency();
+    ArrayXd d0      = x.col(1).head(N - latency) - y.col(0).tail(N - latency);
+    ArrayXd d1      = x.col(0).head(N - latency) - y.col(1).tail(N - latency);
+    BOOST_CHECK_MESSAGE(rms(d0) < 1e-10 && rms(d1) < 1e-10, "rms = " << rms(d0) << ", " << rms(d1));
+}
+
+// Multirate processor: every octave runs the same 256-sample CQT at its own
+// rate, and the half-band residual split makes the chain an exact delay
+// whatever the filter does (measured ≈ 9e-16). A sinusoid must land in the
+// octave and band closest to its frequency.
+BOOST_AUTO_TEST_CASE(OlaProcMultirate)
+{
+    double fs        = 48000;
+    Index  N         = 1 << 16;
+    Index  blockSize = 1 << 8;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y = ArrayXd::Zero(N);
+
+    MultirateCqt ola(fs, blockSize, 1.0 / 12.0, 2e2, 1e4, 440);
+    BOOST_REQUIRE(ola.isValid());
+    BOOST_CHECK_EQUAL(ola.getCqt().getNumBands(), 12);
+
+    for (Index n = 0; n < N; n++) {
+        y(n) = ola.processSample(x(n));
+    }
+
+    Index latency = ola.getLatency();
+    BOOST_REQUIRE(latency < N / 2);
+    ArrayXd d = x.head(N - latency) - y.tail(N - latency);
+    BOOST_CHECK_MESSAGE(rms(d) < 1e-10, "rms = " << rms(d));
+
+    MultirateEnergy proc(fs, blockSize, 1.0 / 12.0, 2e2, 1e4, 440);
+    ArrayXd         t = regspace(N) / fs;
+    ArrayXd         s = (2 * std::numbers::pi * 440 * t).sin();
+    for (Index n = 0; n < N; n++) proc.processSample(s(n));
+
+    Index o, k;
+    proc.energy.maxCoeff(&o, &k);
+    double cents = 1200 * std::log2(proc.getBandFrequency(o, k) / 440);
+    BOOST_CHECK_MESSAGE(std::abs(cents) < 1, "octave " << o << ", band " << k << ": " << cents << " cents");
+}
+
+// Invalid configurations leave the multirate processor inert.
+BOOST_AUTO_TEST_CASE(OlaProcMultirateInvalid)
+{
+    MultirateCqt fractional(48000, 1 << 8, 1.0 / 2.5, 2e2, 1e4, 440);
+    MultirateCqt noRate(0, 1 << 8, 1.0 / 12.0, 2e2, 1e4, 440);
+    MultirateCqt tooShort(48000, 1 << 3, 1.0 / 12.0, 2e2, 1e4, 440);
+
+    for (MultirateCqt* p : {&fractional, &noRate, &tooShort}) {
+        BOOST_CHECK(!p->isValid());
+        BOOST_CHECK_EQUAL(p->getNumOctaves(), 0);
+        BOOST_CHECK_EQUAL(p->processSample(1.0), 0.0);
+    }
+}
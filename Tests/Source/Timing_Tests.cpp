@@ -5,17 +5,42 @@
 //  Benchmarks (CTest label "bench", no correctness assertions): wall-time of
 //  one full forward + inverse pass over 2^20 samples at 12 bands/octave, for
 //  the dense (BenchmarkTest1) and sparse (BenchmarkTest2) transforms —
-//  prints the realtime multiple. Correctness round trips live in
-//  CQT_UnitTests.cpp.
+//  prints the realtime multiple. BenchmarkTest3 shows how the opt-in
+//  parallel sparse band loops scale with thread count, BenchmarkTest4
+//  compares cold construction with a FrameCache load, and BenchmarkTest5
+//  compares the coefficient footprint and speed of power-of-two and
+//  mixed-radix sparse spans. BenchmarkTest6 streams a 20 Hz – 10 kHz range
+//  through the single-rate and the multirate sparse processors, each at the
+//  smallest block it accepts. BenchmarkTest7 times a dense round trip and
+//  compares the batched DFT matrix overloads it runs with the per-column
+//  loop they replaced. BenchmarkTest8 times a processor-sized sparse round
+//  trip with the small-size DFT codelets disabled and enabled, and
+//  BenchmarkTest9 streams a sparse processor per sample and through
+//  process() at host buffer sizes. BenchmarkTest10 compares the worst and
+//  mean callback time of a sparse processor with and without amortized
+//  hops. BenchmarkTest11 streams a sparse processor that edits 3 of its
+//  bands with full and with delta resynthesis, and BenchmarkTest12 streams
+//  the same configuration through a processor, an analyzer and an
+//  energy-only analyzer. BenchmarkTest13 compares a sparse forward followed
+//  by |·| with forwardMagnitude(), linear and in decibels. Correctness round
+//  trips live in CQT_UnitTests.cpp.
 //
 
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 
 #include <CQT.hpp>
 #include <Eigen/Core>
+#include <FFT.hpp>
+#include <FrameCache.hpp>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "Benchtools.h"
+#include "EmptyCQTProc.h"
 
 using namespace Eigen;
 using namespace jsa::cicuetea;
@@ -93,3 +118,482 @@ BOOST_AUTO_TEST_CASE(BenchmarkTest2)
     std::cout << Xcq.size() << std::endl;
     BOOST_CHECK(true);
 }
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest3)
+{
+    double sampleRate = 48000;
+    Index  nSamps     = 1 << 18;
+    double fraction   = 1.0 / 48.0;
+    double fMin       = 100;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    jsa::cicuetea::NsgfCqtSparse cqt(sampleRate, nSamps, fraction, fMin, fMax, fRef);
+
+    ArrayXd                             x   = ArrayXd::Random(nSamps);
+    ArrayXd                             y   = ArrayXd::Zero(nSamps);
+    jsa::cicuetea::NsgfCqtSparse::Coefs Xcq = cqt.getCoefs();
+
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    double   serial     = 0;
+
+    std::cout << "nBands: " << cqt.getNumBands() << std::endl;
+    for (unsigned nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        cqt.setNumThreads(nThreads);
+        cqt.forward(x, Xcq); // warm-up
+
+        Timer tFwd(false);
+        cqt.forward(x, Xcq);
+        double dur1 = tFwd.get();
+
+        Timer tInv(false);
+        cqt.inverse(Xcq, y);
+        double dur2 = tInv.get();
+
+        if (nThreads == 1) serial = dur1 + dur2;
+        std::cout << nThreads << " threads: " << dur1 << "," << dur2 << " ms, speedup "
+                  << serial / (dur1 + dur2) << "x" << std::endl;
+    }
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest4)
+{
+    namespace fs = std::filesystem;
+
+    double sampleRate = 48000;
+    Index  nSamps     = 1 << 18;
+    double fraction   = 1.0 / 48.0;
+    double fMin       = 100;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    auto& registry = jsa::cicuetea::NsgfCqtSparse::Registry::instance();
+    auto  capacity = registry.getCapacity();
+    registry.setCapacity(0); // time the cache, not the in-process registry
+
+    fs::path dir = fs::temp_directory_path() / "cicuetea-bench-cache";
+    fs::remove_all(dir);
+    FrameCache::setDirectory(dir.string());
+
+    auto construct = [&] {
+        Timer t(false);
+        jsa::cicuetea::NsgfCqtSparse cqt(sampleRate, nSamps, fraction, fMin, fMax, fRef);
+        return t.get();
+    };
+
+    double cold   = construct(); // designs the frame and writes the file
+    double cached = construct(); // loads the file
+
+    std::cout << "Construction: cold " << cold << " ms, cached " << cached << " ms, speedup "
+              << cold / cached << "x" << std::endl;
+
+    FrameCache::setDirectory("");
+    registry.setCapacity(capacity);
+    fs::remove_all(dir);
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest5)
+{
+    double sampleRate = 48000;
+    Index  nSamps     = 1 << 18;
+    double fraction   = 1.0 / 48.0;
+    double fMin       = 100;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    ArrayXd x      = ArrayXd::Random(nSamps);
+    ArrayXd y      = ArrayXd::Zero(nSamps);
+    double  pow2Ms = 0;
+    Index   pow2N  = 0;
+
+    std::cout << "Backend: " << DFT::getName() << std::endl;
+    for (SpanPolicy policy : {SpanPolicy::PowerOfTwo, SpanPolicy::MixedRadix}) {
+        jsa::cicuetea::NsgfCqtSparse cqt(sampleRate, nSamps, fraction, fMin, fMax, fRef, policy);
+        if (!cqt.isValid()) {
+            std::cout << "Mixed radix:  no backend plans the spans" << std::endl;
+            continue;
+        }
+
+        auto  Xcq    = cqt.getCoefs();
+        Index nCoefs = 0;
+        for (const auto& band : Xcq) nCoefs += band.size();
+
+        cqt.forward(x, Xcq); // warm-up
+
+        Timer tFwd(false);
+        cqt.forward(x, Xcq);
+        double dur1 = tFwd.get();
+
+        Timer tInv(false);
+        cqt.inverse(Xcq, y);
+        double dur2 = tInv.get();
+
+        bool first = policy == SpanPolicy::PowerOfTwo;
+        if (first) {
+            pow2Ms = dur1 + dur2;
+            pow2N  = nCoefs;
+        }
+        std::cout << (first ? "Power of two: " : "Mixed radix:  ") << nCoefs << " coefficients ("
+                  << 100.0 * double(nCoefs) / double(pow2N) << "%), " << dur1 << "," << dur2
+                  << " ms (" << pow2Ms / (dur1 + dur2) << "x)" << std::endl;
+    }
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest6)
+{
+    double sampleRate = 48000;
+    Index  N          = 1 << 20;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 20;
+    double fMax       = 10000;
+    double fRef       = 440;
+
+    ArrayXd x = ArrayXd::Random(N);
+
+    // Smallest power-of-two block each processor accepts for this range.
+    auto smallest = [&](auto make) {
+        Index blockSize = 1 << 4;
+        while (!make(blockSize)->isValid()) blockSize *= 2;
+        return make(blockSize);
+    };
+    auto single = smallest([&](Index b) {
+        return std::make_unique<CqtSparse>(sampleRate, b, fraction, fMin, fMax, fRef);
+    });
+    auto multi = smallest([&](Index b) {
+        return std::make_unique<MultirateCqt>(sampleRate, b, fraction, fMin, fMax, fRef);
+    });
+
+    auto run = [&](auto& proc) {
+        Timer t(false);
+        for (Index n = 0; n < N; n++) x(n) = proc.processSample(x(n));
+        return t.get();
+    };
+    double singleMs = run(*single);
+    double multiMs  = run(*multi);
+
+    Index singleCoefs = 0, multiCoefs = 0;
+    for (const auto& band : single->getCqt().getCoefs()) singleCoefs += band.size();
+    for (const auto& band : multi->getCqt().getCoefs()) multiCoefs += band.size();
+
+    double seconds = N / sampleRate;
+    std::cout << "Single rate: block " << single->getCqt().getBlockSize() << ", latency "
+              << single->getLatency() << ", " << singleCoefs << " coefficients, " << singleMs
+              << " ms (" << seconds * 1000 / singleMs << "x realtime)" << std::endl;
+    std::cout << "Multirate:   block " << multi->getCqt().getBlockSize() << " x "
+              << multi->getNumOctaves() << " octaves, latency " << multi->getLatency() << ", "
+              << multiCoefs << " coefficients per octave, " << multiMs << " ms ("
+              << seconds * 1000 / multiMs << "x realtime)" << std::endl;
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest7)
+{
+    double sampleRate = 48000;
+    Index  nSamps     = 1 << 16;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 100;
+    double fMax       = 10000;
+    double fRef       = 1000;
+    int    nReps      = 4;
+
+    NsgfCqtDense cqt(sampleRate, nSamps, fraction, fMin, fMax, fRef);
+
+    Index     nBands = cqt.getNumBands();
+    ArrayXd   x      = ArrayXd::Random(nSamps);
+    ArrayXd   y      = ArrayXd::Zero(nSamps);
+    ArrayXXcd Xcq    = ArrayXXcd::Zero(nSamps, nBands);
+    ArrayXXcd Xmat   = ArrayXXcd::Random(nSamps, nBands);
+
+    Timer tTrip(false);
+    for (int r = 0; r < nReps; r++) {
+        cqt.forward(x, Xcq);
+        cqt.inverse(Xcq, y);
+    }
+    double tripMs = tTrip.get() / nReps;
+
+    // The two matrix stages of a round trip (idft of the bands, dft of the
+    // coefficients), batched and as the per-column loop. The loop goes
+    // through the 1-D overloads, so it also pays one column copy each way.
+    DFT dft{size_t(nSamps)};
+    dft.prepareBatch(nBands, nSamps);
+
+    Timer tBatch(false);
+    for (int r = 0; r < nReps; r++) {
+        dft.idft(Xmat, Xcq);
+        dft.dft(Xcq, Xmat);
+    }
+    double batchMs = tBatch.get() / nReps;
+
+    ArrayXcd in(nSamps), out(nSamps);
+    Timer    tLoop(false);
+    for (int r = 0; r < nReps; r++) {
+        for (Index k = 0; k < nBands; k++) {
+            in = Xmat.col(k);
+            dft.idft(in, out);
+            Xcq.col(k) = out;
+        }
+        for (Index k = 0; k < nBands; k++) {
+            in = Xcq.col(k);
+            dft.dft(in, out);
+            Xmat.col(k) = out;
+        }
+    }
+    double loopMs = tLoop.get() / nReps;
+
+    std::cout << "Dense round trip (" << nBands << " bands x " << nSamps << " samples, "
+              << DFT::getName() << "): " << tripMs << " ms" << std::endl;
+    std::cout << "Matrix DFT stages: batched " << batchMs << " ms, per column " << loopMs
+              << " ms (" << loopMs / batchMs << "x)" << std::endl;
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest8)
+{
+    double sampleRate = 48000;
+    Index  nSamps     = 1 << 12;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 200;
+    double fMax       = 10000;
+    double fRef       = 1000;
+    int    nReps      = 2000;
+
+    ArrayXd x = ArrayXd::Random(nSamps);
+    ArrayXd y = ArrayXd::Zero(nSamps);
+
+    // A processor-sized sparse transform, with most band spans within
+    // codelet range, with the codelets disabled and enabled: the band DFTs
+    // alone (one idft and one dft per band, as a round trip runs them), then
+    // the whole round trip.
+    size_t limit      = DFT::getMaxCodeletSize();
+    double bandsMs[2] = {0, 0};
+    double tripMs[2]  = {0, 0};
+    for (int pass = 0; pass < 2; pass++) {
+        DFT::setMaxCodeletSize(pass == 0 ? 0 : limit);
+        NsgfCqtSparse cqt(sampleRate, nSamps, fraction, fMin, fMax, fRef, SpanPolicy::PowerOfTwo);
+        auto          Xcq = cqt.getCoefs();
+
+        Index                             nBands = cqt.getNumBands(), small = 0;
+        std::vector<std::unique_ptr<DFT>> dfts;
+        for (Index k = 0; k < nBands; k++) {
+            small += cqt.getLength(k) <= Index(limit);
+            dfts.push_back(std::make_unique<DFT>(size_t(cqt.getLength(k))));
+        }
+        if (pass == 1)
+            std::cout << small << " of " << nBands << " bands within codelet range (" << DFT::getName() << ")"
+                      << std::endl;
+
+        Timer tBands(false);
+        for (int r = 0; r < nReps; r++)
+            for (Index k = 0; k < nBands; k++) {
+                dfts[k]->idft(Xcq[k], Xcq[k]);
+                dfts[k]->dft(Xcq[k], Xcq[k]);
+            }
+        bandsMs[pass] = tBands.get() / nReps;
+
+        cqt.forward(x, Xcq); // warm-up
+        Timer tTrip(false);
+        for (int r = 0; r < nReps; r++) {
+            cqt.forward(x, Xcq);
+            cqt.inverse(Xcq, y);
+        }
+        tripMs[pass] = tTrip.get() / nReps;
+    }
+    DFT::setMaxCodeletSize(limit);
+
+    std::cout << "Band DFTs:  backend " << bandsMs[0] << " ms, codelets " << bandsMs[1] << " ms ("
+              << bandsMs[0] / bandsMs[1] << "x)" << std::endl;
+    std::cout << "Round trip: backend " << tripMs[0] << " ms, codelets " << tripMs[1] << " ms ("
+              << tripMs[0] / tripMs[1] << "x)" << std::endl;
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest9)
+{
+    double sampleRate = 48000;
+    Index  N          = 1 << 20;
+    Index  blockSize  = 1 << 12;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 200;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y = ArrayXd::Zero(N);
+
+    // The same processor driven per sample and through process() at typical
+    // host buffer sizes.
+    CqtSparse proc(sampleRate, blockSize, fraction, fMin, fMax, fRef);
+
+    Timer tSample(false);
+    for (Index n = 0; n < N; n++) y(n) = proc.processSample(x(n));
+    double sampleMs = tSample.get();
+    std::cout << "Per sample:   " << sampleMs << " ms" << std::endl;
+
+    for (Index hostSize : {32, 256, 2048}) {
+        Timer t(false);
+        for (Index n = 0; n < N; n += hostSize) proc.process(x.data() + n, y.data() + n, hostSize);
+        double ms = t.get();
+        std::cout << "Buffers of " << hostSize << ": " << ms << " ms (" << sampleMs / ms << "x)" << std::endl;
+    }
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest10)
+{
+    double sampleRate = 48000;
+    Index  N          = 1 << 20;
+    Index  blockSize  = 1 << 12;
+    Index  hostSize   = 64;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 200;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y = ArrayXd::Zero(N);
+
+    // Callback times with the hop's work in one callback and spread over
+    // the next hop's callbacks. Every 32nd callback completes a hop, so the
+    // 99th percentile shows the spike; the maximum is mostly scheduler noise.
+    for (bool amortized : {false, true}) {
+        CqtSparse proc(sampleRate, blockSize, fraction, fMin, fMax, fRef);
+        proc.setAmortized(amortized);
+
+        std::vector<double> us;
+        us.reserve(size_t(N / hostSize));
+        for (Index n = 0; n < N; n += hostSize) {
+            Timer t(false);
+            proc.process(x.data() + n, y.data() + n, hostSize);
+            us.push_back(t.get() * 1e3);
+        }
+        std::sort(us.begin(), us.end());
+        double mean = 0;
+        for (double u : us) mean += u / double(us.size());
+        std::cout << (amortized ? "Amortized: " : "Immediate: ") << "mean " << mean << " us, p99 "
+                  << us[us.size() * 99 / 100] << " us, max " << us.back() << " us, latency " << proc.getLatency()
+                  << std::endl;
+    }
+
+    BOOST_CHECK(true);
+}
+
+namespace {
+/// Cuts three neighbouring bands, as a narrow notch would.
+class Notch : public CqtSparseProcessor
+{
+  public:
+    using CqtSparseProcessor::CqtSparseProcessor;
+
+    void processBlock(NsgfCqtSparse::Coefs& block) override
+    {
+        for (size_t k = 40; k < 43; k++) block[k] *= 0.1;
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest11)
+{
+    double sampleRate = 48000;
+    Index  N          = 1 << 20;
+    Index  blockSize  = 1 << 12;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 200;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y = ArrayXd::Zero(N);
+
+    for (bool delta : {false, true}) {
+        Notch proc(sampleRate, blockSize, fraction, fMin, fMax, fRef);
+        proc.setDeltaInverse(delta);
+
+        Timer t(false);
+        for (Index n = 0; n < N; n += 256) proc.process(x.data() + n, y.data() + n, 256);
+        std::cout << (delta ? "Delta inverse: " : "Full inverse:  ") << t.get() << " ms, "
+                  << proc.getNumDirtyBands() << " of " << proc.getCqt().getNumBands() << " bands" << std::endl;
+    }
+    BOOST_CHECK(true);
+}
+
+/// Analysis-only counterpart of CqtSparse: reads the block and drops it.
+class SparseMeter : public CqtSparseAnalyzer
+{
+  public:
+    using CqtSparseAnalyzer::CqtSparseAnalyzer;
+    void processBlock(const NsgfCqtSparse::Coefs& /*block*/) override {}
+};
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest12)
+{
+    double sampleRate = 48000;
+    Index  N          = 1 << 20;
+    Index  blockSize  = 1 << 12;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 200;
+    double fMax       = 10000;
+    double fRef       = 1000;
+
+    ArrayXd x = ArrayXd::Random(N);
+    ArrayXd y = ArrayXd::Zero(N);
+
+    CqtSparse   proc(sampleRate, blockSize, fraction, fMin, fMax, fRef);
+    SparseMeter meter(sampleRate, blockSize, fraction, fMin, fMax, fRef);
+
+    Timer tProc(false);
+    for (Index n = 0; n < N; n += 256) proc.process(x.data() + n, y.data() + n, 256);
+    double dProc = tProc.get();
+
+    Timer tMeter(false);
+    for (Index n = 0; n < N; n += 256) meter.process(x.data() + n, 256);
+    double dMeter = tMeter.get();
+
+    meter.setEnergyOnly(true);
+    Timer tEnergy(false);
+    for (Index n = 0; n < N; n += 256) meter.process(x.data() + n, 256);
+    double dEnergy = tEnergy.get();
+
+    std::cout << "Processor: " << dProc << " ms, analyzer: " << dMeter << " ms (" << dProc / dMeter << "x), "
+              << "band energies only: " << dEnergy << " ms (" << dProc / dEnergy << "x)" << std::endl;
+    BOOST_CHECK(true);
+}
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest13)
+{
+    double sampleRate = 48000;
+    Index  nSamps     = 1 << 20;
+    double fraction   = 1.0 / 12.0;
+    double fMin       = 100;
+    double fMax       = 10000;
+    double fRef       = 1000;
+    int    reps       = 5;
+
+    NsgfCqtSparse cqt(sampleRate, nSamps, fraction, fMin, fMax, fRef);
+
+    ArrayXd              x   = ArrayXd::Random(nSamps);
+    NsgfCqtSparse::Coefs Xcq = cqt.getCoefs();
+    ArrayXf              mag(cqt.getNumCoefs());
+
+    Timer tAbs(false);
+    for (int r = 0; r < reps; r++) {
+        cqt.forward(x, Xcq);
+        for (Index k = 0; k < cqt.getNumBands(); k++)
+            mag.segment(cqt.getCoefOffset(k), cqt.getLength(k)) = Xcq[k].abs().cast<float>();
+    }
+    double dAbs = tAbs.get() / reps;
+
+    Timer tMag(false);
+    for (int r = 0; r < reps; r++) cqt.forwardMagnitude(x, mag);
+    double dMag = tMag.get() / reps;
+
+    Timer tDb(false);
+    for (int r = 0; r < reps; r++) cqt.forwardMagnitude(x, mag, MagnitudeScale::Decibels);
+    double dDb = tDb.get() / reps;
+
+    std::cout << "forward + abs: " << dAbs << " ms, forwardMagnitude: " << dMag << " ms (" << dAbs / dMag
+              << "x), in dB: " << dDb << " ms" << std::endl;
+    BOOST_CHECK(true);
+}